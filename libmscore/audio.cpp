@@ -12,6 +12,7 @@
 
 #include "audio.h"
 #include "xml.h"
+#include "msczarchive.h"
 
 namespace Ms {
 
@@ -23,6 +24,28 @@ Audio::Audio()
       {
       }
 
+//---------------------------------------------------------
+//   data
+//    read from the archive on first use
+//---------------------------------------------------------
+
+const QByteArray& Audio::data() const
+      {
+      if (_data.isNull() && _archive)
+            _data = _archive->fileData("audio.ogg");
+      return _data;
+      }
+
+//---------------------------------------------------------
+//   setData
+//---------------------------------------------------------
+
+void Audio::setData(QSharedPointer<MsczArchive> archive)
+      {
+      _data    = QByteArray();
+      _archive = archive;
+      }
+
 //---------------------------------------------------------
 //   read
 //---------------------------------------------------------
@@ -17,6 +17,7 @@ namespace Ms {
 
 class Xml;
 class XmlReader;
+class MsczArchive;
 
 //---------------------------------------------------------
 //   Audio
@@ -24,15 +25,18 @@ class XmlReader;
 
 class Audio {
       QString _path;
-      QByteArray _data;
+      mutable QByteArray _data;
+      QSharedPointer<MsczArchive> _archive;     ///< set while the data is unchanged since read
 
    public:
       Audio();
       const QString& path() const        { return _path; }
       void setPath(const QString& s)     { _path = s;    }
-      const QByteArray& data() const     { return _data; }
-      QByteArray data()                  { return _data; }
-      void setData(const QByteArray& ba) { _data = ba;   }
+      const QByteArray& data() const;
+      void setData(const QByteArray& ba) { _data = ba; _archive.clear(); }
+      void setData(QSharedPointer<MsczArchive>);
+      QSharedPointer<MsczArchive> archive() const { return _archive; }
+      void releaseArchive()              { data(); _archive.clear(); }
 
       void read(XmlReader&);
       void write(Xml&) const;
@@ -70,14 +70,7 @@ void Score::checkScore()
             Segment* ns = s->next1();
 
             if (s->segmentType() & (Segment::SegChordRest)) {
-                  bool empty = true;
-                  foreach(Element* e, s->elist()) {
-                        if (e) {
-                              empty = false;
-                              break;
-                              }
-                        }
-                  if (empty) {
+                  if (s->elist().isEmpty()) {
                         // Measure* m = s->measure();
 qDebug("checkScore: remove empty ChordRest segment");
 //                        m->remove(s);
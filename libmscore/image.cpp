@@ -101,6 +101,7 @@ void Image::setImageType(ImageType t)
 
 QSizeF Image::imageSize() const
       {
+      loadDoc();
       if (imageType == IMAGE_RASTER)
             return rasterDoc->size();
       else
@@ -243,6 +244,7 @@ QVariant Image::propertyDefault(P_ID id) const
 
 void Image::draw(QPainter* painter) const
       {
+      loadDoc();
       bool emptyImage = false;
       if (imageType == IMAGE_SVG) {
             if (!svgDoc)
@@ -501,38 +503,45 @@ void Image::updateGrips(int* grips, int* defaultGrip, QRectF* grip) const
       grip[1].translate(QPointF(r.x() + r.width() * .5, r.y() + r.height()));
       }
 
+//---------------------------------------------------------
+//   loadDoc
+//    decode the image from the store; an image read from
+//    a .mscz file is only decoded when it is drawn or its
+//    size is needed
+//---------------------------------------------------------
+
+void Image::loadDoc() const
+      {
+      if (!_storeItem)
+            return;
+      if (imageType == IMAGE_SVG && !svgDoc)
+            svgDoc = new QSvgRenderer(_storeItem->buffer());
+      else if (imageType == IMAGE_RASTER && !rasterDoc) {
+            rasterDoc = new QImage;
+            rasterDoc->loadFromData(_storeItem->buffer());
+            _dirty = true;
+            }
+      }
+
 //---------------------------------------------------------
 //   layout
 //---------------------------------------------------------
 
 void Image::layout()
       {
-      if (imageType == IMAGE_SVG && !svgDoc) {
-            if (_storeItem) {
-                  svgDoc = new QSvgRenderer(_storeItem->buffer());
-                  if (svgDoc->isValid()) {
-                        if (_size.isNull()) {
-                              _size = svgDoc->defaultSize();
-                              if (_sizeIsSpatium)
-                                    _size /= 10.0;    // by convention
-                              }
-                        }
+      if (_size.isNull()) {
+            loadDoc();
+            if (imageType == IMAGE_SVG && svgDoc && svgDoc->isValid()) {
+                  _size = svgDoc->defaultSize();
+                  if (_sizeIsSpatium)
+                        _size /= 10.0;    // by convention
                   }
-            }
-      else if (imageType == IMAGE_RASTER && !rasterDoc) {
-            if (_storeItem) {
-                  rasterDoc = new QImage;
-                  rasterDoc->loadFromData(_storeItem->buffer());
-                  if (!rasterDoc->isNull()) {
-                        if (_size.isNull()) {
-                              _size = rasterDoc->size() * 0.4;
-                              if (_sizeIsSpatium)
-                                    _size /= spatium();
-                              else
-                                    _size /= MScore::DPMM;
-                              }
-                        _dirty = true;
-                        }
+            else if (imageType == IMAGE_RASTER && rasterDoc && !rasterDoc->isNull()) {
+                  _size = rasterDoc->size() * 0.4;
+                  if (_sizeIsSpatium)
+                        _size /= spatium();
+                  else
+                        _size /= MScore::DPMM;
                   }
             }
 
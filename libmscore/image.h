@@ -26,9 +26,9 @@ enum ImageType { IMAGE_NONE, IMAGE_RASTER, IMAGE_SVG };
 //---------------------------------------------------------
 
 class Image : public BSymbol {
-      union {
-            QImage*       rasterDoc;
-            QSvgRenderer* svgDoc;
+      union {                       // decoded on first use, see loadDoc()
+            mutable QImage*       rasterDoc;
+            mutable QSvgRenderer* svgDoc;
             };
       ImageType imageType;
       Q_OBJECT
@@ -49,6 +49,7 @@ class Image : public BSymbol {
       virtual void editDrag(const EditData&);
       virtual void updateGrips(int*, int*, QRectF*) const override;
       virtual QPointF gripAnchor(int /*grip*/) const { return QPointF(); }
+      void loadDoc() const;
 
    public:
       Image(Score* = 0);
@@ -85,7 +86,7 @@ class Image : public BSymbol {
       qreal scaleFactor() const;
 
       void setImageType(ImageType);
-      bool isValid() const           { return rasterDoc || svgDoc; }
+      bool isValid() const           { loadDoc(); return rasterDoc || svgDoc; }
       };
 
 
@@ -14,6 +14,7 @@
 #include "imageStore.h"
 #include "score.h"
 #include "image.h"
+#include "msczarchive.h"
 
 namespace Ms {
 
@@ -68,7 +69,7 @@ bool ImageStoreItem::isUsed(Score* score) const
 
 void ImageStoreItem::load()
       {
-      if (!_buffer.isEmpty())
+      if (!_buffer.isEmpty() || _archive)
             return;
       QFile inFile(_path);
       if (!inFile.open(QIODevice::ReadOnly)) {
@@ -82,6 +83,32 @@ void ImageStoreItem::load()
       _hash = h.result();
       }
 
+//---------------------------------------------------------
+//   buffer
+//    an image registered from an archive is read on
+//    first use
+//---------------------------------------------------------
+
+QByteArray& ImageStoreItem::buffer()
+      {
+      if (_archive) {
+            _buffer = _archive->fileData(_path);
+            _archive.clear();
+            }
+      return _buffer;
+      }
+
+//---------------------------------------------------------
+//   releaseArchive
+//    read the buffer if it is still in archive
+//---------------------------------------------------------
+
+void ImageStoreItem::releaseArchive(const MsczArchive* archive)
+      {
+      if (_archive.data() == archive)
+            buffer();
+      }
+
 //---------------------------------------------------------
 //   hashName
 //---------------------------------------------------------
@@ -139,14 +166,33 @@ static void dumpHash(const QByteArray& _hash)
       }
 #endif
 
+//---------------------------------------------------------
+//   hashFromName
+//    the base name of a stored image is the hex encoded
+//    md4 hash of its content
+//---------------------------------------------------------
+
+static QByteArray hashFromName(const QString& path)
+      {
+      QString s = QFileInfo(path).baseName();
+      if (s.size() != 32)
+            return QByteArray();
+      QByteArray hash(16, 0);
+      for (int i = 0; i < 16; ++i) {
+            hash[i] = toInt(s[i * 2].toLatin1()) * 16 + toInt(s[i * 2 + 1].toLatin1());
+            }
+      return hash;
+      }
+
 //---------------------------------------------------------
 //   getImage
 //---------------------------------------------------------
 
 ImageStoreItem* ImageStore::getImage(const QString& path) const
       {
-      QString s = QFileInfo(path).baseName();
-      if (s.size() != 32) {
+      QByteArray hash = hashFromName(path);
+      if (hash.isEmpty()) {
+            QString s = QFileInfo(path).baseName();
             //
             // some limited support for backward compatibility
             //
@@ -161,10 +207,6 @@ ImageStoreItem* ImageStore::getImage(const QString& path) const
 
             return 0;
             }
-      QByteArray hash(16, 0);
-      for (int i = 0; i < 16; ++i) {
-            hash[i] = toInt(s[i * 2].toLatin1()) * 16 + toInt(s[i * 2 + 1].toLatin1());
-            }
       foreach(ImageStoreItem* item, *this) {
             if (item->hash() == hash)
                   return item;
@@ -192,5 +234,26 @@ ImageStoreItem* ImageStore::add(const QString& path, const QByteArray& ba)
       return item;
       }
 
+//---------------------------------------------------------
+//   add
+//    register an image of archive without reading it;
+//    path must be a hash name
+//---------------------------------------------------------
+
+ImageStoreItem* ImageStore::add(const QString& path, QSharedPointer<MsczArchive> archive)
+      {
+      QByteArray hash = hashFromName(path);
+      if (hash.isEmpty())
+            return add(path, archive->fileData(path));
+      foreach(ImageStoreItem* item, *this) {
+            if (item->hash() == hash)
+                  return item;
+            }
+      ImageStoreItem* item = new ImageStoreItem(path);
+      item->set(archive, hash);
+      append(item);
+      return item;
+      }
+
 }
 
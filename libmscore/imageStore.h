@@ -17,6 +17,7 @@ namespace Ms {
 
 class Image;
 class Score;
+class MsczArchive;
 
 //---------------------------------------------------------
 //   ImageStoreItem
@@ -28,6 +29,7 @@ class ImageStoreItem {
       QString _type;                // image type (file extension)
       QByteArray _buffer;
       QByteArray _hash;             // 16 byte md4 hash of _buffer
+      QSharedPointer<MsczArchive> _archive;     // _buffer not yet read from this archive
 
    public:
       ImageStoreItem(const QString& p);
@@ -35,14 +37,16 @@ class ImageStoreItem {
       void reference(Image*);
 
       const QString& path() const      { return _path;     }
-      QByteArray& buffer()             { return _buffer;   }
+      QByteArray& buffer();
       bool loaded() const              { return !_buffer.isEmpty();   }
       void setPath(const QString& val);
       bool isUsed(Score*) const;
       void load();
+      void releaseArchive(const MsczArchive*);
       QString hashName() const;
       const QByteArray& hash() const   { return _hash; }
-      void set(const QByteArray& b, const QByteArray& h) { _buffer = b; _hash = h; }
+      void set(const QByteArray& b, const QByteArray& h) { _buffer = b; _hash = h; _archive.clear(); }
+      void set(QSharedPointer<MsczArchive> a, const QByteArray& h) { _archive = a; _hash = h; }
       };
 
 //---------------------------------------------------------
@@ -54,6 +58,7 @@ class ImageStore : public QList<ImageStoreItem*>  {
    public:
       ImageStoreItem* getImage(const QString& path) const;
       ImageStoreItem* add(const QString& path, const QByteArray&);
+      ImageStoreItem* add(const QString& path, QSharedPointer<MsczArchive>);
       };
 
 extern ImageStore imageStore;       // this is the global imageStore
@@ -49,9 +49,13 @@
 #include "ottava.h"
 #include "notedot.h"
 #include "element.h"
+#include "trace.h"
 
 namespace Ms {
 
+// smaller scores are always laid out completely
+static const int PROGRESSIVE_LAYOUT_MEASURES = 200;
+
 //---------------------------------------------------------
 //   rebuildBspTree
 //---------------------------------------------------------
@@ -1124,6 +1128,7 @@ void Score::beamGraceNotes(Chord* mainNote)
 
 void Score::layoutStage2()
       {
+      TRACE("Score::layoutStage2");
       int tracks = nstaves() * VOICES;
       bool crossMeasure = styleB(ST_crossMeasureValues);
 
@@ -1244,6 +1249,7 @@ void Score::layoutStage2()
 
 void Score::layoutStage3()
       {
+      TRACE("Score::layoutStage3");
       Segment::SegmentTypes st = Segment::SegChordRest;
       for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx) {
             if (!staff(staffIdx)->show())
@@ -1263,6 +1269,7 @@ void Score::layoutStage3()
 
 void Score::doLayout()
       {
+      TRACE("Score::doLayout");
       _scoreFont = ScoreFont::fontFactory(_style.value(ST_MusicalSymbolFont).toString());
       _noteHeadWidth = _scoreFont->width(SymId::noteheadBlack, spatium() / (MScore::DPI * SPATIUM20));
 
@@ -1348,60 +1355,34 @@ void Score::doLayout()
       //   place Spanner & beams
       //---------------------------------------------------
 
-      int tracks = nstaves * VOICES;
-      for (int track = 0; track < tracks; ++track) {
-            for (Segment* segment = firstSegmentMM(); segment; segment = segment->next1MM()) {
-                  if (track == tracks-1) {
-                        for (Element* e : segment->annotations())
-                              e->layout();
-                        }
-                  Element* e = segment->element(track);
-                  if (!e)
-                        continue;
-                  if (e->isChordRest()) {
-                        if (!staff(track2staff(track))->show())
-                              continue;
-                        ChordRest* cr = static_cast<ChordRest*>(e);
-                        if (cr->beam() && cr->beam()->elements().front() == cr)
-                              cr->beam()->layout();
+      placeSpannerAndBeams();
 
-                        if (cr->type() == Element::CHORD) {
-                              Chord* c = static_cast<Chord*>(cr);
-                              for (Chord* cc : c->graceNotes()) {
-                                    if (cc->beam() && cc->beam()->elements().front() == cc)
-                                          cc->beam()->layout();
-                                    for (Element* e : cc->el()) {
-                                          if (e->type() == Element::SLUR)
-                                                e->layout();
-                                          }
-                                    }
-                              c->layoutStem();
-                              c->layoutArpeggio2();
-                              for (Note* n : c->notes()) {
-                                    Tie* tie = n->tieFor();
-                                    if (tie)
-                                          tie->layout();
-                                    for (Spanner* sp : n->spannerFor())
-                                          sp->layout();
-                                    }
-                              }
-                        cr->layoutArticulations();
-                        }
-                  else if (e->type() == Element::BAR_LINE)
-                        e->layout();
+      for (Spanner* sp : _spanner.ottavas()) {
+            if (sp->tick2() == -1) {
+                  sp->setTick2(lastMeasure()->endTick());
+                  sp->staff()->updateOttava(static_cast<Ottava*>(sp));
                   }
             }
+      //
+      // in progressive mode only systems and pages are laid out
+      // here; spanners and measure details follow page by page
+      // in layoutPendingPage(). Only the first layout after
+      // loading is progressive, relayout after an edit lays out
+      // all pages.
+      //
+      bool progressive = _progressiveLayout && layoutMode() != LayoutLine
+         && _measures.size() >= PROGRESSIVE_LAYOUT_MEASURES;
+      _progressiveLayout = false;
+      _pendingSpanners.clear();
       for (const std::pair<int,Spanner*>& s : _spanner.map()) {
             Spanner* sp = s.second;
-            if (sp->type() == Element::OTTAVA && sp->tick2() == -1) {
-                  sp->setTick2(lastMeasure()->endTick());
-                  sp->staff()->updateOttava(static_cast<Ottava*>(sp));
-                  }
             // 1.3 scores can have ties in this list
             if (sp->type() != Element::TIE) {
                   if (sp->tick() == -1) {
                         qDebug("bad spanner id %d %s %d - %d", sp->id(), sp->name(), sp->tick(), sp->tick2());
                         }
+                  else if (progressive)
+                        _pendingSpanners.insert(sp);
                   else
                         sp->layout();
                   }
@@ -1410,8 +1391,12 @@ void Score::doLayout()
             layoutSystems2();
             layoutPages();    // create list of pages
             }
-      for (Measure* m = firstMeasureMM(); m; m = m->nextMeasureMM())
-            m->layout2();
+      for (Page* page : _pages)
+            page->setLayoutPending(progressive);
+      if (!progressive) {
+            for (Measure* m = firstMeasureMM(); m; m = m->nextMeasureMM())
+                  m->layout2();
+            }
 
       rebuildBspTree();
 
@@ -1424,6 +1409,79 @@ void Score::doLayout()
       _layoutAll = false;
       }
 
+//---------------------------------------------------------
+//   placeSpannerAndBeams
+//    place beams, stems, ties, slurs, articulations, bar
+//    lines and annotations after the systems are built;
+//    virtual for the layout order test
+//---------------------------------------------------------
+
+void Score::placeSpannerAndBeams()
+      {
+      //
+      // collect chord/rests per track in one pass over all
+      // segments; empty tracks are skipped
+      //
+      int tracks = nstaves() * VOICES;
+      QVector<QList<ChordRest*> > crl(tracks);
+      QList<Segment*> annotated;
+      for (Segment* segment = firstSegmentMM(); segment; segment = segment->next1MM()) {
+            for (int track = segment->nextTrack(0); track != -1; track = segment->nextTrack(track + 1)) {
+                  Element* e = segment->element(track);
+                  if (e->isChordRest()) {
+                        if (staff(track2staff(track))->show())
+                              crl[track].append(static_cast<ChordRest*>(e));
+                        }
+                  else if (e->type() == Element::BAR_LINE)
+                        e->layout();
+                  }
+            if (!segment->annotations().empty())
+                  annotated.append(segment);
+            }
+      for (int track = 0; track < tracks; ++track)
+            layoutChordRests(crl[track]);
+      for (Segment* segment : annotated) {
+            for (Element* e : segment->annotations())
+                  e->layout();
+            }
+      }
+
+//---------------------------------------------------------
+//   layoutChordRests
+//    place beams, stems, ties, slurs and articulations
+//    of the chord/rests of one track
+//---------------------------------------------------------
+
+void Score::layoutChordRests(const QList<ChordRest*>& crl)
+      {
+      for (ChordRest* cr : crl) {
+            if (cr->beam() && cr->beam()->elements().front() == cr)
+                  cr->beam()->layout();
+
+            if (cr->type() == Element::CHORD) {
+                  Chord* c = static_cast<Chord*>(cr);
+                  for (Chord* cc : c->graceNotes()) {
+                        if (cc->beam() && cc->beam()->elements().front() == cc)
+                              cc->beam()->layout();
+                        for (Element* e : cc->el()) {
+                              if (e->type() == Element::SLUR)
+                                    e->layout();
+                              }
+                        }
+                  c->layoutStem();
+                  c->layoutArpeggio2();
+                  for (Note* n : c->notes()) {
+                        Tie* tie = n->tieFor();
+                        if (tie)
+                              tie->layout();
+                        for (Spanner* sp : n->spannerFor())
+                              sp->layout();
+                        }
+                  }
+            cr->layoutArticulations();
+            }
+      }
+
 //---------------------------------------------------------
 //   layoutSpanner
 //    called after dragging a staff
@@ -1431,17 +1489,12 @@ void Score::doLayout()
 
 void Score::layoutSpanner()
       {
-      int tracks = ntracks();
-      for (int track = 0; track < tracks; ++track) {
-            for (Segment* segment = firstSegment(); segment; segment = segment->next1()) {
-                  if (track == tracks-1) {
-                        int n = segment->annotations().size();
-                        for (int i = 0; i < n; ++i)
-                              segment->annotations().at(i)->layout();
-                        }
+      QList<Segment*> annotated;
+      for (Segment* segment = firstSegment(); segment; segment = segment->next1()) {
+            if (!segment->annotations().empty())
+                  annotated.append(segment);
+            for (int track = segment->nextTrack(0); track != -1; track = segment->nextTrack(track + 1)) {
                   Element* e = segment->element(track);
-                  if (!e)
-                        continue;
                   if (e->isChordRest()) {
                         Chord* c = static_cast<Chord*>(e);
                         if (c->type() == Element::CHORD) {
@@ -1463,6 +1516,10 @@ void Score::layoutSpanner()
                         }
                   }
             }
+      for (Segment* segment : annotated) {
+            for (Element* e : segment->annotations())
+                  e->layout();
+            }
       rebuildBspTree();
       }
 
@@ -1669,6 +1726,7 @@ static bool breakMultiMeasureRest(Measure* m)
 
 void Score::createMMRests()
       {
+      TRACE("Score::createMMRests");
       //
       //  create mm rest measures
       //
@@ -1959,6 +2017,7 @@ bool Score::layoutSystem(qreal& minWidth, qreal w, bool isFirstSystem, bool long
       Measure* lastMeasure  = 0;
 
       qreal measureSpacing = styleD(ST_measureSpacing);
+      bool optimalBreaks   = styleB(ST_optimalBreaks) && !styleI(ST_FixMeasureNumbers);
 
       for (; curMeasure;) {
             MeasureBase* nextMeasure;
@@ -1998,6 +2057,9 @@ bool Score::layoutSystem(qreal& minWidth, qreal w, bool isFirstSystem, bool long
                         firstMeasure = m;
                         addSystemHeader(m, isFirstSystem);
                         ww = m->minWidth2();
+                        // (re)plan if the previous system did not end as planned
+                        if (optimalBreaks && (!_lineStarts.contains(m) || _lineStartsMargin != system->leftMargin()))
+                              planLineBreaks(m, ww - m->minWidth1(), system->leftMargin(), systemWidth);
                         }
                   else
                         ww = m->minWidth1();
@@ -2058,6 +2120,8 @@ bool Score::layoutSystem(qreal& minWidth, qreal w, bool isFirstSystem, bool long
                         pbreak = false;
                         break;
                   }
+            if (optimalBreaks && nextMeasure && _lineStarts.contains(nextMeasure))
+                  pbreak = true;
             if ((n && system->measures().size() >= n)
                || continueFlag
                || pbreak
@@ -2519,6 +2583,49 @@ void Score::layoutFingering(Fingering* f)
       f->setUserOff(QPointF(x, y));
       }
 
+//---------------------------------------------------------
+//   planLineBreaks
+//    compute optimal line breaks for the paragraph
+//    starting with measure fm and remember the planned
+//    line starts in _lineStarts. A paragraph ends with a
+//    layout break, a frame or the end of the score.
+//    headerWidth is the estimated width of the system
+//    header (clef, key signature) added to the first
+//    measure of every system.
+//---------------------------------------------------------
+
+void Score::planLineBreaks(Measure* fm, qreal headerWidth, qreal leftMargin, qreal w)
+      {
+      qreal minMeasureWidth = point(styleS(ST_minMeasureWidth));
+      qreal measureSpacing  = styleD(ST_measureSpacing);
+      bool honorBreaks      = _layoutMode == LayoutPage || _layoutMode == LayoutSystem;
+
+      QVector<BreakItem> items;
+      QList<MeasureBase*> ml;
+      bool lastParagraph = false;
+      for (MeasureBase* mb = fm; mb && mb->type() == Element::MEASURE;) {
+            Measure* m    = static_cast<Measure*>(mb);
+            qreal stretch = m->userStretch() * measureSpacing;
+            qreal w1      = qMax(m->minWidth1() * stretch, minMeasureWidth);
+            qreal w2      = qMax((m->minWidth1() + headerWidth) * stretch, minMeasureWidth);
+            items.append(BreakItem(w2, w1));
+            ml.append(m);
+            mb = _showVBox ? m->nextMM() : m->nextMeasureMM();
+            if (mb == 0)
+                  lastParagraph = true;
+            if (honorBreaks && (m->pageBreak() || m->lineBreak()))
+                  break;
+            }
+      qreal lastFillLimit = lastParagraph ? styleD(ST_lastSystemFillLimit) : 0.0;
+      const QList<int>& breaks = _lineBreaker.breaks(fm, items, w - leftMargin, lastFillLimit);
+
+      _lineStarts.clear();
+      _lineStarts.insert(fm);
+      for (int i : breaks)
+            _lineStarts.insert(ml[i + 1]);
+      _lineStartsMargin = leftMargin;
+      }
+
 //---------------------------------------------------------
 //   layoutSystemRow
 //    return height in h
@@ -2800,8 +2907,11 @@ QList<System*> Score::layoutSystemRow(qreal rowWidth, bool isFirstSystem, bool u
 
 void Score::layoutSystems()
       {
+      TRACE("Score::layoutSystems");
+      _lineBreaker.startPass();
       curMeasure              = _showVBox ? firstMM() : firstMeasureMM();
       curSystem               = 0;
+      _lineStarts.clear();
       bool firstSystem        = true;
       bool startWithLongNames = true;
 
@@ -2853,6 +2963,7 @@ void Score::layoutSystems()
 
 void Score::layoutSystems2()
       {
+      TRACE("Score::layoutSystems2");
       int n = _systems.size();
       for (int i = 0; i < n; ++i) {
             System* system = _systems.at(i);
@@ -2868,6 +2979,7 @@ void Score::layoutSystems2()
 
 void Score::layoutLinear()
       {
+      TRACE("Score::layoutLinear");
       curMeasure     = first();
       curSystem      = 0;
       System* system = getNextSystem(true, false);
@@ -3044,6 +3156,90 @@ struct PageContext {
       qreal tm() const { return sr.tm(); }
       };
 
+//---------------------------------------------------------
+//   planPageBreaks
+//    compute optimal page breaks for all systems starting
+//    with _systems[systemIdx]; returns the system rows
+//    which should start a new page
+//---------------------------------------------------------
+
+QSet<const System*> Score::planPageBreaks(int systemIdx)
+      {
+      const qreal _spatium            = spatium();
+      const qreal slb                 = styleS(ST_staffLowerBorder).val()    * _spatium;
+      const qreal sub                 = styleS(ST_staffUpperBorder).val()    * _spatium;
+      const qreal systemDist          = styleS(ST_minSystemDistance).val()   * _spatium;
+      const qreal systemFrameDistance = styleS(ST_systemFrameDistance).val() * _spatium;
+      const qreal frameSystemDistance = styleS(ST_frameSystemDistance).val() * _spatium;
+
+      // use the smaller of odd and even pages
+      const PageFormat* pf = pageFormat();
+      qreal margins = pf->oddTopMargin() + pf->oddBottomMargin();
+      if (pf->twosided())
+            margins = qMax(margins, pf->evenTopMargin() + pf->evenBottomMargin());
+      const qreal capacity = loHeight() - margins * MScore::DPI;
+
+      QSet<const System*> pageStarts;
+      QVector<BreakItem> items;
+      QList<System*> rows;
+      System* lastSystem = 0;
+      qreal prevDist     = 0.0;
+      int nSystems       = _systems.size();
+
+      for (int i = systemIdx; i < nSystems; ++i) {
+            SystemRow sr;
+            for (;;) {
+                  sr.systems.append(_systems[i]);
+                  if (i + 1 == nSystems || !_systems[i+1]->sameLine())
+                        break;
+                  ++i;
+                  }
+            qreal first;      // top margin if first row on page
+            qreal next;       // top margin if row follows another row
+            qreal bmargin;
+            if (sr.isVbox()) {
+                  VBox* vbox = sr.vbox();
+                  first      = vbox->topGap();
+                  next       = first;
+                  if (lastSystem) {
+                        if (lastSystem->isVbox())
+                              next += lastSystem->vbox()->bottomGap();
+                        else
+                              next += systemFrameDistance;
+                        }
+                  bmargin = vbox->bottomGap();
+                  }
+            else {
+                  first = qMax(sr.tm(), sub);
+                  if (!lastSystem)
+                        next = first;
+                  else if (lastSystem->isVbox())
+                        next = lastSystem->vbox()->bottomGap() + frameSystemDistance;
+                  else
+                        next = qMax(sr.tm(), systemDist);
+                  bmargin = sr.bm();
+                  }
+            next     = qMax(next, prevDist);
+            prevDist = bmargin;
+
+            qreal h = sr.height();
+            items.append(BreakItem(first + h, next + h, qMax(bmargin, slb)));
+            rows.append(sr.systems.front());
+            lastSystem = sr.systems.back();
+
+            if ((sr.pageBreak() && _layoutMode == LayoutPage) || i + 1 == nSystems) {
+                  const QList<int>& breaks = _pageBreaker.breaks(rows.front(), items, capacity, 1.0);
+                  for (int k : breaks)
+                        pageStarts.insert(rows[k + 1]);
+                  items.clear();
+                  rows.clear();
+                  lastSystem = 0;
+                  prevDist   = 0.0;
+                  }
+            }
+      return pageStarts;
+      }
+
 //---------------------------------------------------------
 //   layoutPages
 //    create list of pages
@@ -3051,6 +3247,8 @@ struct PageContext {
 
 void Score::layoutPages()
       {
+      TRACE("Score::layoutPages");
+      _pageBreaker.startPass();
       const qreal _spatium            = spatium();
       const qreal slb                 = styleS(ST_staffLowerBorder).val()    * _spatium;
       const qreal sub                 = styleS(ST_staffUpperBorder).val()    * _spatium;
@@ -3065,10 +3263,16 @@ void Score::layoutPages()
 
       int nSystems = _systems.size();
 
+      bool optimalBreaks = styleB(ST_optimalBreaks);
+      QSet<const System*> pageStarts;
+      if (optimalBreaks)
+            pageStarts = planPageBreaks(0);
+
       for (int i = 0; i < nSystems; ++i) {
             //
             // collect system row
             //
+            int rowIdx = i;
             pC.sr.clear();
             for (;;) {
                   System* system = _systems[i];
@@ -3108,8 +3312,13 @@ void Score::layoutPages()
             tmargin     = qMax(tmargin, pC.prevDist);
             pC.prevDist = bmargin;
 
-            qreal h = pC.sr.height();
-            if (pC.lastSystem && (pC.y + h + tmargin + qMax(bmargin, slb) > pC.ey)) {
+            qreal h       = pC.sr.height();
+            bool overflow = pC.y + h + tmargin + qMax(bmargin, slb) > pC.ey;
+            bool planned  = pageStarts.contains(pC.sr.systems.front());
+            if (pC.lastSystem && (overflow || planned)) {
+                  // plan did not fit, plan again from here
+                  if (optimalBreaks && !planned)
+                        pageStarts = planPageBreaks(rowIdx);
                   //
                   // prepare next page
                   //
@@ -3260,6 +3469,7 @@ void Score::layoutPage(const PageContext& pC, qreal d)
 
 void Score::doLayoutSystems()
       {
+      finishLayout();
       foreach(System* system, _systems)
             system->layout2();
       layoutPages();
@@ -3277,6 +3487,7 @@ void Score::doLayoutSystems()
 
 void Score::doLayoutPages()
       {
+      finishLayout();
       layoutPages();
       rebuildBspTree();
       _updateAll = true;
@@ -3284,6 +3495,79 @@ void Score::doLayoutPages()
             v->layoutChanged();
       }
 
+//---------------------------------------------------------
+//   layoutPendingPage
+//    finish a page left pending by progressive layout:
+//    lay out the spanners touching the page and the
+//    measure details (lyrics, measure numbers, spacers)
+//---------------------------------------------------------
+
+void Score::layoutPendingPage(Page* page)
+      {
+      TRACE("Score::layoutPendingPage");
+      if (!page->layoutPending())
+            return;
+      page->setLayoutPending(false);
+
+      QList<Measure*> ml;
+      foreach (System* system, *page->systems()) {
+            foreach (MeasureBase* mb, system->measures()) {
+                  if (mb->type() == Element::MEASURE)
+                        ml.append(static_cast<Measure*>(mb));
+                  }
+            }
+      if (!ml.isEmpty() && !_pendingSpanners.isEmpty()) {
+            // copy the query result, spanner layout may run
+            // range queries itself
+            QList<Spanner*> sl;
+            int tick1 = ml.front()->tick();
+            int tick2 = ml.back()->endTick();
+            for (const ::Interval<Spanner*>& i : _spanner.findOverlapping(tick1, tick2 - 1)) {
+                  if (_pendingSpanners.remove(i.value))
+                        sl.append(i.value);
+                  }
+            qStableSort(sl.begin(), sl.end(), [](Spanner* a, Spanner* b) { return a->tick() < b->tick(); });
+            for (Spanner* sp : sl)
+                  sp->layout();
+            }
+      for (Measure* m : ml)
+            m->layout2();
+      page->rebuildBspTree();
+      }
+
+//---------------------------------------------------------
+//   nextPendingPage
+//    return first page left pending by progressive layout
+//---------------------------------------------------------
+
+Page* Score::nextPendingPage() const
+      {
+      for (Page* page : _pages) {
+            if (page->layoutPending())
+                  return page;
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   finishLayout
+//    complete a progressive layout; needed before
+//    printing and exporting
+//---------------------------------------------------------
+
+void Score::finishLayout()
+      {
+      TRACE("Score::finishLayout");
+      _progressiveLayout = false;
+      for (Page* page : _pages)
+            layoutPendingPage(page);
+      // spanners outside of all pages
+      QList<Spanner*> sl = _pendingSpanners.toList();
+      _pendingSpanners.clear();
+      for (Spanner* sp : sl)
+            sp->layout();
+      }
+
 //---------------------------------------------------------
 //   sff
 //    compute 1/Force for a given Extend
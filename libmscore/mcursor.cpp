@@ -24,6 +24,7 @@
 #include "libmscore/instrtemplate.h"
 #include "libmscore/keysig.h"
 #include "libmscore/timesig.h"
+#include "libmscore/tuplet.h"
 
 namespace Ms {
 
@@ -64,9 +65,11 @@ void MCursor::createMeasures()
 
 //---------------------------------------------------------
 //   addChord
+//    the chord is added to tuplet if not null; the cursor
+//    advances by the actual duration
 //---------------------------------------------------------
 
-Chord* MCursor::addChord(int pitch, const TDuration& duration)
+Chord* MCursor::addChord(int pitch, const TDuration& duration, Tuplet* tuplet)
       {
       createMeasures();
       Measure* measure = _score->tick2measure(_tick);
@@ -77,13 +80,20 @@ Chord* MCursor::addChord(int pitch, const TDuration& duration)
             chord->setTrack(_track);
             chord->setDurationType(duration);
             chord->setDuration(duration.fraction());
+            if (tuplet) {
+                  chord->setTuplet(tuplet);
+                  tuplet->add(chord);
+                  }
             segment->add(chord);
             }
       Note* note = new Note(_score);
       chord->add(note);
       note->setPitch(pitch);
       note->setTpcFromPitch();
-      _tick += duration.ticks();
+      if (tuplet)
+            _tick += (duration.fraction() / tuplet->ratio()).ticks();
+      else
+            _tick += duration.ticks();
       return chord;
       }
 
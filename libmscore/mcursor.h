@@ -23,6 +23,7 @@ class TDuration;
 class Fraction;
 class TimeSig;
 class Chord;
+class Tuplet;
 
 
 //---------------------------------------------------------
@@ -43,7 +44,7 @@ class MCursor {
       void saveScore();
 
       void addPart(const QString& instrument);
-      Chord* addChord(int pitch, const TDuration& duration);
+      Chord* addChord(int pitch, const TDuration& duration, Tuplet* tuplet = 0);
       void addKeySig(int);
       TimeSig* addTimeSig(const Fraction&);
 
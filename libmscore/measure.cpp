@@ -642,11 +642,9 @@ void Measure::layout2()
       // slur layout needs articulation layout first
       //
       for (Segment* s = first(st); s; s = s->next(st)) {
-            for (int track = 0; track < tracks; ++track) {
-                  if (!score()->staff(track / VOICES)->show()) {
-                        track += VOICES-1;
+            for (int track = s->nextTrack(0); track != -1; track = s->nextTrack(track + 1)) {
+                  if (!score()->staff(track / VOICES)->show())
                         continue;
-                        }
                   Element* el = s->element(track);
                   if (el) {
                         ChordRest* cr = static_cast<ChordRest*>(el);
@@ -2376,7 +2374,6 @@ void Measure::scanElements(void* data, void (*func)(void*, Element*), bool all)
                   func(data, ms->noText());
             }
 
-      int tracks = nstaves * VOICES;
       for (Segment* s = first(); s; s = s->next()) {
             // bar line visibility depends on spanned staves,
             // not simply on visibility of first staff
@@ -2399,16 +2396,11 @@ void Measure::scanElements(void* data, void (*func)(void*, Element*), bool all)
                         }
                   }
             else
-                  for (int track = 0; track < tracks; ++track) {
+                  for (int track = s->nextTrack(0); track != -1; track = s->nextTrack(track + 1)) {
                         int staffIdx = track/VOICES;
-                        if (!all && !(visible(staffIdx) && score()->staff(staffIdx)->show())) {
-                              track += VOICES - 1;
-                              continue;
-                              }
-                        Element* e = s->element(track);
-                        if (e == 0)
+                        if (!all && !(visible(staffIdx) && score()->staff(staffIdx)->show()))
                               continue;
-                        e->scanElements(data, func, all);
+                        s->element(track)->scanElements(data, func, all);
                         }
             foreach(Element* e, s->annotations()) {
                   if (all || e->systemFlag() || visible(e->staffIdx()))
@@ -3064,7 +3056,6 @@ void Measure::layoutX(qreal stretch)
             return;
 
       qreal _spatium           = spatium();
-      int tracks               = nstaves * VOICES;
       qreal clefKeyRightMargin = score()->styleS(ST_clefKeyRightMargin).val() * _spatium;
       qreal minHarmonyDistance = score()->styleS(ST_minHarmonyDistance).val() * _spatium;
       qreal maxHarmonyBarDistance = score()->styleS(ST_maxHarmonyBarDistance).val() * _spatium;
@@ -3500,14 +3491,10 @@ void Measure::layoutX(qreal stretch)
             }
 
       for (Segment* s = first(); s; s = s->next(), ++seg) {
-            for (int track = 0; track < tracks; ++track) {
-                  if (!score()->staff(track/VOICES)->show()) {
-                        track += VOICES-1;
+            for (int track = s->nextTrack(0); track != -1; track = s->nextTrack(track + 1)) {
+                  if (!score()->staff(track/VOICES)->show())
                         continue;
-                        }
                   Element* e = s->element(track);
-                  if (e == 0)
-                        continue;
                   ElementType t = e->type();
                   Rest* rest = static_cast<Rest*>(e);
                   if (((track % VOICES) == 0) &&
@@ -3800,7 +3787,7 @@ Measure* Measure::cloneMeasure(Score* sc, TieMap* tieMap)
             s->setSegmentType(oseg->segmentType());
             s->setRtick(oseg->rtick());
             m->_segments.push_back(s);
-            for (int track = 0; track < tracks; ++track) {
+            for (int track = oseg->nextTrack(0); track != -1 && track < tracks; track = oseg->nextTrack(track + 1)) {
                   Element* oe = oseg->element(track);
                   if (oe) {
                         Element* ne = oe->clone();
@@ -83,6 +83,9 @@ int     MScore::mtcType;
 
 bool    MScore::noExcerpts = false;
 bool    MScore::noImages = false;
+int     MScore::saveCompressionLevel     = 9;     // smallest file
+int     MScore::autoSaveCompressionLevel = 1;     // fastest
+size_t  MScore::undoMemoryBudget = 64 * 1024 * 1024;
 
 #ifdef SCRIPT_INTERFACE
 QQmlEngine* MScore::_qml = 0;
@@ -391,6 +391,9 @@ class MScore : public QObject {
 
       static bool noExcerpts;
       static bool noImages;
+      static int saveCompressionLevel;    ///< zlib level of saved .mscz files
+      static int autoSaveCompressionLevel;
+      static size_t undoMemoryBudget;     ///< approximate bytes of undo history per score, 0: unlimited
 
 #ifdef SCRIPT_INTERFACE
       static QQmlEngine* qml();
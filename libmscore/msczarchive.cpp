@@ -0,0 +1,177 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "msczarchive.h"
+#include "thirdparty/qzip/qzipwriter_p.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   MsczArchive
+//    only the central directory is read here
+//---------------------------------------------------------
+
+MsczArchive::MsczArchive(const QString& path)
+      {
+      QFileInfo info(path);
+      _path         = info.absoluteFilePath();
+      _size         = info.size();
+      _lastModified = info.lastModified();
+      _reader       = new MQZipReader(path);
+      foreach(const MQZipReader::FileInfo& fi, _reader->fileInfoList())
+            _paths.insert(fi.filePath);
+      }
+
+MsczArchive::~MsczArchive()
+      {
+      delete _reader;
+      }
+
+//---------------------------------------------------------
+//   unchanged
+//    true if the file was not replaced or modified since
+//    it was opened
+//---------------------------------------------------------
+
+bool MsczArchive::unchanged() const
+      {
+      QFileInfo fi(_path);
+      return fi.exists() && fi.size() == _size && fi.lastModified() == _lastModified;
+      }
+
+//---------------------------------------------------------
+//   rawFileData
+//    returns a null entry if the file has changed
+//---------------------------------------------------------
+
+MQZipRawEntry MsczArchive::rawFileData(const QString& path)
+      {
+      auto i = _entries.constFind(path);
+      if (i != _entries.constEnd())
+            return *i;
+      if (!_reader || !_paths.contains(path))
+            return MQZipRawEntry();
+      if (!unchanged()) {
+            qDebug("MsczArchive: <%s> changed on disk, cannot read <%s>", qPrintable(_path), qPrintable(path));
+            delete _reader;
+            _reader = 0;
+            return MQZipRawEntry();
+            }
+      MQZipRawEntry entry = _reader->rawFileData(path);
+      _entries.insert(path, entry);
+      return entry;
+      }
+
+//---------------------------------------------------------
+//   fileData
+//    return the uncompressed data of path
+//---------------------------------------------------------
+
+QByteArray MsczArchive::fileData(const QString& path)
+      {
+      return MQZipReader::uncompress(rawFileData(path));
+      }
+
+//---------------------------------------------------------
+//   detach
+//    read all remaining entries and close the file
+//---------------------------------------------------------
+
+void MsczArchive::detach()
+      {
+      if (!_reader)
+            return;
+      if (unchanged()) {
+            foreach(const QString& path, _paths) {
+                  if (!_entries.contains(path) && !path.endsWith(".mscx"))
+                        _entries.insert(path, _reader->rawFileData(path));
+                  }
+            }
+      else
+            qDebug("MsczArchive: <%s> changed on disk", qPrintable(_path));
+      delete _reader;
+      _reader = 0;
+      }
+
+//---------------------------------------------------------
+//   add
+//---------------------------------------------------------
+
+void MsczSnapshot::add(const QString& path, const QByteArray& data)
+      {
+      Entry e;
+      e.path = path;
+      e.data = data;
+      entries.append(e);
+      }
+
+void MsczSnapshot::add(const QString& path, const QImage& image)
+      {
+      Entry e;
+      e.path  = path;
+      e.image = image;
+      entries.append(e);
+      }
+
+void MsczSnapshot::add(const QString& path, const MQZipRawEntry& raw)
+      {
+      Entry e;
+      e.path = path;
+      e.raw  = raw;
+      entries.append(e);
+      }
+
+//---------------------------------------------------------
+//   CompressEntry
+//    runs in a worker thread; returns a null entry if an
+//    image cannot be encoded
+//---------------------------------------------------------
+
+struct CompressEntry {
+      typedef MQZipRawEntry result_type;
+      int level;
+
+      CompressEntry(int l) : level(l) {}
+      MQZipRawEntry operator()(const MsczSnapshot::Entry& e) const {
+            if (!e.raw.isNull())
+                  return e.raw;
+            if (e.image.isNull())
+                  return MQZipWriter::compress(e.data, level, MQZipWriter::AlwaysCompress);
+            QBuffer cbuf;
+            if (!e.image.save(&cbuf, "PNG"))
+                  return MQZipRawEntry();
+            return MQZipWriter::compress(cbuf.data(), level, MQZipWriter::AlwaysCompress);
+            }
+      };
+
+//---------------------------------------------------------
+//   write
+//    compress the snapshot into f; the entries are
+//    compressed in parallel and written in order
+//    level is a zlib compression level
+//---------------------------------------------------------
+
+void MsczSnapshot::write(QIODevice* f, int level) const
+      {
+      QList<MQZipRawEntry> raw = QtConcurrent::blockingMapped(entries, CompressEntry(level));
+      MQZipWriter uz(f);
+      for (int i = 0; i < entries.size(); ++i) {
+            const Entry& e = entries[i];
+            if (raw[i].isNull() && !e.image.isNull())
+                  throw(QString("save file: cannot save image (%1x%2)").arg(e.image.width()).arg(e.image.height()));
+            uz.addRawFile(e.path, raw[i]);
+            }
+      uz.close();
+      }
+
+}     // namespace Ms
+
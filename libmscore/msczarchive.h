@@ -0,0 +1,81 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __MSCZARCHIVE_H__
+#define __MSCZARCHIVE_H__
+
+#include "thirdparty/qzip/qzipreader_p.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   MsczArchive
+//    a .mscz file kept open after loading the score
+//
+//    Attachments (pictures, OMR page images, audio) are
+//    read on first use only. An entry once read is kept in
+//    its compressed form, so it can be copied into a saved
+//    file without recompression.
+//
+//    Entries are only read while size and modification
+//    time of the file are the same as when it was opened.
+//    The score releases the archive when it is closed or
+//    its file is overwritten, see Score::releaseArchive().
+//---------------------------------------------------------
+
+class MsczArchive {
+      QString _path;
+      qint64 _size;
+      QDateTime _lastModified;
+      MQZipReader* _reader;                     ///< null after detach()
+      QSet<QString> _paths;                     ///< files in the central directory
+      QHash<QString, MQZipRawEntry> _entries;   ///< entries read so far
+
+      bool unchanged() const;
+
+   public:
+      MsczArchive(const QString& path);
+      ~MsczArchive();
+
+      const QString& path() const              { return _path;   }
+      MQZipReader* reader() const              { return _reader; }
+      bool contains(const QString& path) const { return _paths.contains(path); }
+      MQZipRawEntry rawFileData(const QString& path);
+      QByteArray fileData(const QString& path);
+      void detach();
+      };
+
+//---------------------------------------------------------
+//   MsczSnapshot
+//    uncompressed contents of a .mscz file. Taken from the
+//    score on the GUI thread; write() does not touch the
+//    score and can run in a worker thread.
+//---------------------------------------------------------
+
+struct MsczSnapshot {
+      struct Entry {
+            QString path;
+            QByteArray data;
+            QImage image;           ///< encoded as png by write() if not null
+            MQZipRawEntry raw;      ///< copied as is by write() if not null
+            };
+      QList<Entry> entries;
+
+      void add(const QString& path, const QByteArray& data);
+      void add(const QString& path, const QImage& image);
+      void add(const QString& path, const MQZipRawEntry& raw);
+      void write(QIODevice*, int level = -1) const;
+      };
+
+}     // namespace Ms
+#endif
+
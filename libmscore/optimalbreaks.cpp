@@ -0,0 +1,122 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "optimalbreaks.h"
+
+namespace Ms {
+
+static const qreal LINE_PENALTY     = 0.01;     // prefer fewer lines if badness is equal
+static const qreal OVERFULL_PENALTY = 1.0e6;    // single item wider than capacity
+
+//---------------------------------------------------------
+//   computeBreaks
+//    returns the indices of all items which end a
+//    line/page; the last item of the paragraph is not
+//    included.
+//    The last line has no cost if it is filled less than
+//    lastFillLimit (ragged last line).
+//---------------------------------------------------------
+
+QList<int> OptimalBreaker::computeBreaks(const QVector<BreakItem>& items, qreal capacity, qreal lastFillLimit)
+      {
+      QList<int> breaks;
+      int n = items.size();
+      if (n < 2 || capacity <= 0.0)
+            return breaks;
+
+      QVector<qreal> cost(n + 1, 0.0);    // cost[i]: best cost for items 0..i-1
+      QVector<int> prev(n + 1, -1);       // start of the last line in best solution
+
+      for (int i = 0; i < n; ++i) {
+            if (i > 0 && prev[i] == -1)
+                  continue;                     // not reachable
+            qreal extent = items[i].first;
+            for (int j = i; j < n; ++j) {
+                  if (j > i)
+                        extent += items[j].extent;
+                  if (extent > capacity && j > i)
+                        break;                  // all longer lines are overfull too
+                  qreal total = extent + items[j].trailing;
+                  qreal badness;
+                  if (total > capacity) {
+                        if (j > i)
+                              continue;
+                        badness = OVERFULL_PENALTY;
+                        }
+                  else {
+                        qreal fill = total / capacity;
+                        if (j == n - 1 && fill <= lastFillLimit)
+                              badness = 0.0;
+                        else {
+                              qreal slack = 1.0 - fill;
+                              badness = slack * slack;
+                              }
+                        }
+                  qreal c = cost[i] + badness + LINE_PENALTY;
+                  if (prev[j + 1] == -1 || c < cost[j + 1]) {
+                        cost[j + 1] = c;
+                        prev[j + 1] = i;
+                        }
+                  }
+            }
+      for (int i = prev[n]; i > 0; i = prev[i])
+            breaks.prepend(i - 1);
+      return breaks;
+      }
+
+//---------------------------------------------------------
+//   breaks
+//    cached version of computeBreaks(); an unchanged
+//    paragraph identified by key is not broken again
+//    after an edit elsewhere in the score
+//---------------------------------------------------------
+
+const QList<int>& OptimalBreaker::breaks(const void* key, const QVector<BreakItem>& items, qreal capacity, qreal lastFillLimit)
+      {
+      QHash<const void*, Entry>::iterator i = _cache.find(key);
+      if (i == _cache.end()) {
+            Entry e;
+            e.capacity      = -1.0;
+            e.lastFillLimit = -1.0;
+            i = _cache.insert(key, e);
+            }
+      Entry& e = i.value();
+      if (e.capacity != capacity || e.lastFillLimit != lastFillLimit || e.items != items) {
+            e.items         = items;
+            e.capacity      = capacity;
+            e.lastFillLimit = lastFillLimit;
+            e.breaks        = computeBreaks(items, capacity, lastFillLimit);
+            }
+      e.pass = _pass;
+      return e.breaks;
+      }
+
+//---------------------------------------------------------
+//   startPass
+//    drop the plans of paragraphs which were not laid
+//    out in the previous pass (deleted or changed first
+//    measure/system) and start a new pass
+//---------------------------------------------------------
+
+void OptimalBreaker::startPass()
+      {
+      for (QHash<const void*, Entry>::iterator i = _cache.begin(); i != _cache.end();) {
+            if (i.value().pass != _pass)
+                  i = _cache.erase(i);
+            else
+                  ++i;
+            }
+      ++_pass;
+      }
+
+}     // namespace Ms
+
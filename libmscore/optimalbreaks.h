@@ -0,0 +1,75 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __OPTIMALBREAKS_H__
+#define __OPTIMALBREAKS_H__
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   BreakItem
+//    one measure (line breaking) or one system row
+//    (page breaking) as seen by the OptimalBreaker
+//---------------------------------------------------------
+
+struct BreakItem {
+      qreal first;      ///< extent if the item starts a line/page
+      qreal extent;     ///< extent if the item follows another item
+      qreal trailing;   ///< extra space needed if the item ends a line/page
+
+      BreakItem(qreal f = 0.0, qreal e = 0.0, qreal t = 0.0) : first(f), extent(e), trailing(t) {}
+      bool operator==(const BreakItem& i) const {
+            return first == i.first && extent == i.extent && trailing == i.trailing;
+            }
+      };
+
+//---------------------------------------------------------
+//   OptimalBreaker
+//    Knuth-Plass style global breaking of a paragraph
+//    of items into lines (or pages) of a fixed capacity.
+//    Minimizes the sum of squared relative slack over all
+//    lines. Candidate lines are pruned as soon as their
+//    extent exceeds the capacity, which keeps the search
+//    at O(items * items per line).
+//
+//    Plans are cached per paragraph. The key (first
+//    measure or system) only selects the entry; a plan
+//    is reused only if all its inputs are equal, so a
+//    key reused after its object was deleted is harmless.
+//    Entries not used during the previous layout pass
+//    are dropped by startPass().
+//---------------------------------------------------------
+
+class OptimalBreaker {
+      struct Entry {
+            QVector<BreakItem> items;
+            qreal capacity;
+            qreal lastFillLimit;
+            QList<int> breaks;
+            int pass;
+            };
+      QHash<const void*, Entry> _cache;
+      int _pass;
+
+   public:
+      OptimalBreaker() : _pass(0) {}
+      static QList<int> computeBreaks(const QVector<BreakItem>& items, qreal capacity, qreal lastFillLimit);
+
+      const QList<int>& breaks(const void* key, const QVector<BreakItem>& items, qreal capacity, qreal lastFillLimit);
+      void startPass();
+      int size() const              { return _cache.size(); }
+      void clear()                  { _cache.clear(); }
+      };
+
+}     // namespace Ms
+#endif
+
@@ -130,7 +130,8 @@ Page::Page(Score* s)
    : Element(s),
    _no(0)
       {
-      bspTreeValid = false;
+      bspTreeValid   = false;
+      _layoutPending = false;
       }
 
 Page::~Page()
@@ -129,6 +129,7 @@ class Page : public Element {
       void doRebuildBspTree();
 #endif
       bool bspTreeValid;
+      bool _layoutPending;          // systems placed, details not laid out yet
 
       QString replaceTextMacros(const QString&) const;
       void drawStyledHeaderFooter(QPainter*, int area, const QPointF&, const QString&) const;
@@ -161,6 +162,8 @@ class Page : public Element {
       QList<Element*> items(const QRectF& r);
       QList<Element*> items(const QPointF& p);
       void rebuildBspTree()   { bspTreeValid = false; }
+      bool layoutPending() const          { return _layoutPending; }
+      void setLayoutPending(bool val)     { _layoutPending = val;  }
       QPointF pagePos() const { return QPointF(); }     ///< position in page coordinates
       QList<System*> searchSystem(const QPointF& pos) const;
       Measure* searchMeasure(const QPointF& p) const;
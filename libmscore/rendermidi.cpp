@@ -46,6 +46,7 @@
 #include "segment.h"
 #include "undo.h"
 #include "utils.h"
+#include "trace.h"
 
 namespace Ms {
 
@@ -333,6 +334,7 @@ static void collectMeasureEvents(EventMap* events, Measure* m, Staff* staff, int
 
 void Score::updateRepeatList(bool expandRepeats)
       {
+      TRACE("Score::updateRepeatList");
       if (!expandRepeats) {
             foreach(RepeatSegment* s, *repeatList())
                   delete s;
@@ -441,6 +443,7 @@ void Score::removeHairpin(Hairpin* h)
 
 void Score::updateVelo()
       {
+      TRACE("Score::updateVelo");
       //
       //    collect Dynamics
       //
@@ -498,6 +501,7 @@ void Score::updateVelo()
 
 void Score::renderStaff(EventMap* events, Staff* staff)
       {
+      TRACE("Score::renderStaff");
       Measure* lastMeasure = 0;
       foreach (const RepeatSegment* rs, *repeatList()) {
             int startTick  = rs->tick;
@@ -695,10 +699,11 @@ void Score::createPlayEvents(Chord* chord)
 
       int tick = chord->tick();
       Slur* slur = 0;
-      for (auto sp : _spanner.map()) {
-            if (sp.second->type() != Element::SLUR || sp.second->staffIdx() != chord->staffIdx())
+      for (const ::Interval<Spanner*>& i : _spanner.findOverlapping(tick, tick)) {
+            Spanner* sp = i.value;
+            if (sp->type() != Element::SLUR || sp->staffIdx() != chord->staffIdx())
                   continue;
-            Slur* s = static_cast<Slur*>(sp.second);
+            Slur* s = static_cast<Slur*>(sp);
             if (tick >= s->tick() && tick < s->tick2()) {
                   slur = s;
                   break;
@@ -763,6 +768,7 @@ void Score::createPlayEvents(Chord* chord)
 
 void Score::createPlayEvents()
       {
+      TRACE("Score::createPlayEvents");
       int etrack = nstaves() * VOICES;
       for (int track = 0; track < etrack; ++track) {
             for (Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
@@ -787,6 +793,7 @@ void Score::createPlayEvents()
 
 void Score::renderMidi(EventMap* events)
       {
+      TRACE("Score::renderMidi");
       createPlayEvents();
 
       updateRepeatList(MScore::playRepeats);
@@ -825,11 +832,16 @@ void Score::renderMidi(EventMap* events)
             int utick1 = rs->utick;
             int utick2 = utick1 + rs->len;
 
-            for (std::pair<int,Spanner*> sp : _spanner.map()) {
-                  Spanner* s = sp.second;
-                  if (s->type() != Element::PEDAL)
-                        continue;
+            QList<Spanner*> pedals;
+            for (const ::Interval<Spanner*>& i : _spanner.findOverlapping(utick1, utick2 - 1)) {
+                  if (i.value->type() == Element::PEDAL)
+                        pedals.append(i.value);
+                  }
+            // keep start tick order: a pedal release must come
+            // before a pedal starting at the same tick
+            qStableSort(pedals.begin(), pedals.end(), [](Spanner* a, Spanner* b) { return a->tick() < b->tick(); });
 
+            for (Spanner* s : pedals) {
                   int idx = s->staff()->channel(s->tick(), 0);
                   int channel = s->staff()->part()->instr(s->tick())->channel(idx).channel;
                   if (s->tick() >= utick1 && s->tick() < utick2) {
@@ -64,6 +64,7 @@
 #endif
 #include "bracket.h"
 #include "audio.h"
+#include "imageStore.h"
 #include "instrtemplate.h"
 #include "cursor.h"
 #include "sym.h"
@@ -329,6 +330,8 @@ void Score::init()
       _tempomap               = 0;
       _layoutMode             = LayoutPage;
       _noteHeadWidth          = 0.0;      // set in doLayout()
+      _lineStartsMargin       = 0.0;
+      _progressiveLayout      = false;
       }
 
 //---------------------------------------------------------
@@ -407,6 +410,11 @@ Score::~Score()
       {
       foreach(MuseScoreView* v, viewer)
             v->removeScore();
+      // pictures outlive the score in the global image store
+      if (_archive) {
+            foreach(ImageStoreItem* ip, imageStore)
+                  ip->releaseArchive(_archive.data());
+            }
       // deselectAll();
       for (MeasureBase* m = _measures.first(); m;) {
             MeasureBase* nm = m->next();
@@ -526,10 +534,7 @@ void Score::fixTicks()
                                           }
                                     }
                               qreal stretch = 0.0;
-                              for (int i = 0; i < s->elist().size(); ++i) {
-                                    Element* e = s->elist().at(i);
-                                    if (!e)
-                                          continue;
+                              for (Element* e : s->elist()) {
                                     ChordRest* cr = static_cast<ChordRest*>(e);
                                     int nn = cr->articulations().size();
                                     for (int ii = 0; ii < nn; ++ii)
@@ -3373,6 +3378,7 @@ void Score::addSpanner(Spanner* s)
 void Score::removeSpanner(Spanner* s)
       {
       _spanner.removeSpanner(s);
+      _pendingSpanners.remove(s);
       }
 
 //---------------------------------------------------------
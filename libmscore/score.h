@@ -31,6 +31,7 @@
 #include "accidental.h"
 #include "note.h"
 #include "spannermap.h"
+#include "optimalbreaks.h"
 #include "pitchspelling.h"
 
 class QPainter;
@@ -82,6 +83,8 @@ class Lyrics;
 class Text;
 class Omr;
 class Audio;
+class MsczArchive;
+struct MsczSnapshot;
 class Parameter;
 class Revisions;
 class Spanner;
@@ -282,6 +285,14 @@ class Score : public QObject {
       int curSystem;
       MeasureBase* curMeasure;
 
+      OptimalBreaker _lineBreaker;              ///< caches global line break plans
+      OptimalBreaker _pageBreaker;              ///< caches global page break plans
+      QSet<const MeasureBase*> _lineStarts;     ///< planned line starts of current paragraph
+      qreal _lineStartsMargin;                  ///< system left margin the plan was made with
+
+      bool _progressiveLayout;                  ///< next doLayout() defers page details until a page is needed
+      QSet<Spanner*> _pendingSpanners;          ///< spanners not laid out yet
+
       UndoStack* _undo;
 
       QQueue<MidiInputEvent> midiInputQueue;
@@ -355,6 +366,7 @@ class Score : public QObject {
       QList<KeySig*> customKeysigs;
       Omr* _omr;
       Audio* _audio;
+      QSharedPointer<MsczArchive> _archive;     ///< .mscz file the attachments are read from
       bool _showOmr;
       PlayMode _playMode;
 
@@ -401,12 +413,15 @@ class Score : public QObject {
       void createMMRests();
       bool layoutSystem1(qreal& minWidth, bool, bool);
       QList<System*> layoutSystemRow(qreal w, bool, bool);
+      void planLineBreaks(Measure*, qreal headerWidth, qreal leftMargin, qreal w);
+      QSet<const System*> planPageBreaks(int systemIdx);
       void addSystemHeader(Measure* m, bool);
       System* getNextSystem(bool, bool);
       bool doReLayout();
 
       void layoutStage2();
       void layoutStage3();
+      void layoutChordRests(const QList<ChordRest*>&);
       void beamGraceNotes(Chord*);
 
       void hideEmptyStaves(System* system, bool isFirstSystem);
@@ -427,6 +442,7 @@ class Score : public QObject {
 
    protected:
       void createPlayEvents(Chord*);
+      virtual void placeSpannerAndBeams();
       SynthesizerState _synthesizerState;
 
    signals:
@@ -609,6 +625,8 @@ class Score : public QObject {
       void saveFile(QIODevice* f, bool msczFormat, bool onlySelection = false);
       void saveCompressedFile(QFileInfo&, bool onlySelection);
       void saveCompressedFile(QIODevice*, QFileInfo&, bool onlySelection);
+      void createSnapshot(MsczSnapshot*, const QFileInfo&, bool onlySelection);
+      void releaseArchive();
       bool exportFile();
 
       void print(QPainter* printer, int page);
@@ -909,6 +927,13 @@ class Score : public QObject {
 
       void doLayoutSystems();
       void doLayoutPages();
+      const OptimalBreaker& lineBreaker() const { return _lineBreaker; }
+
+      bool progressiveLayout() const        { return _progressiveLayout; }
+      void setProgressiveLayout(bool val)   { _progressiveLayout = val;  }
+      void layoutPendingPage(Page*);
+      Page* nextPendingPage() const;
+      void finishLayout();
       Tuplet* searchTuplet(XmlReader& e, int id);
       void cmdSelectAll();
       void cmdSelectSection();
@@ -42,6 +42,7 @@
 #include "undo.h"
 #include "imageStore.h"
 #include "audio.h"
+#include "msczarchive.h"
 #include "barline.h"
 #include "thirdparty/qzip/qzipreader_p.h"
 #include "thirdparty/qzip/qzipwriter_p.h"
@@ -351,6 +352,9 @@ bool Score::saveFile()
             }
       temp.close();
 
+      // the file we read from is renamed below
+      releaseArchive();
+
       //
       // step 2
       // remove old backup file if exists
@@ -409,6 +413,10 @@ bool Score::saveFile()
 
 void Score::saveCompressedFile(QFileInfo& info, bool onlySelection)
       {
+      // info may be the file we read from
+      bool overwrite = _archive && _archive->path() == info.absoluteFilePath();
+      if (overwrite)
+            _archive->detach();
       QFile fp(info.filePath());
       if (!fp.open(QIODevice::WriteOnly)) {
             QString s = QT_TRANSLATE_NOOP("file", "Open File\n%1\nfailed: ")
@@ -417,6 +425,8 @@ void Score::saveCompressedFile(QFileInfo& info, bool onlySelection)
             }
       saveCompressedFile(&fp, info, onlySelection);
       fp.close();
+      if (overwrite)
+            releaseArchive();
       }
 
 //---------------------------------------------------------
@@ -426,8 +436,20 @@ void Score::saveCompressedFile(QFileInfo& info, bool onlySelection)
 
 void Score::saveCompressedFile(QIODevice* f, QFileInfo& info, bool onlySelection)
       {
-      MQZipWriter uz(f);
+      MsczSnapshot snapshot;
+      createSnapshot(&snapshot, info, onlySelection);
+      snapshot.write(f, MScore::saveCompressionLevel);
+      }
+
+//---------------------------------------------------------
+//   createSnapshot
+//    collect everything saveCompressedFile() writes;
+//    attachments are implicitly shared, only the score
+//    itself is serialized here
+//---------------------------------------------------------
 
+void Score::createSnapshot(MsczSnapshot* snapshot, const QFileInfo& info, bool onlySelection)
+      {
       QString fn = info.completeBaseName() + ".mscx";
       QBuffer cbuf;
       cbuf.open(QIODevice::ReadWrite);
@@ -447,16 +469,21 @@ void Score::saveCompressedFile(QIODevice* f, QFileInfo& info, bool onlySelection
       xml.etag();
       xml.etag();
       cbuf.seek(0);
-      //uz.addDirectory("META-INF");
-      uz.addFile("META-INF/container.xml", cbuf.data());
+      snapshot->add("META-INF/container.xml", cbuf.data());
 
-      // save images
-      //uz.addDirectory("Pictures");
+      // save images; the path is a hash of the content, so a
+      // picture of the same path in the archive is unchanged
       foreach(ImageStoreItem* ip, imageStore) {
             if (!ip->isUsed(this))
                   continue;
             QString path = QString("Pictures/") + ip->hashName();
-            uz.addFile(path, ip->buffer());
+            MQZipRawEntry raw;
+            if (_archive)
+                  raw = _archive->rawFileData(path);
+            if (!raw.isNull())
+                  snapshot->add(path, raw);
+            else
+                  snapshot->add(path, ip->buffer());
             }
 #ifdef OMR
       //
@@ -466,28 +493,34 @@ void Score::saveCompressedFile(QIODevice* f, QFileInfo& info, bool onlySelection
             int n = _omr->numPages();
             for (int i = 0; i < n; ++i) {
                   QString path = QString("OmrPages/page%1.png").arg(i+1);
-                  QBuffer cbuf;
                   OmrPage* page = _omr->page(i);
-                  const QImage& image = page->image();
-                  if (!image.save(&cbuf, "PNG"))
-                        throw(QString("save file: cannot save image (%1x%2)").arg(image.width()).arg(image.height()));
-                  uz.addFile(path, cbuf.data());
-                  cbuf.close();
+                  MQZipRawEntry raw;
+                  if (page->archive())
+                        raw = page->archive()->rawFileData(page->archivePath());
+                  if (!raw.isNull())
+                        snapshot->add(path, raw);
+                  else
+                        snapshot->add(path, page->image());
                   }
             }
 #endif
       //
       // save audio
       //
-      if (_audio)
-            uz.addFile("audio.ogg", _audio->data());
+      if (_audio) {
+            MQZipRawEntry raw;
+            if (_audio->archive())
+                  raw = _audio->archive()->rawFileData("audio.ogg");
+            if (!raw.isNull())
+                  snapshot->add("audio.ogg", raw);
+            else
+                  snapshot->add("audio.ogg", _audio->data());
+            }
 
       QBuffer dbuf;
       dbuf.open(QIODevice::ReadWrite);
       saveFile(&dbuf, true, onlySelection);
-      dbuf.seek(0);
-      uz.addFile(fn, dbuf.data());
-      uz.close();
+      snapshot->add(fn, dbuf.data());
       }
 
 //---------------------------------------------------------
@@ -642,6 +675,31 @@ QString readRootFile(MQZipReader* uz, QList<QString>& images)
       return rootfile;
       }
 
+//---------------------------------------------------------
+//   releaseArchive
+//    read the attachments not yet read from the .mscz file
+//    the score was loaded from and close the file; called
+//    when the score is closed or the file is overwritten
+//---------------------------------------------------------
+
+void Score::releaseArchive()
+      {
+      if (!_archive)
+            return;
+      foreach(ImageStoreItem* ip, imageStore)
+            ip->releaseArchive(_archive.data());
+#ifdef OMR
+      if (_omr) {
+            int n = _omr->numPages();
+            for (int i = 0; i < n; ++i)
+                  _omr->page(i)->releaseArchive();
+            }
+#endif
+      if (_audio)
+            _audio->releaseArchive();
+      _archive.clear();
+      }
+
 //---------------------------------------------------------
 //   loadCompressedMsc
 //    return false on error
@@ -649,7 +707,8 @@ QString readRootFile(MQZipReader* uz, QList<QString>& images)
 
 Score::FileError Score::loadCompressedMsc(QString name, bool ignoreVersionError)
       {
-      MQZipReader uz(name);
+      QSharedPointer<MsczArchive> archive(new MsczArchive(name));
+      MQZipReader& uz = *archive->reader();
       if (!uz.exists()) {
             qDebug("loadCompressedMsc: <%s> not found", qPrintable(name));
             MScore::lastError = QT_TRANSLATE_NOOP("file", "file not found");
@@ -660,15 +719,15 @@ Score::FileError Score::loadCompressedMsc(QString name, bool ignoreVersionError)
       QString rootfile = readRootFile(&uz, sl);
       if (rootfile.isEmpty())
             return FILE_NO_ROOTFILE;
+      _archive = archive;
 
       //
-      // load images
+      // register images; they are read from the archive
+      // when first drawn
       //
       if (!MScore::noImages) {
-            foreach(const QString& s, sl) {
-                  QByteArray dbuf = uz.fileData(s);
-                  imageStore.add(s, dbuf);
-                  }
+            foreach(const QString& s, sl)
+                  imageStore.add(s, archive);
             }
 
       QByteArray dbuf = uz.fileData(rootfile);
@@ -689,30 +748,19 @@ Score::FileError Score::loadCompressedMsc(QString name, bool ignoreVersionError)
 
 #ifdef OMR
       //
-      // load OMR page images
+      // OMR page images are decoded when the page is shown
       //
       if (_omr) {
             int n = _omr->numPages();
-            for (int i = 0; i < n; ++i) {
-                  QString path = QString("OmrPages/page%1.png").arg(i+1);
-                  QByteArray dbuf = uz.fileData(path);
-                  OmrPage* page = _omr->page(i);
-                  QImage image;
-                  if (image.loadFromData(dbuf, "PNG")) {
-                        page->setImage(image);
-                        }
-                  else
-                        qDebug("load image failed");
-                  }
+            for (int i = 0; i < n; ++i)
+                  _omr->page(i)->setImage(archive, QString("OmrPages/page%1.png").arg(i+1));
             }
 #endif
       //
-      //  read audio
+      //  audio is read when playback starts
       //
-      if (_audio) {
-            QByteArray dbuf = uz.fileData("audio.ogg");
-            _audio->setData(dbuf);
-            }
+      if (_audio)
+            _audio->setData(archive);
       return retval;
       }
 
@@ -734,6 +782,17 @@ Score::FileError Score::loadMsc(QString name, bool ignoreVersionError)
             return FILE_OPEN_ERROR;
             }
 
+      //
+      //  map the file and parse it in place; the reader
+      //  decodes the mapped bytes in chunks
+      //
+      uchar* data = f.size() > 0 ? f.map(0, f.size()) : 0;
+      if (data) {
+            XmlReader xml(QByteArray::fromRawData((const char*)data, f.size()), f.fileName());
+            FileError retval = read1(xml, ignoreVersionError);
+            f.unmap(data);
+            return retval;
+            }
       XmlReader xml(&f);
       FileError retval = read1(xml, ignoreVersionError);
       return retval;
@@ -0,0 +1,185 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "scoregenerator.h"
+#include "mcursor.h"
+#include "score.h"
+#include "chord.h"
+#include "durationtype.h"
+#include "harmony.h"
+#include "lyrics.h"
+#include "measure.h"
+#include "segment.h"
+#include "slur.h"
+#include "tuplet.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   instruments
+//    cycled through for the parts, with the pitch of
+//    the lowest note generated
+//---------------------------------------------------------
+
+static const struct {
+      const char* name;
+      int pitch;
+      } instruments[] = {
+      { "flute",       72 }, { "oboe",     67 }, { "clarinet", 60 }, { "bassoon", 43 },
+      { "horn",        55 }, { "trumpet",  62 }, { "trombone", 45 }, { "tuba",    36 },
+      { "soprano",     64 }, { "alto",     57 }, { "tenor",    50 }, { "bass",    43 },
+      { "violin",      67 }, { "viola",    57 }, { "violoncello", 43 }, { "contrabass", 36 },
+      };
+
+static const char* syllables[] = {
+      "la", "lu", "ma", "ri", "so", "te", "ka", "no", "ve", "di"
+      };
+
+static const char* harmonyNames[] = {
+      "C", "Am7", "Dm", "G7", "F", "Bb", "Eb", "Cmaj7", "E7", "Gsus4"
+      };
+
+static const int RANGE = 12;        // pitches above the base pitch
+
+//---------------------------------------------------------
+//   ScoreGenerator
+//---------------------------------------------------------
+
+ScoreGenerator::ScoreGenerator()
+      {
+      measures   = 32;
+      parts      = 4;
+      chordNotes = 3;
+      tuplets    = 20;
+      slurs      = 10;
+      lyrics     = 30;
+      harmonies  = 50;
+      seed       = 1;
+      }
+
+//---------------------------------------------------------
+//   create
+//---------------------------------------------------------
+
+Score* ScoreGenerator::create()
+      {
+      _rng.seed(seed);
+      Score* score = new Score(MScore::baseStyle());
+      score->setName(QString("generated-%1x%2-%3").arg(parts).arg(measures).arg(seed));
+      MCursor c(score);
+      c.setTimeSig(Fraction(4,4));
+      int n = sizeof(instruments) / sizeof(*instruments);
+      for (int i = 0; i < parts; ++i)
+            c.addPart(instruments[i % n].name);
+      c.move(0, 0);
+      c.addKeySig(0);
+      c.addTimeSig(Fraction(4,4));
+      for (int staffIdx = 0; staffIdx < parts; ++staffIdx)
+            addStaff(score, staffIdx, instruments[staffIdx % n].pitch);
+      addHarmonies(score);
+      return score;
+      }
+
+//---------------------------------------------------------
+//   addStaff
+//    fill voice 1 with quarters, eighths and triplets
+//---------------------------------------------------------
+
+void ScoreGenerator::addStaff(Score* score, int staffIdx, int basePitch)
+      {
+      int track = staffIdx * VOICES;
+      MCursor c(score);
+      Chord* slurStart = 0;
+      int slurChords   = 0;
+
+      for (int beat = 0; beat < measures * 4; ++beat) {
+            int tick = beat * MScore::division;
+            int n;
+            TDuration d;
+            Tuplet* tuplet = 0;
+            if (chance(tuplets)) {
+                  n = 3;
+                  d = TDuration(TDuration::V_EIGHTH);
+                  tuplet = new Tuplet(score);
+                  tuplet->setRatio(Fraction(3,2));
+                  tuplet->setBaseLen(d);
+                  tuplet->setTrack(track);
+                  tuplet->setTick(tick);
+                  tuplet->setDuration(Fraction(1,4));
+                  }
+            else if (chance(50)) {
+                  n = 2;
+                  d = TDuration(TDuration::V_EIGHTH);
+                  }
+            else {
+                  n = 1;
+                  d = TDuration(TDuration::V_QUARTER);
+                  }
+            for (int i = 0; i < n; ++i) {
+                  int chordTick = tick + (i * MScore::division) / n;
+                  int notes = 1 + random(chordNotes);
+                  int pitch = basePitch + random(RANGE);
+                  Chord* chord = 0;
+                  for (int k = 0; k < notes; ++k) {
+                        c.move(track, chordTick);
+                        chord = c.addChord(pitch + 3 * k, d, tuplet);
+                        }
+                  if (tuplet && i == 0)
+                        tuplet->setParent(chord->measure());
+                  if (chance(lyrics)) {
+                        Lyrics* l = new Lyrics(score);
+                        l->setTrack(track);
+                        l->setText(syllables[random(sizeof(syllables) / sizeof(*syllables))]);
+                        chord->add(l);
+                        }
+                  if (slurStart && --slurChords == 0) {
+                        Slur* slur = new Slur(score);
+                        slur->setTick(slurStart->tick());
+                        slur->setTick2(chord->tick());
+                        slur->setTrack(track);
+                        slur->setTrack2(track);
+                        slur->setStartElement(slurStart);
+                        slur->setEndElement(chord);
+                        score->addSpanner(slur);
+                        slurStart = 0;
+                        }
+                  else if (!slurStart && chance(slurs)) {
+                        slurStart  = chord;
+                        slurChords = 1 + random(4);
+                        }
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   addHarmonies
+//---------------------------------------------------------
+
+void ScoreGenerator::addHarmonies(Score* score)
+      {
+      int nh = sizeof(harmonyNames) / sizeof(*harmonyNames);
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+            for (int half = 0; half < 2; ++half) {
+                  if (!chance(harmonies))
+                        continue;
+                  int tick = m->tick() + half * 2 * MScore::division;
+                  Segment* s = m->getSegment(Segment::SegChordRest, tick);
+                  Harmony* h = new Harmony(score);
+                  h->setHarmony(harmonyNames[random(nh)]);
+                  h->setTrack(0);
+                  s->add(h);
+                  }
+            }
+      }
+
+}     // namespace Ms
+
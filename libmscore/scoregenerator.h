@@ -0,0 +1,59 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __SCOREGENERATOR_H__
+#define __SCOREGENERATOR_H__
+
+#include <random>
+
+namespace Ms {
+
+class Score;
+class Chord;
+
+//---------------------------------------------------------
+//   ScoreGenerator
+//    creates large 4/4 scores for scalability tests;
+//    the same parameters and seed always give the same
+//    score. Densities are percentages:
+//      tuplets     beats filled with an eighth triplet
+//      slurs       chords starting a slur over 2-5 chords
+//      lyrics      chords with a syllable
+//      harmonies   half measures of the first staff with
+//                  a chord symbol
+//---------------------------------------------------------
+
+class ScoreGenerator {
+      std::mt19937 _rng;
+
+      int random(int n)         { return int(_rng() % unsigned(n)); }
+      bool chance(int percent)  { return random(100) < percent; }
+      void addStaff(Score*, int staffIdx, int basePitch);
+      void addHarmonies(Score*);
+
+   public:
+      int measures;
+      int parts;
+      int chordNotes;         // max notes per chord
+      int tuplets;
+      int slurs;
+      int lyrics;
+      int harmonies;
+      unsigned seed;
+
+      ScoreGenerator();
+      Score* create();
+      };
+
+}     // namespace Ms
+#endif
+
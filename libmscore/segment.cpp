@@ -73,11 +73,11 @@ void Segment::setElement(int track, Element* el)
       {
       if (el) {
             el->setParent(this);
-            _elist[track] = el;
+            _elist.set(track, el);
             empty = false;
             }
       else {
-            _elist[track] = 0;
+            _elist.set(track, 0);
             checkEmpty();
             }
       }
@@ -143,14 +143,11 @@ Segment::Segment(const Segment& s)
             add(ne);
             }
 
-      _elist.reserve(s._elist.size());
-      foreach (Element* e, s._elist) {
-            Element* ne = 0;
-            if (e) {
-                  ne = e->clone();
-                  ne->setParent(this);
-                  }
-            _elist.append(ne);
+      _elist = TrackMap(s._elist.size());
+      for (int track = s.nextTrack(0); track != -1; track = s.nextTrack(track + 1)) {
+            Element* ne = s.element(track)->clone();
+            ne->setParent(this);
+            _elist.set(track, ne);
             }
       _dotPosX = s._dotPosX;
       }
@@ -168,19 +165,15 @@ void Segment::setSegmentType(SegmentType t)
 void Segment::setScore(Score* score)
       {
       Element::setScore(score);
-      foreach(Element* e, _elist) {
-            if (e)
-                  e->setScore(score);
-            }
+      for (Element* e : _elist)
+            e->setScore(score);
       foreach(Element* e, _annotations)
             e->setScore(score);
       }
 
 Segment::~Segment()
       {
-      foreach(Element* e, _elist) {
-            if (!e)
-                  continue;
+      for (Element* e : _elist) {
             if (e->type() == CLEF)
                   e->staff()->removeClef(static_cast<Clef*>(e));
             else if (e->type() == TIMESIG)
@@ -195,14 +188,7 @@ Segment::~Segment()
 
 void Segment::init()
       {
-      int staves = score()->nstaves();
-      int tracks = staves * VOICES;
-      _elist.reserve(tracks);
-      for (int i = 0; i < tracks; ++i)
-            _elist.push_back(0);
-      _dotPosX.reserve(staves);
-      for (int i = 0; i < staves; ++i)
-            _dotPosX.push_back(0.0);
+      _elist = TrackMap(score()->nstaves() * VOICES);
       _prev = 0;
       _next = 0;
       }
@@ -367,9 +353,9 @@ ChordRest* Segment::nextChordRest(int track, bool backwards) const
 void Segment::insertStaff(int staff)
       {
       int track = staff * VOICES;
-      for (int voice = 0; voice < VOICES; ++voice)
-            _elist.insert(track, 0);
-      _dotPosX.insert(staff, 0.0);
+      _elist.insert(track, VOICES);
+      if (!_dotPosX.isEmpty())
+            _dotPosX.insert(staff, 0.0);
 
       foreach(Element* e, _annotations) {
             int staffIdx = e->staffIdx();
@@ -387,8 +373,9 @@ void Segment::insertStaff(int staff)
 void Segment::removeStaff(int staff)
       {
       int track = staff * VOICES;
-      _elist.erase(_elist.begin() + track, _elist.begin() + track + VOICES);
-      _dotPosX.removeAt(staff);
+      _elist.remove(track, VOICES);
+      if (!_dotPosX.isEmpty())
+            _dotPosX.remove(staff);
 
       foreach(Element* e, _annotations) {
             int staffIdx = e->staffIdx();
@@ -414,7 +401,7 @@ void Segment::add(Element* el)
       switch (el->type()) {
             case REPEAT_MEASURE:
                   measure()->setRepeatFlags(measure()->repeatFlags() | RepeatMeasureFlag);
-                  _elist[track] = el;
+                  _elist.set(track, el);
                   empty = false;
                   break;
 
@@ -461,7 +448,7 @@ void Segment::add(Element* el)
                            el->name(), _elist[track]->name(),
                            score()->sigmap()->pos(tick()), tick(), track, score());
                         }
-                  _elist[track] = el;
+                  _elist.set(track, el);
                   el->staff()->addClef(static_cast<Clef*>(el));
                   empty = false;
                   break;
@@ -473,7 +460,7 @@ void Segment::add(Element* el)
                            el->name(), _elist[track]->name(),
                            score()->sigmap()->pos(tick()), tick(), track, score());
                         }
-                  _elist[track] = el;
+                  _elist.set(track, el);
                   el->staff()->addTimeSig(static_cast<TimeSig*>(el));
                   empty = false;
                   break;
@@ -501,7 +488,7 @@ void Segment::add(Element* el)
                            el->name(), _elist[track]->name(),
                            score()->sigmap()->pos(tick()), tick(), track, score());
                         }
-                  _elist[track] = el;
+                  _elist.set(track, el);
                   empty = false;
                   break;
             case AMBITUS:
@@ -512,7 +499,7 @@ void Segment::add(Element* el)
                            score()->sigmap()->pos(tick()), tick(), track, score());
                         return;
                         }
-                  _elist[track] = el;
+                  _elist.set(track, el);
                   empty = false;
                   break;
 
@@ -535,7 +522,7 @@ void Segment::remove(Element* el)
             case CHORD:
             case REST:
                   {
-                  _elist[track] = 0;
+                  _elist.set(track, 0);
                   int staffIdx = el->staffIdx();
                   measure()->checkMultiVoices(staffIdx);
                   }
@@ -543,7 +530,7 @@ void Segment::remove(Element* el)
 
             case REPEAT_MEASURE:
                   measure()->setRepeatFlags(measure()->repeatFlags() & ~RepeatMeasureFlag);
-                  _elist[track] = 0;
+                  _elist.set(track, 0);
                   break;
 
             case DYNAMIC:
@@ -584,12 +571,12 @@ void Segment::remove(Element* el)
                   break;
 
             case CLEF:
-                  _elist[track] = 0;
+                  _elist.set(track, 0);
                   el->staff()->removeClef(static_cast<Clef*>(el));
                   break;
 
             case TIMESIG:
-                  _elist[track] = 0;
+                  _elist.set(track, 0);
                   el->staff()->removeTimeSig(static_cast<TimeSig*>(el));
                   break;
 
@@ -597,7 +584,7 @@ void Segment::remove(Element* el)
             case BAR_LINE:
             case BREATH:
             case AMBITUS:
-                  _elist[track] = 0;
+                  _elist.set(track, 0);
                   break;
 
             default:
@@ -643,10 +630,9 @@ Segment::SegmentType Segment::segmentType(ElementType type)
 
 void Segment::removeGeneratedElements()
       {
-      for (int i = 0; i < _elist.size(); ++i) {
-            if (_elist[i] && _elist[i]->generated()) {
-                  _elist[i] = 0;
-                  }
+      for (int track = nextTrack(0); track != -1; track = nextTrack(track + 1)) {
+            if (_elist.value(track)->generated())
+                  _elist.set(track, 0);
             }
       checkEmpty();
       }
@@ -657,14 +643,13 @@ void Segment::removeGeneratedElements()
 
 void Segment::sortStaves(QList<int>& dst)
       {
-      QList<Element*>   dl;
+      TrackMap dl(dst.size() * VOICES);
 
       for (int i = 0; i < dst.size(); ++i) {
             int startTrack = dst[i] * VOICES;
             int endTrack   = startTrack + VOICES;
-            dl.reserve(VOICES);
             for (int k = startTrack; k < endTrack; ++k)
-                  dl.append(_elist[k]);
+                  dl.set(i * VOICES + k - startTrack, _elist.value(k));
             }
       _elist = dl;
       QMap<int, int> map;
@@ -684,12 +669,8 @@ void Segment::sortStaves(QList<int>& dst)
 
 void Segment::fixStaffIdx()
       {
-      int track = 0;
-      foreach(Element* e, _elist) {
-            if (e)
-                  e->setTrack(track);
-            ++track;
-            }
+      for (int track = nextTrack(0); track != -1; track = nextTrack(track + 1))
+            _elist.value(track)->setTrack(track);
       }
 
 //---------------------------------------------------------
@@ -702,13 +683,7 @@ void Segment::checkEmpty() const
             empty = false;
             return;
             }
-      empty = true;
-      foreach(const Element* e, _elist) {
-            if (e) {
-                  empty = false;
-                  break;
-                  }
-            }
+      empty = _elist.isEmpty();
       }
 
 //---------------------------------------------------------
@@ -748,6 +723,17 @@ const QList<Lyrics*>* Segment::lyricsList(int track) const
       return 0;
       }
 
+//---------------------------------------------------------
+//   setDotPosX
+//---------------------------------------------------------
+
+void Segment::setDotPosX(int staffIdx, qreal val)
+      {
+      if (_dotPosX.isEmpty())
+            _dotPosX.fill(0.0, score()->nstaves());
+      _dotPosX[staffIdx] = val;
+      }
+
 //---------------------------------------------------------
 //   swapElements
 //---------------------------------------------------------
@@ -755,10 +741,10 @@ const QList<Lyrics*>* Segment::lyricsList(int track) const
 void Segment::swapElements(int i1, int i2)
       {
       _elist.swap(i1, i2);
-      if (_elist[i1])
-            _elist[i1]->setTrack(i1);
-      if (_elist[i2])
-            _elist[i2]->setTrack(i2);
+      if (_elist.value(i1))
+            _elist.value(i1)->setTrack(i1);
+      if (_elist.value(i2))
+            _elist.value(i2)->setTrack(i2);
       }
 
 //---------------------------------------------------------
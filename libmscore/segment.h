@@ -19,6 +19,7 @@
 #define __SEGMENT_H__
 
 #include "element.h"
+#include "trackmap.h"
 
 class QPainter;
 
@@ -44,6 +45,8 @@ class System;
  each voice in each staff in the score. It also stores the lyrics for each staff.
  Some elements (Clef, KeySig, TimeSig etc.) are assumed to always have voice zero
  and can be found in _elist[staffIdx * VOICES];
+ Only occupied tracks are stored (see TrackMap); use nextTrack() to iterate
+ over them.
 
  Segments are children of Measures and store Clefs, KeySigs, TimeSigs,
  BarLines and ChordRests.
@@ -83,11 +86,11 @@ class Segment : public Element {
       int _tick;
       Spatium _extraLeadingSpace;
       Spatium _extraTrailingSpace;
-      QList<qreal>   _dotPosX;     ///< size = staves
+      QVector<qreal> _dotPosX;     ///< size = staves, allocated on first use
 
       std::vector<Element*> _annotations;
 
-      QList<Element*> _elist;      ///< Element storage, size = staves * VOICES.
+      TrackMap _elist;             ///< Element storage, size = staves * VOICES.
 
       void init();
       void checkEmpty() const;
@@ -129,8 +132,8 @@ class Segment : public Element {
             Q_ASSERT(_segmentType == SegChordRest);
             return (ChordRest*)(_elist.value(track));
             };
-      const QList<Element*>& elist() const { return _elist; }
-      QList<Element*>& elist()             { return _elist; }
+      const TrackMap& elist() const        { return _elist; }
+      int nextTrack(int track) const       { return _elist.nextTrack(track); }  ///< first occupied track >= track, -1 if none
 
       void removeElement(int track);
       void setElement(int track, Element* el);
@@ -171,8 +174,8 @@ class Segment : public Element {
       void removeAnnotation(Element* e);
       bool findAnnotationOrElement(ElementType type, int minTrack, int maxTrack);
 
-      qreal dotPosX(int staffIdx) const          { return _dotPosX[staffIdx];  }
-      void setDotPosX(int staffIdx, qreal val)   { _dotPosX[staffIdx] = val;   }
+      qreal dotPosX(int staffIdx) const          { return _dotPosX.value(staffIdx, 0.0); }
+      void setDotPosX(int staffIdx, qreal val);
 
       Spatium extraLeadingSpace() const          { return _extraLeadingSpace;  }
       void setExtraLeadingSpace(Spatium v)       { _extraLeadingSpace = v;     }
@@ -245,6 +245,36 @@ void Spanner::setScore(Score* s)
             seg->setScore(s);
       }
 
+//---------------------------------------------------------
+//   setTick
+//    the interval tree of the spanner map holding this
+//    spanner is rebuilt on the next range query; the map
+//    key is not changed, as callers iterate the map
+//    while moving spanners
+//---------------------------------------------------------
+
+void Spanner::setTick(int v)
+      {
+      if (_tick == v)
+            return;
+      _tick = v;
+      if (_map)
+            _map->setDirty();
+      }
+
+//---------------------------------------------------------
+//   setTick2
+//---------------------------------------------------------
+
+void Spanner::setTick2(int v)
+      {
+      if (_tick2 == v)
+            return;
+      _tick2 = v;
+      if (_map)
+            _map->setDirty();
+      }
+
 //---------------------------------------------------------
 //   startEdit
 //---------------------------------------------------------
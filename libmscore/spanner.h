@@ -22,6 +22,7 @@ class Spanner;
 class System;
 class Chord;
 class ChordRest;
+class SpannerMap;
 
 //---------------------------------------------------------
 //   SpannerSegmentType
@@ -109,6 +110,7 @@ class Spanner : public Element {
       int _tick2 = -1;
       int _track2 = -1;
       int _id = -1;           // used for xml serialization
+      SpannerMap* _map = 0;   // the spanner map this spanner is in
 
       static QList<QPointF> userOffsets;
       static QList<QPointF> userOffsets2;
@@ -125,10 +127,10 @@ class Spanner : public Element {
       virtual void setScore(Score* s) override;
 
       int tick() const         { return _tick;          }
-      void setTick(int v)      { _tick = v;             }
+      void setTick(int v);
       int tickLen() const      { return _tick2 - _tick; }
       int tick2() const        { return _tick2;         }
-      void setTick2(int v)     { _tick2 = v;            }
+      void setTick2(int v);
       int track2() const       { return _track2;        }
       void setTrack2(int v)    { _track2 = v;           }
 
@@ -178,6 +180,7 @@ class Spanner : public Element {
       virtual void setVisible(bool f) override;
 
       friend class SpannerSegment;
+      friend class SpannerMap;
       };
 
 }     // namespace Ms
@@ -64,6 +64,26 @@ const std::vector<Interval<Spanner*>>& SpannerMap::findOverlapping(int start, in
       return results;
       }
 
+//---------------------------------------------------------
+//   overlapping
+//    read only; without a valid tree the map is scanned
+//---------------------------------------------------------
+
+std::vector<Interval<Spanner*>> SpannerMap::overlapping(int start, int stop) const
+      {
+      std::vector< ::Interval<Spanner*> > l;
+      if (dirty) {
+            for (auto i : *this) {
+                  Spanner* s = i.second;
+                  if (s->tick2() >= start && s->tick() <= stop)
+                        l.push_back(Interval<Spanner*>(s->tick(), s->tick2(), s));
+                  }
+            }
+      else
+            tree.findOverlapping(start, stop, l);
+      return l;
+      }
+
 //---------------------------------------------------------
 //   addSpanner
 //---------------------------------------------------------
@@ -71,6 +91,9 @@ const std::vector<Interval<Spanner*>>& SpannerMap::findOverlapping(int start, in
 void SpannerMap::addSpanner(Spanner* s)
       {
       insert(std::pair<int,Spanner*>(s->tick(), s));
+      keys.insert(s, s->tick());
+      kinds[s->type()].insert(s);
+      s->_map = this;
       dirty = true;
       }
 
@@ -80,16 +103,37 @@ void SpannerMap::addSpanner(Spanner* s)
 
 bool SpannerMap::removeSpanner(Spanner* s)
       {
-      for (auto i = begin(); i != end(); ++i) {
-            if (i->second == s) {
-                  erase(i);
-                  dirty = true;
-                  return true;
+      auto k = keys.find(s);
+      if (k != keys.end()) {
+            auto range = equal_range(k.value());
+            for (auto i = range.first; i != range.second; ++i) {
+                  if (i->second == s) {
+                        erase(i);
+                        keys.erase(k);
+                        kinds[s->type()].remove(s);
+                        if (s->_map == this)
+                              s->_map = 0;
+                        dirty = true;
+                        return true;
+                        }
                   }
             }
       qDebug("Score::removeSpanner: %s (%p) not found", s->name(), s);
       return false;
       }
 
+//---------------------------------------------------------
+//   spanners
+//    all spanners of element type type, in no
+//    particular order
+//---------------------------------------------------------
+
+const QSet<Spanner*>& SpannerMap::spanners(Element::ElementType type) const
+      {
+      static const QSet<Spanner*> empty;
+      auto i = kinds.find(type);
+      return i == kinds.end() ? empty : *i;
+      }
+
 }     // namespace Ms
 
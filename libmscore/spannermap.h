@@ -13,7 +13,7 @@
 #ifndef __SPANNERMAP_H__
 #define __SPANNERMAP_H__
 
-
+#include "element.h"
 #include "thirdparty/intervaltree/IntervalTree.h"
 
 namespace Ms {
@@ -22,12 +22,33 @@ class Spanner;
 
 //---------------------------------------------------------
 //   SpannerMap
+//    all spanners of a score ordered by start tick
+//
+//    An interval tree answers range queries; it is rebuilt
+//    lazily after a spanner was added, removed or changed
+//    its tick range. Spanners are additionally indexed by
+//    element type, so callers interested in one kind only
+//    (pedals, hairpins, ...) do not have to scan the whole
+//    map; the index holds pointers only, callers read the
+//    ticks from the spanners.
+//
+//    The map key is the start tick a spanner had when it
+//    was added; it is not changed with the tick, as callers
+//    iterate the map while moving spanners. keys remembers
+//    it, so removal does not depend on the current tick.
+//
+//    findContained() and findOverlapping() share one result
+//    vector and may rebuild the tree; overlapping() is safe
+//    to call from several threads as long as the map is not
+//    changed. Call build() before starting the threads.
 //---------------------------------------------------------
 
 class SpannerMap : std::multimap<int, Spanner*> {
       mutable bool dirty;
       mutable IntervalTree<Spanner*> tree;
       std::vector< ::Interval<Spanner*> > results;
+      QHash<int, QSet<Spanner*>> kinds;         ///< spanners by element type
+      QHash<Spanner*, int> keys;                ///< map key of every spanner
 
       void update() const;
 
@@ -35,6 +56,8 @@ class SpannerMap : std::multimap<int, Spanner*> {
       SpannerMap();
       const std::vector< ::Interval<Spanner*> >& findContained(int start, int stop);
       const std::vector< ::Interval<Spanner*> >& findOverlapping(int start, int stop);
+      std::vector< ::Interval<Spanner*> > overlapping(int start, int stop) const;
+      void build() const    { if (dirty) update(); }
       const std::multimap<int, Spanner*>& map() const { return *this; }
       std::multimap<int,Spanner*>::const_reverse_iterator crbegin() const { return std::multimap<int, Spanner*>::crbegin(); }
       std::multimap<int,Spanner*>::const_reverse_iterator crend() const   { return std::multimap<int, Spanner*>::crend(); }
@@ -42,6 +65,14 @@ class SpannerMap : std::multimap<int, Spanner*> {
       std::multimap<int,Spanner*>::const_iterator cend() const  { return std::multimap<int, Spanner*>::cend(); }
       void addSpanner(Spanner* s);
       bool removeSpanner(Spanner* s);
+      void setDirty() const { dirty = true; }
+      bool isDirty() const  { return dirty; }
+
+      const QSet<Spanner*>& spanners(Element::ElementType type) const;
+      const QSet<Spanner*>& pedals() const   { return spanners(Element::PEDAL);   }
+      const QSet<Spanner*>& hairpins() const { return spanners(Element::HAIRPIN); }
+      const QSet<Spanner*>& ottavas() const  { return spanners(Element::OTTAVA);  }
+      const QSet<Spanner*>& slurs() const    { return spanners(Element::SLUR);    }
       };
 
 }     // namespace Ms
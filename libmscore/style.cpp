@@ -163,6 +163,7 @@ static const StyleTypes2 styleTypes2[] = {
       { ST_ArpeggioHookLen,             StyleType("ArpeggioHookLen",         ST_SPATIUM) },
       { ST_FixMeasureNumbers,           StyleType("FixMeasureNumbers",       ST_INT) },
       { ST_FixMeasureWidth,             StyleType("FixMeasureWidth",         ST_BOOL) },
+      { ST_optimalBreaks,               StyleType("optimalBreaks",           ST_BOOL) },
       { ST_SlurEndWidth,                StyleType("slurEndWidth",            ST_SPATIUM) },
       { ST_SlurMidWidth,                StyleType("slurMidWidth",            ST_SPATIUM) },
       { ST_SlurDottedWidth,             StyleType("slurDottedWidth",         ST_SPATIUM) },
@@ -460,6 +461,7 @@ StyleData::StyleData()
             { ST_ArpeggioHookLen,             QVariant(.8) },
             { ST_FixMeasureNumbers,           QVariant(0) },
             { ST_FixMeasureWidth,             QVariant(false) },
+            { ST_optimalBreaks,               QVariant(false) },
             { ST_SlurEndWidth,                QVariant(.07) },
             { ST_SlurMidWidth,                QVariant(.15) },
             { ST_SlurDottedWidth,             QVariant(.1) },
@@ -286,6 +286,7 @@ enum StyleIdx {
       ST_ArpeggioHookLen,
       ST_FixMeasureNumbers,
       ST_FixMeasureWidth,
+      ST_optimalBreaks,
 
       ST_SlurEndWidth,
       ST_SlurMidWidth,
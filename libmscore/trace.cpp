@@ -0,0 +1,152 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "trace.h"
+
+namespace Ms {
+
+static const int TRACE_EVENTS = 1 << 16;        // power of two
+
+//---------------------------------------------------------
+//   TraceEvent
+//    seq is the number of the span + 1 once the slot is
+//    complete, 0 while it is written
+//---------------------------------------------------------
+
+struct TraceEvent {
+      std::atomic<quint64> seq;
+      const char* name;
+      qint64 begin;
+      qint64 end;
+      int thread;
+      };
+
+std::atomic<bool> Trace::_enabled(false);
+
+static TraceEvent* events;
+static std::atomic<quint64> head(0);
+static std::atomic<int> threads(0);
+static QElapsedTimer timer;
+
+//---------------------------------------------------------
+//   threadNo
+//    small number of the calling thread, in order of the
+//    first span
+//---------------------------------------------------------
+
+static int threadNo()
+      {
+      static thread_local int n = threads.fetch_add(1) + 1;
+      return n;
+      }
+
+//---------------------------------------------------------
+//   setEnabled
+//    the buffer is allocated on first use
+//---------------------------------------------------------
+
+void Trace::setEnabled(bool val)
+      {
+      if (val && !events) {
+            events = new TraceEvent[TRACE_EVENTS]();
+            timer.start();
+            }
+      _enabled.store(val, std::memory_order_release);
+      }
+
+//---------------------------------------------------------
+//   now
+//    ns since tracing was first enabled
+//---------------------------------------------------------
+
+qint64 Trace::now()
+      {
+      return timer.nsecsElapsed();
+      }
+
+//---------------------------------------------------------
+//   record
+//    called from any thread, including the audio thread:
+//    no locks, no allocation
+//---------------------------------------------------------
+
+void Trace::record(const char* name, qint64 begin, qint64 end)
+      {
+      quint64 n = head.fetch_add(1, std::memory_order_relaxed);
+      TraceEvent& e = events[n & (TRACE_EVENTS - 1)];
+      e.seq.store(0, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      e.name   = name;
+      e.begin  = begin;
+      e.end    = end;
+      e.thread = threadNo();
+      e.seq.store(n + 1, std::memory_order_release);
+      }
+
+//---------------------------------------------------------
+//   save
+//    write the spans in the buffer as Chrome trace events;
+//    spans overwritten while saving are skipped
+//---------------------------------------------------------
+
+bool Trace::save(const QString& path)
+      {
+      QFile f(path);
+      if (!f.open(QIODevice::WriteOnly))
+            return false;
+
+      struct Span {
+            quint64 seq;
+            const char* name;
+            qint64 begin;
+            qint64 end;
+            int thread;
+            bool operator<(const Span& s) const { return seq < s.seq; }
+            };
+      std::vector<Span> spans;
+      if (events) {
+            spans.reserve(TRACE_EVENTS);
+            for (int i = 0; i < TRACE_EVENTS; ++i) {
+                  TraceEvent& e = events[i];
+                  quint64 seq = e.seq.load(std::memory_order_acquire);
+                  if (seq == 0)
+                        continue;
+                  Span s = { seq, e.name, e.begin, e.end, e.thread };
+                  std::atomic_thread_fence(std::memory_order_acquire);
+                  if (e.seq.load(std::memory_order_relaxed) == seq)
+                        spans.push_back(s);
+                  }
+            std::sort(spans.begin(), spans.end());
+            }
+
+      QByteArray data("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+      bool first = true;
+      for (const Span& s : spans) {
+            if (!first)
+                  data += ",\n";
+            first = false;
+            data += "{\"name\":\"";
+            data += s.name;
+            data += "\",\"cat\":\"mscore\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+            data += QByteArray::number(s.thread);
+            data += ",\"ts\":";
+            data += QByteArray::number(s.begin / 1000.0, 'f', 3);
+            data += ",\"dur\":";
+            data += QByteArray::number((s.end - s.begin) / 1000.0, 'f', 3);
+            data += "}";
+            }
+      data += "\n]}\n";
+      return f.write(data) == data.size();
+      }
+
+}     // namespace Ms
+
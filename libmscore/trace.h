@@ -0,0 +1,78 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <atomic>
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   Trace
+//    records named time spans of the hot paths (layout,
+//    midi rendering, painting, audio) with their thread
+//    into a lock free ring buffer holding the last
+//    spans. Tracing is off by default; a disabled span
+//    costs one relaxed load.
+//
+//    save() writes the spans in the Chrome trace event
+//    format (chrome://tracing, Perfetto).
+//---------------------------------------------------------
+
+class Trace {
+      static std::atomic<bool> _enabled;
+
+   public:
+      static bool enabled() { return _enabled.load(std::memory_order_relaxed); }
+      static void setEnabled(bool val);
+      static qint64 now();
+      static void record(const char* name, qint64 begin, qint64 end);
+      static bool save(const QString& path);
+      };
+
+//---------------------------------------------------------
+//   TraceSpan
+//    records its lifetime; name must be a string
+//    literal
+//---------------------------------------------------------
+
+class TraceSpan {
+      const char* _name;
+      qint64 _begin;
+
+   public:
+      TraceSpan(const char* name) : _name(0), _begin(0) {
+            if (Trace::enabled()) {
+                  _name  = name;
+                  _begin = Trace::now();
+                  }
+            }
+      ~TraceSpan() {
+            if (_name)
+                  Trace::record(_name, _begin, Trace::now());
+            }
+      };
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b)  TRACE_CONCAT2(a, b)
+
+//---------------------------------------------------------
+//   TRACE
+//    trace the rest of the enclosing block
+//---------------------------------------------------------
+
+#define TRACE(name) Ms::TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+
+}     // namespace Ms
+#endif
+
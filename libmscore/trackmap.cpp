@@ -0,0 +1,197 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtCore/qalgorithms.h>
+#include "trackmap.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   popCount
+//    qPopulationCount() needs Qt 5.2,
+//    qCountTrailingZeroBits() Qt 5.3
+//---------------------------------------------------------
+
+static inline int popCount(quint64 bits)
+      {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+      return qPopulationCount(bits);
+#else
+      int n = 0;
+      for (; bits; bits &= bits - 1)
+            ++n;
+      return n;
+#endif
+      }
+
+//---------------------------------------------------------
+//   trailingZeros
+//    bits must not be 0
+//---------------------------------------------------------
+
+static inline int trailingZeros(quint64 bits)
+      {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 3, 0)
+      return qCountTrailingZeroBits(bits);
+#else
+      int n = 0;
+      while (!(bits & 1)) {
+            bits >>= 1;
+            ++n;
+            }
+      return n;
+#endif
+      }
+
+//---------------------------------------------------------
+//   TrackMap
+//---------------------------------------------------------
+
+TrackMap::TrackMap(int tracks)
+   : _size(tracks), _bits(words(tracks), 0)
+      {
+      }
+
+//---------------------------------------------------------
+//   index
+//    position of an occupied track in _elements
+//---------------------------------------------------------
+
+int TrackMap::index(int track) const
+      {
+      int w = track >> 6;
+      int n = 0;
+      for (int i = 0; i < w; ++i)
+            n += popCount(_bits[i]);
+      quint64 mask = (quint64(1) << (track & 63)) - 1;
+      return n + popCount(_bits[w] & mask);
+      }
+
+//---------------------------------------------------------
+//   set
+//    a null element clears the track
+//---------------------------------------------------------
+
+void TrackMap::set(int track, Element* e)
+      {
+      Q_ASSERT(track >= 0 && track < _size);
+      int idx = index(track);
+      if (testBit(track)) {
+            if (e)
+                  _elements[idx] = e;
+            else {
+                  _elements.erase(_elements.begin() + idx);
+                  _bits[track >> 6] &= ~(quint64(1) << (track & 63));
+                  }
+            }
+      else if (e) {
+            _elements.insert(_elements.begin() + idx, e);
+            _bits[track >> 6] |= quint64(1) << (track & 63);
+            }
+      }
+
+//---------------------------------------------------------
+//   insert
+//    insert n empty tracks before track
+//---------------------------------------------------------
+
+void TrackMap::insert(int track, int n)
+      {
+      std::vector<quint64> bits(words(_size + n), 0);
+      for (int t = nextTrack(0); t != -1; t = nextTrack(t + 1)) {
+            int nt = t >= track ? t + n : t;
+            bits[nt >> 6] |= quint64(1) << (nt & 63);
+            }
+      _bits.swap(bits);
+      _size += n;
+      }
+
+//---------------------------------------------------------
+//   remove
+//    remove n tracks starting with track
+//---------------------------------------------------------
+
+void TrackMap::remove(int track, int n)
+      {
+      std::vector<quint64> bits(words(_size - n), 0);
+      std::vector<Element*> elements;
+      elements.reserve(_elements.size());
+      int idx = 0;
+      for (int t = nextTrack(0); t != -1; t = nextTrack(t + 1), ++idx) {
+            if (t >= track && t < track + n)
+                  continue;
+            int nt = t >= track ? t - n : t;
+            bits[nt >> 6] |= quint64(1) << (nt & 63);
+            elements.push_back(_elements[idx]);
+            }
+      _bits.swap(bits);
+      _elements.swap(elements);
+      _size -= n;
+      }
+
+//---------------------------------------------------------
+//   swap
+//---------------------------------------------------------
+
+void TrackMap::swap(int track1, int track2)
+      {
+      Element* e1 = value(track1);
+      Element* e2 = value(track2);
+      set(track1, e2);
+      set(track2, e1);
+      }
+
+//---------------------------------------------------------
+//   clear
+//    remove all elements, keep the number of tracks
+//---------------------------------------------------------
+
+void TrackMap::clear()
+      {
+      _elements.clear();
+      std::fill(_bits.begin(), _bits.end(), 0);
+      }
+
+//---------------------------------------------------------
+//   nextTrack
+//    return first occupied track >= track or -1
+//---------------------------------------------------------
+
+int TrackMap::nextTrack(int track) const
+      {
+      if (track < 0)
+            track = 0;
+      if (track >= _size)
+            return -1;
+      int w = track >> 6;
+      quint64 bits = _bits[w] & (~quint64(0) << (track & 63));
+      for (;;) {
+            if (bits)
+                  return (w << 6) + trailingZeros(bits);
+            if (++w >= int(_bits.size()))
+                  return -1;
+            bits = _bits[w];
+            }
+      }
+
+//---------------------------------------------------------
+//   memoryUsage
+//    approximate heap usage in bytes
+//---------------------------------------------------------
+
+size_t TrackMap::memoryUsage() const
+      {
+      return _bits.capacity() * sizeof(quint64) + _elements.capacity() * sizeof(Element*);
+      }
+
+}     // namespace Ms
+
@@ -0,0 +1,72 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __TRACKMAP_H__
+#define __TRACKMAP_H__
+
+namespace Ms {
+
+class Element;
+
+//---------------------------------------------------------
+//   TrackMap
+//    sparse per track element storage of a Segment
+//
+//    Only occupied tracks are stored, in track order.
+//    A bitmap of occupied tracks maps a track to its
+//    position in the element vector with a population
+//    count, so lookup stays O(tracks / 64).
+//    Iteration with begin()/end() visits occupied tracks
+//    only; nextTrack() skips empty tracks.
+//---------------------------------------------------------
+
+class TrackMap {
+      int _size;                          ///< number of tracks (staves * VOICES)
+      std::vector<quint64> _bits;         ///< occupied tracks
+      std::vector<Element*> _elements;    ///< elements of occupied tracks
+
+      static int words(int tracks)  { return (tracks + 63) / 64; }
+      bool testBit(int track) const { return (_bits[track >> 6] >> (track & 63)) & 1; }
+      int index(int track) const;
+
+   public:
+      TrackMap(int tracks = 0);
+
+      int size() const              { return _size;                 }
+      int count() const             { return int(_elements.size()); }
+      bool isEmpty() const          { return _elements.empty();     }
+      bool contains(int track) const {
+            return track >= 0 && track < _size && testBit(track);
+            }
+      Element* value(int track) const {
+            return contains(track) ? _elements[index(track)] : 0;
+            }
+      Element* at(int track) const  { return value(track);          }
+      Element* operator[](int track) const { return value(track);   }
+
+      void set(int track, Element*);
+      void insert(int track, int n);
+      void remove(int track, int n);
+      void swap(int track1, int track2);
+      void clear();
+
+      int nextTrack(int track) const;
+
+      std::vector<Element*>::const_iterator begin() const { return _elements.begin(); }
+      std::vector<Element*>::const_iterator end() const   { return _elements.end();   }
+
+      size_t memoryUsage() const;
+      };
+
+}     // namespace Ms
+#endif
+
@@ -77,6 +77,8 @@ namespace Ms {
 
 extern Measure* tick2measure(int tick);
 
+static const int MERGE_WINDOW = 16;   // commands searched back for coalescing
+
 //---------------------------------------------------------
 //   updateNoteLines
 //    compute line position of note heads after
@@ -164,6 +166,55 @@ void UndoCommand::unwind()
             }
       }
 
+//---------------------------------------------------------
+//   elementStates
+//    enter the elements added or removed by the command;
+//    removed is true for an element not in the score after
+//    the command was done (or undone). Children are
+//    visited in the order they are executed, so an element
+//    removed and added again ends up as not removed.
+//---------------------------------------------------------
+
+void UndoCommand::elementStates(QHash<Element*, bool>* removed, bool undone) const
+      {
+      int n = childList.size();
+      for (int i = 0; i < n; ++i)
+            childList[undone ? n - 1 - i : i]->elementStates(removed, undone);
+      }
+
+//---------------------------------------------------------
+//   ownedElements
+//    the elements not in the score while the command is
+//    done (or undone); they belong to the command and are
+//    deleted with it when it is dropped from the history
+//---------------------------------------------------------
+
+QList<Element*> UndoCommand::ownedElements(bool undone) const
+      {
+      QHash<Element*, bool> removed;
+      elementStates(&removed, undone);
+      QList<Element*> l;
+      for (auto i = removed.constBegin(); i != removed.constEnd(); ++i) {
+            if (i.value())
+                  l.append(i.key());
+            }
+      return l;
+      }
+
+//---------------------------------------------------------
+//   memoryUsage
+//    approximate heap usage in bytes; commands holding
+//    more than a few pointers of state override this
+//---------------------------------------------------------
+
+size_t UndoCommand::memoryUsage() const
+      {
+      size_t n = sizeof(UndoCommand) + 4 * sizeof(void*) + childList.size() * sizeof(UndoCommand*);
+      foreach(const UndoCommand* c, childList)
+            n += c->memoryUsage();
+      return n;
+      }
+
 //---------------------------------------------------------
 //   UndoStack
 //---------------------------------------------------------
@@ -173,6 +224,7 @@ UndoStack::UndoStack()
       curCmd   = 0;
       curIdx   = 0;
       cleanIdx = 0;
+      _memory  = 0;
       }
 
 //---------------------------------------------------------
@@ -213,16 +265,80 @@ void UndoStack::endMacro(bool rollback)
       if (rollback)
             delete curCmd;
       else {
-            while (list.size() > curIdx) {
-                  UndoCommand* cmd = list.takeLast();
-                  delete cmd;
-                  }
+            while (list.size() > curIdx)
+                  removeLast();
+            size_t n = curCmd->memoryUsage() + elementMemory(curCmd->ownedElements(false));
             list.append(curCmd);
+            sizes.append(n);
+            _memory += n;
             ++curIdx;
+            compact();
+            if (MScore::debugMode)
+                  qDebug("UndoStack %p: %d commands, about %zu bytes", this, list.size(), _memory);
             }
       curCmd = 0;
       }
 
+//---------------------------------------------------------
+//   countElement
+//---------------------------------------------------------
+
+static void countElement(void* data, Element*)
+      {
+      ++*static_cast<int*>(data);
+      }
+
+//---------------------------------------------------------
+//   elementMemory
+//    approximate size of elements owned by a command,
+//    including their children
+//---------------------------------------------------------
+
+size_t UndoStack::elementMemory(const QList<Element*>& el)
+      {
+      int n = 0;
+      foreach(Element* e, el)
+            e->scanElements(&n, countElement, true);
+      return n * sizeof(Element);
+      }
+
+//---------------------------------------------------------
+//   removeLast
+//    remove the last redo command and the elements it
+//    added
+//---------------------------------------------------------
+
+void UndoStack::removeLast()
+      {
+      UndoCommand* cmd = list.takeLast();
+      qDeleteAll(cmd->ownedElements(true));
+      delete cmd;
+      _memory -= sizes.takeLast();
+      }
+
+//---------------------------------------------------------
+//   compact
+//    drop the oldest commands and the elements they
+//    removed until the history fits into
+//    MScore::undoMemoryBudget; the last command is always
+//    kept
+//---------------------------------------------------------
+
+void UndoStack::compact()
+      {
+      if (MScore::undoMemoryBudget == 0)
+            return;
+      while (_memory > MScore::undoMemoryBudget && curIdx > 1) {
+            UndoCommand* cmd = list.takeFirst();
+            qDeleteAll(cmd->ownedElements(false));
+            delete cmd;
+            _memory -= sizes.takeFirst();
+            --curIdx;
+            if (cleanIdx >= 0)
+                  --cleanIdx;       // -1: the clean state cannot be reached anymore
+            }
+      }
+
 //---------------------------------------------------------
 //   push
 //---------------------------------------------------------
@@ -246,18 +362,52 @@ void UndoStack::push(UndoCommand* cmd)
             qDebug("UndoStack::push <%s> %p", cmd->name(), cmd);
             }
 #endif
+      UndoCommand* c = mergeTarget(cmd);
+      if (c) {
+            c->mergeWith(cmd);
+            delete cmd;
+            return;
+            }
       curCmd->appendChild(cmd);
       cmd->redo();
       }
 
+//---------------------------------------------------------
+//   mergeTarget
+//    find a command at the end of the current macro cmd
+//    can be coalesced with; only the first one keeps the
+//    state to restore on undo
+//---------------------------------------------------------
+
+UndoCommand* UndoStack::mergeTarget(const UndoCommand* cmd) const
+      {
+      if (cmd->mergeId() == -1)
+            return 0;
+      int n = curCmd->childCount();
+      for (int i = n - 1; i >= 0 && i >= n - MERGE_WINDOW; --i) {
+            UndoCommand* c = curCmd->child(i);
+            if (c->mergeId() != cmd->mergeId())
+                  break;
+            if (c->canMergeWith(cmd))
+                  return c;
+            }
+      return 0;
+      }
+
 //---------------------------------------------------------
 //   push1
 //---------------------------------------------------------
 
 void UndoStack::push1(UndoCommand* cmd)
       {
-      if (curCmd)
-            curCmd->appendChild(cmd);
+      if (curCmd) {
+            // cmd is already applied; a merge target restores
+            // an older state
+            if (mergeTarget(cmd))
+                  delete cmd;
+            else
+                  curCmd->appendChild(cmd);
+            }
       else
             qDebug("UndoStack:push1(): no active command, UndoStack %p", this);
       }
@@ -326,6 +476,12 @@ SaveState::SaveState(Score* s)
       redoSelection  = score->selection();
       }
 
+size_t SaveState::memoryUsage() const
+      {
+      return sizeof(SaveState)
+         + (undoSelection.elements().size() + redoSelection.elements().size()) * sizeof(Element*);
+      }
+
 void SaveState::undo()
       {
       redoInputState = score->inputState();
@@ -1523,6 +1679,16 @@ void RemovePart::redo()
       part->score()->removePart(part);
       }
 
+//---------------------------------------------------------
+//   RemovePart::memoryUsage
+//    the part is owned by the command while it is done
+//---------------------------------------------------------
+
+size_t RemovePart::memoryUsage() const
+      {
+      return sizeof(RemovePart) + sizeof(Part);
+      }
+
 //---------------------------------------------------------
 //   InsertStaff
 //---------------------------------------------------------
@@ -1563,6 +1729,15 @@ void RemoveStaff::redo()
       staff->score()->removeStaff(staff);
       }
 
+//---------------------------------------------------------
+//   RemoveStaff::memoryUsage
+//---------------------------------------------------------
+
+size_t RemoveStaff::memoryUsage() const
+      {
+      return sizeof(RemoveStaff) + sizeof(Staff);
+      }
+
 //---------------------------------------------------------
 //   InsertMStaff
 //---------------------------------------------------------
@@ -1605,6 +1780,15 @@ void RemoveMStaff::redo()
       measure->removeMStaff(mstaff, idx);
       }
 
+//---------------------------------------------------------
+//   RemoveMStaff::memoryUsage
+//---------------------------------------------------------
+
+size_t RemoveMStaff::memoryUsage() const
+      {
+      return sizeof(RemoveMStaff) + sizeof(MStaff);
+      }
+
 //---------------------------------------------------------
 //   InsertMeasure
 //---------------------------------------------------------
@@ -1692,6 +1876,18 @@ ChangeElement::ChangeElement(Element* oe, Element* ne)
       newElement = ne;
       }
 
+//---------------------------------------------------------
+//   elementStates
+//    flip() swaps the elements, newElement is never in
+//    the score
+//---------------------------------------------------------
+
+void ChangeElement::elementStates(QHash<Element*, bool>* removed, bool) const
+      {
+      (*removed)[oldElement] = false;
+      (*removed)[newElement] = true;
+      }
+
 void ChangeElement::flip()
       {
 //      qDebug("ChangeElement::flip() %s(%p) -> %s(%p) links %d",
@@ -2181,6 +2377,15 @@ void ChangeBracketSpan::flip()
       staff->score()->setLayoutAll(true);
       }
 
+//---------------------------------------------------------
+//   EditText::memoryUsage
+//---------------------------------------------------------
+
+size_t EditText::memoryUsage() const
+      {
+      return sizeof(EditText) + oldText.capacity() * sizeof(QChar);
+      }
+
 //---------------------------------------------------------
 //   EditText::undo
 //---------------------------------------------------------
@@ -2779,6 +2984,23 @@ void RemoveMeasures::redo()
       fm->score()->setLayoutAll(true);
       }
 
+//---------------------------------------------------------
+//   RemoveMeasures::memoryUsage
+//    the removed measures and their contents are owned by
+//    the command while it is done
+//---------------------------------------------------------
+
+size_t RemoveMeasures::memoryUsage() const
+      {
+      QList<Element*> ml;
+      for (MeasureBase* mb = fm; mb; mb = mb->next()) {
+            ml.append(mb);
+            if (mb == lm)
+                  break;
+            }
+      return sizeof(RemoveMeasures) + UndoStack::elementMemory(ml);
+      }
+
 //---------------------------------------------------------
 //   undo
 //    insert back measures
@@ -3173,6 +3395,32 @@ void ChangeProperty::flip()
       propertyStyle = ps;
       }
 
+//---------------------------------------------------------
+//   ChangeProperty::canMergeWith
+//---------------------------------------------------------
+
+bool ChangeProperty::canMergeWith(const UndoCommand* cmd) const
+      {
+      const ChangeProperty* cp = static_cast<const ChangeProperty*>(cmd);
+      return cp->element == element && cp->id == id;
+      }
+
+//---------------------------------------------------------
+//   ChangeProperty::mergeWith
+//    cmd sets the same property of the same element again;
+//    its value is applied directly, this command keeps the
+//    value to restore on undo
+//---------------------------------------------------------
+
+void ChangeProperty::mergeWith(UndoCommand* cmd)
+      {
+      ChangeProperty* cp = static_cast<ChangeProperty*>(cmd);
+      if (cp->propertyStyle == PropertyStyle::STYLED)
+            element->resetProperty(id);
+      else if (element->propertyStyle(id) != cp->propertyStyle || element->getProperty(id) != cp->property)
+            element->setProperty(id, cp->property);
+      }
+
 //---------------------------------------------------------
 //   ChangeMetaText::flip
 //---------------------------------------------------------
@@ -103,7 +103,14 @@ class UndoCommand {
       void appendChild(UndoCommand* cmd) { childList.append(cmd);       }
       UndoCommand* removeChild()         { return childList.takeLast(); }
       int childCount() const             { return childList.size();     }
+      UndoCommand* child(int idx) const  { return childList[idx];       }
       void unwind();
+      virtual size_t memoryUsage() const;
+      virtual void elementStates(QHash<Element*, bool>* removed, bool undone) const;
+      QList<Element*> ownedElements(bool undone) const;
+      virtual int mergeId() const        { return -1;    }   ///< commands of equal id >= 0 may merge
+      virtual bool canMergeWith(const UndoCommand*) const { return false; }
+      virtual void mergeWith(UndoCommand*) {}
 #ifdef DEBUG_UNDO
       virtual const char* name() const  { return "UndoCommand"; }
 #endif
@@ -116,10 +123,17 @@ class UndoCommand {
 class UndoStack {
       UndoCommand* curCmd;
       QList<UndoCommand*> list;
+      QList<size_t> sizes;          ///< memoryUsage() of the commands in list
+      size_t _memory;               ///< sum of sizes
       int curIdx;
       int cleanIdx;
 
+      void removeLast();
+      void compact();
+      UndoCommand* mergeTarget(const UndoCommand*) const;
+
    public:
+      static size_t elementMemory(const QList<Element*>&);
       UndoStack();
       ~UndoStack();
 
@@ -136,6 +150,8 @@ class UndoStack {
       UndoCommand* current() const  { return curCmd;               }
       void undo();
       void redo();
+      int count() const             { return list.size();          }
+      size_t memoryUsage() const    { return _memory;              }
       };
 
 //---------------------------------------------------------
@@ -153,6 +169,7 @@ class SaveState : public UndoCommand {
       SaveState(Score*);
       virtual void undo();
       virtual void redo();
+      virtual size_t memoryUsage() const;
       UNDO_NAME("SaveState");
       };
 
@@ -181,6 +198,7 @@ class RemovePart : public UndoCommand {
 
    public:
       RemovePart(Part*, int idx);
+      virtual size_t memoryUsage() const;
       virtual void undo();
       virtual void redo();
       UNDO_NAME("RemovePart");
@@ -211,6 +229,7 @@ class RemoveStaff : public UndoCommand {
 
    public:
       RemoveStaff(Staff*, int idx);
+      virtual size_t memoryUsage() const;
       virtual void undo();
       virtual void redo();
       UNDO_NAME("RemoveStaff");
@@ -243,6 +262,7 @@ class RemoveMStaff : public UndoCommand {
 
    public:
       RemoveMStaff(Measure*, MStaff*, int);
+      virtual size_t memoryUsage() const;
       virtual void undo();
       virtual void redo();
       UNDO_NAME("RemoveMStaff");
@@ -368,6 +388,7 @@ class ChangeElement : public UndoCommand {
 
    public:
       ChangeElement(Element* oldElement, Element* newElement);
+      virtual void elementStates(QHash<Element*, bool>* removed, bool undone) const;
       UNDO_NAME("ChangeElement");
       };
 
@@ -639,6 +660,7 @@ class AddElement : public UndoCommand {
       AddElement(Element*);
       virtual void undo();
       virtual void redo();
+      virtual void elementStates(QHash<Element*, bool>* removed, bool undone) const { (*removed)[element] = undone; }
 #ifdef DEBUG_UNDO
       virtual const char* name() const;
 #endif
@@ -655,6 +677,7 @@ class RemoveElement : public UndoCommand {
       RemoveElement(Element*);
       virtual void undo();
       virtual void redo();
+      virtual void elementStates(QHash<Element*, bool>* removed, bool undone) const { (*removed)[element] = !undone; }
 #ifdef DEBUG_UNDO
       virtual const char* name() const;
 #endif
@@ -689,6 +712,7 @@ class EditText : public UndoCommand {
       EditText(Text* t, const QString& ot, int l) : text(t), oldText(ot), undoLevel(l) {}
       virtual void undo();
       virtual void redo();
+      virtual size_t memoryUsage() const;
       UNDO_NAME("EditText");
       };
 
@@ -964,6 +988,7 @@ class RemoveMeasures : public UndoCommand {
 
    public:
       RemoveMeasures(Measure*, Measure*);
+      virtual size_t memoryUsage() const;
       virtual void undo();
       virtual void redo();
       UNDO_NAME("RemoveMeasures");
@@ -1239,6 +1264,9 @@ class ChangeProperty : public UndoCommand {
       ChangeProperty(Element* e, P_ID i, const QVariant& v, PropertyStyle ps = PropertyStyle::NOSTYLE)
          : element(e), id(i), property(v), propertyStyle(ps) {}
       P_ID getId() const  { return id; }
+      virtual int mergeId() const { return 0; }
+      virtual bool canMergeWith(const UndoCommand*) const;
+      virtual void mergeWith(UndoCommand*);
       UNDO_NAME("ChangeProperty");
       };
 
@@ -28,16 +28,16 @@ QString docName;
 
 int XmlReader::intAttribute(const char* s, int _default) const
       {
-      if (attributes().hasAttribute(s))
+      if (attributes().hasAttribute(QLatin1String(s)))
             // return attributes().value(s).toString().toInt();
-            return attributes().value(s).toInt();
+            return attributes().value(QLatin1String(s)).toInt();
       else
             return _default;
       }
 
 int XmlReader::intAttribute(const char* s) const
       {
-      return attributes().value(s).toInt();
+      return attributes().value(QLatin1String(s)).toInt();
       }
 
 //---------------------------------------------------------
@@ -46,13 +46,13 @@ int XmlReader::intAttribute(const char* s) const
 
 double XmlReader::doubleAttribute(const char* s) const
       {
-      return attributes().value(s).toDouble();
+      return attributes().value(QLatin1String(s)).toDouble();
       }
 
 double XmlReader::doubleAttribute(const char* s, double _default) const
       {
-      if (attributes().hasAttribute(s))
-            return attributes().value(s).toDouble();
+      if (attributes().hasAttribute(QLatin1String(s)))
+            return attributes().value(QLatin1String(s)).toDouble();
       else
             return _default;
       }
@@ -63,8 +63,8 @@ double XmlReader::doubleAttribute(const char* s, double _default) const
 
 QString XmlReader::attribute(const char* s, const QString& _default) const
       {
-      if (attributes().hasAttribute(s))
-            return attributes().value(s).toString();
+      if (attributes().hasAttribute(QLatin1String(s)))
+            return attributes().value(QLatin1String(s)).toString();
       else
             return _default;
       }
@@ -75,7 +75,65 @@ QString XmlReader::attribute(const char* s, const QString& _default) const
 
 bool XmlReader::hasAttribute(const char* s) const
       {
-      return attributes().hasAttribute(s);
+      return attributes().hasAttribute(QLatin1String(s));
+      }
+
+//---------------------------------------------------------
+//   readNumber
+//    readElementText() followed by a conversion, without
+//    copying the text of the usual single text node into a
+//    QString; nodes after the first text node are ignored
+//---------------------------------------------------------
+
+template <typename T, typename F>
+static T readNumber(XmlReader& e, F convert, bool* ok)
+      {
+      Q_ASSERT(e.isStartElement());
+      T val      = T();
+      bool found = false;
+      for (;;) {
+            switch (e.readNext()) {
+                  case XmlStreamReader::Characters:
+                        if (!found) {
+                              val   = convert(e.text(), ok);
+                              found = true;
+                              }
+                        break;
+                  case XmlStreamReader::EndElement:
+                        if (!found)
+                              val = convert(QStringRef(), ok);
+                        return val;
+                  case XmlStreamReader::Comment:
+                  case XmlStreamReader::ProcessingInstruction:
+                  case XmlStreamReader::EntityReference:
+                        break;
+                  case XmlStreamReader::StartElement:
+                        e.raiseError("Expected character data.");
+                        // fall through
+                  default:
+                        if (!found && ok)
+                              *ok = false;
+                        return val;
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   readInt
+//---------------------------------------------------------
+
+int XmlReader::readInt(bool* ok)
+      {
+      return readNumber<int>(*this, [](const QStringRef& s, bool* ok) { return s.toInt(ok); }, ok);
+      }
+
+//---------------------------------------------------------
+//   readDouble
+//---------------------------------------------------------
+
+double XmlReader::readDouble()
+      {
+      return readNumber<double>(*this, [](const QStringRef& s, bool* ok) { return s.toDouble(ok); }, 0);
       }
 
 //---------------------------------------------------------
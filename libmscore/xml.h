@@ -66,7 +66,7 @@ class XmlReader : public XmlStreamReader {
       void unknown() const;
 
       // attribute helper routines:
-      QString attribute(const char* s) const { return attributes().value(s).toString(); }
+      QString attribute(const char* s) const { return attributes().value(QLatin1String(s)).toString(); }
       QString attribute(const char* s, const QString&) const;
       int intAttribute(const char* s) const;
       int intAttribute(const char* s, int _default) const;
@@ -75,9 +75,9 @@ class XmlReader : public XmlStreamReader {
       bool hasAttribute(const char* s) const;
 
       // helper routines based on readElementText():
-      int readInt()         { return readElementText().toInt();    }
-      int readInt(bool* ok) { return readElementText().toInt(ok);  }
-      double readDouble()   { return readElementText().toDouble(); }
+      int readInt()         { return readInt(0);                    }
+      int readInt(bool* ok);
+      double readDouble();
       QPointF readPoint();
       QSizeF readSize();
       QRectF readRect();
@@ -31,6 +31,7 @@
 #include "musescore.h"
 #include "preferences.h"
 #include "seq.h"
+#include "synthesizer/msynthesizer.h"
 #include "alsamidi.h"
 #include "libmscore/utils.h"
 
@@ -54,6 +55,7 @@ AlsaDriver::AlsaDriver(QString s, unsigned rate,
       _nfrags      = nfrags;
       _stat        = -1;
       _play_nchan  = 2;
+      _xruns       = 0;
       }
 
 //---------------------------------------------------------
@@ -380,6 +382,7 @@ int AlsaDriver::recover()
       snd_pcm_status_t  *stat;
 
       snd_pcm_status_alloca (&stat);
+      ++_xruns;
 
       if ((err = snd_pcm_status (_play_handle, stat)) < 0) {
             qDebug("Alsa_driver: pcm_status(): %s",  snd_strerror (err));
@@ -677,6 +680,8 @@ void AlsaAudio::alsaLoop()
       alsa->pcmStart();
       int size = alsa->fsize();
       float buffer[size * 2];
+      AudioStats* stats = seq->synti()->stats();
+      int xruns = alsa->xruns();
       runAlsa = 2;
       while (runAlsa == 2) {
             seq->process(size, buffer);
@@ -690,6 +695,8 @@ void AlsaAudio::alsaLoop()
                   *rp++ = *sp++;
                   }
             alsa->write(size, l, r);
+            for (; xruns < alsa->xruns(); ++xruns)
+                  stats->xrun();
             }
       alsa->pcmStop();
       runAlsa = 0;
@@ -74,6 +74,7 @@ class AlsaDriver {
       int                    _stat;
       int                    _pcnt;
       bool                   _xrun;
+      int                    _xruns;            // number of recoveries
       clear_function         _clear_func;
       play_function          _play_func;
       bool                   mmappedInterface;
@@ -101,6 +102,7 @@ class AlsaDriver {
       snd_pcm_uframes_t fsize() const { return _frsize;      }
       unsigned int sampleRate() const { return _rate; }
       void write(int n, float* l, float* r);
+      int xruns() const               { return _xruns; }
       };
 
 //---------------------------------------------------------
@@ -0,0 +1,80 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "binaryreader.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   BinaryReader
+//---------------------------------------------------------
+
+BinaryReader::BinaryReader()
+      {
+      _file = 0;
+      _map  = 0;
+      _data = 0;
+      _size = 0;
+      _pos  = 0;
+      }
+
+BinaryReader::~BinaryReader()
+      {
+      close();
+      }
+
+//---------------------------------------------------------
+//   open
+//    make the contents of the open file f available;
+//    reading starts at the current position of f, which
+//    must stay open until close()
+//---------------------------------------------------------
+
+bool BinaryReader::open(QFile* f)
+      {
+      close();
+      qint64 start = f->pos();
+      _size = f->size();
+      _map  = _size > 0 ? f->map(0, _size) : 0;
+      if (_map) {
+            _file = f;
+            _data = _map;
+            }
+      else {
+            // not mappable (e.g. a resource): keep a copy
+            f->seek(0);
+            _buffer = f->readAll();
+            _size   = _buffer.size();
+            _data   = (const uchar*)_buffer.constData();
+            }
+      _pos = qMin(start, _size);
+      return _size > 0 || f->size() == 0;
+      }
+
+//---------------------------------------------------------
+//   close
+//---------------------------------------------------------
+
+void BinaryReader::close()
+      {
+      if (_map)
+            _file->unmap(_map);
+      _file = 0;
+      _map  = 0;
+      _buffer.clear();
+      _data = 0;
+      _size = 0;
+      _pos  = 0;
+      }
+
+}     // namespace Ms
+
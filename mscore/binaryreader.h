@@ -0,0 +1,101 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __BINARYREADER_H__
+#define __BINARYREADER_H__
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   BinaryReader
+//    reads binary files of other programs (Guitar Pro,
+//    Capella, Overture) from memory: the file is mapped,
+//    or read completely if it cannot be mapped. Fields are
+//    decoded little endian without any device access.
+//---------------------------------------------------------
+
+class BinaryReader {
+      QFile* _file;
+      uchar* _map;
+      QByteArray _buffer;
+      const uchar* _data;
+      qint64 _size;
+      qint64 _pos;
+
+      Q_DISABLE_COPY(BinaryReader)
+
+   public:
+      BinaryReader();
+      ~BinaryReader();
+      bool open(QFile*);
+      void close();
+
+      const uchar* data() const { return _data; }
+      qint64 size() const       { return _size; }
+      qint64 pos() const        { return _pos;  }
+      bool atEnd() const        { return _pos >= _size; }
+
+      //---------------------------------------------------
+      //   read
+      //    return number of bytes read
+      //---------------------------------------------------
+
+      qint64 read(void* p, qint64 len) {
+            if (len > _size - _pos)
+                  len = _size - _pos;
+            memcpy(p, _data + _pos, len);
+            _pos += len;
+            return len;
+            }
+
+      //---------------------------------------------------
+      //   take
+      //    return the next len bytes without copying them
+      //    or 0 if the file is too short
+      //---------------------------------------------------
+
+      const uchar* take(qint64 len) {
+            if (len > _size - _pos)
+                  return 0;
+            const uchar* p = _data + _pos;
+            _pos += len;
+            return p;
+            }
+
+      bool skip(qint64 len) {
+            if (len < 0)
+                  return false;
+            if (len > _size - _pos) {
+                  _pos = _size;
+                  return false;
+                  }
+            _pos += len;
+            return true;
+            }
+
+      //---------------------------------------------------
+      //   readLE
+      //    read a little endian value; false at end of file
+      //---------------------------------------------------
+
+      template<typename T> bool readLE(T* val) {
+            const uchar* p = take(sizeof(T));
+            if (!p)
+                  return false;
+            *val = qFromLittleEndian<T>(p);
+            return true;
+            }
+      };
+
+}     // namespace Ms
+#endif
+
@@ -1610,8 +1610,7 @@ void Capella::read(void* p, qint64 len)
       {
       if (len == 0)
             return;
-      qint64 rv = f->read((char*)p, len);
-      if (rv != len)
+      if (f.read(p, len) != len)
             throw CAP_EOF;
       curPos += len;
       }
@@ -1644,9 +1643,7 @@ char Capella::readChar()
 
 short Capella::readWord()
       {
-      short c;
-      read(&c, 2);
-      return c;
+      return readLE<qint16>();
       }
 
 //---------------------------------------------------------
@@ -1655,9 +1652,7 @@ short Capella::readWord()
 
 int Capella::readDWord()
       {
-      int c;
-      read(&c, 4);
-      return c;
+      return readLE<qint32>();
       }
 
 //---------------------------------------------------------
@@ -1666,9 +1661,7 @@ int Capella::readDWord()
 
 int Capella::readLong()
       {
-      int c;
-      read(&c, 4);
-      return c;
+      return readLE<qint32>();
       }
 
 //---------------------------------------------------------
@@ -1679,16 +1672,10 @@ unsigned Capella::readUnsigned()
       {
       unsigned char c;
       read(&c, 1);
-      if (c == 254) {
-            unsigned short s;
-            read(&s, 2);
-            return s;
-            }
-      else if (c == 255) {
-            unsigned s;
-            read(&s, 4);
-            return s;
-            }
+      if (c == 254)
+            return readLE<quint16>();
+      else if (c == 255)
+            return readLE<quint32>();
       else
             return c;
       }
@@ -1701,16 +1688,10 @@ int Capella::readInt()
       {
       char c;
       read(&c, 1);
-      if (c == -128) {
-            short s;
-            read(&s, 2);
-            return s;
-            }
-      else if (c == 127) {
-            int s;
-            read(&s, 4);
-            return s;
-            }
+      if (c == -128)
+            return readLE<qint16>();
+      else if (c == 127)
+            return readLE<qint32>();
       else
             return c;
       }
@@ -1843,8 +1824,7 @@ void Capella::readStaveLayout(CapStaffLayout* sl, int idx)
             default:
                   {
                   char lines[11];
-                  f->read(lines, 11);
-                  curPos += 11;
+                  read(lines, 11);
                   }
                   break;
             }
@@ -1877,16 +1857,14 @@ void Capella::readStaveLayout(CapStaffLayout* sl, int idx)
             Q_UNUSED(iMin);
             uchar n    = readByte();
             Q_ASSERT (n > 0 and iMin + n <= 128);
-            f->read(sl->soundMapIn, n);
-            curPos += n;
+            read(sl->soundMapIn, n);
             }
       if (sl->bSoundMapOut) {     // Umleitungstabelle für das Vorspielen
             unsigned char iMin = readByte();
             Q_UNUSED(iMin);
             unsigned char n    = readByte();
             Q_ASSERT (n > 0 and iMin + n <= 128);
-            f->read(sl->soundMapOut, n);
-            curPos += n;
+            read(sl->soundMapOut, n);
             }
       sl->sound  = readInt();
       sl->volume = readInt();
@@ -2266,7 +2244,7 @@ QPointF Capella::readPoint()
 
 void Capella::read(QFile* fp)
       {
-      f      = fp;
+      f.open(fp);
       curPos = 0;
 
       char signature[9];
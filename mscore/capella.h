@@ -23,6 +23,7 @@
 
 #include "globals.h"
 #include "libmscore/xml.h"
+#include "binaryreader.h"
 
 namespace Ms {
 
@@ -629,7 +630,7 @@ class Capella {
       static const char* errmsg[];
       int curPos;
 
-      QFile* f;
+      BinaryReader f;
       char* author;
       char* keywords;
       char* comment;
@@ -677,6 +678,19 @@ class Capella {
       void readStaveLayout(CapStaffLayout*, int);
       void readLayout();
 
+      //---------------------------------------------------
+      //   readLE
+      //    Capella files are little endian
+      //---------------------------------------------------
+
+      template<typename T> T readLE() {
+            T val;
+            if (!f.readLE(&val))
+                  throw CAP_EOF;
+            curPos += sizeof(T);
+            return val;
+            }
+
    public:
       enum CapellaError { CAP_NO_ERROR, CAP_BAD_SIG, CAP_EOF, CAP_BAD_VOICE_SIG,
             CAP_BAD_STAFF_SIG, CAP_BAD_SYSTEM_SIG
@@ -0,0 +1,213 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "config.h"
+#include "convertercache.h"
+
+namespace Ms {
+
+extern QString revision;
+
+static const char CACHE_MAGIC[4] = { 'M', 'S', 'C', 'C' };
+static const quint32 CACHE_VERSION = 1;
+
+//---------------------------------------------------------
+//   addFile
+//    add the contents of file path to the hash
+//---------------------------------------------------------
+
+static bool addFile(QCryptographicHash& h, const QString& path)
+      {
+      QFile f(path);
+      if (!f.open(QIODevice::ReadOnly))
+            return false;
+      uchar* data = f.map(0, f.size());
+      if (data) {
+            h.addData((const char*)data, f.size());
+            f.unmap(data);
+            }
+      else
+            h.addData(f.readAll());
+      return true;
+      }
+
+//---------------------------------------------------------
+//   setKey
+//    files are hashed by content, a missing file counts
+//    as empty; options are the settings which change the
+//    output. Return false if the score file cannot be read.
+//---------------------------------------------------------
+
+bool ConverterCache::setKey(const QString& scoreFile, const QString& outFile, const QStringList& files, const QStringList& options)
+      {
+      _key.clear();
+      QCryptographicHash h(QCryptographicHash::Sha1);
+      h.addData(QByteArray(VERSION));
+      h.addData(revision.toUtf8());
+      h.addData(QFileInfo(outFile).fileName().toUtf8());
+      if (!addFile(h, scoreFile))
+            return false;
+      foreach (const QString& file, files) {
+            h.addData(QByteArray(1, '\0'));
+            if (!file.isEmpty())
+                  addFile(h, file);
+            }
+      foreach (const QString& option, options) {
+            h.addData(QByteArray(1, '\0'));
+            h.addData(option.toUtf8());
+            }
+      _key = h.result().toHex();
+      return true;
+      }
+
+//---------------------------------------------------------
+//   entryPath
+//---------------------------------------------------------
+
+QString ConverterCache::entryPath() const
+      {
+      return _dir + "/" + QString::fromLatin1(_key) + ".mscc";
+      }
+
+//---------------------------------------------------------
+//   restore
+//    write the cached files to outDir; return false if
+//    there is no valid cache entry
+//---------------------------------------------------------
+
+bool ConverterCache::restore(const QDir& outDir) const
+      {
+      if (_key.isEmpty())
+            return false;
+      QFile f(entryPath());
+      if (!f.open(QIODevice::ReadOnly))
+            return false;
+      qint64 size = f.size();
+      const uchar* data = size >= 12 ? f.map(0, size) : 0;
+      if (!data)
+            return false;
+
+      const uchar* p   = data;
+      const uchar* end = data + size;
+      bool ok = memcmp(p, CACHE_MAGIC, 4) == 0 && qFromBigEndian<quint32>(p + 4) == CACHE_VERSION;
+      quint32 n = ok ? qFromBigEndian<quint32>(p + 8) : 0;
+      p += 12;
+
+      // validate the whole entry before writing any file
+      QList<QPair<QString, QByteArray> > files;
+      for (quint32 i = 0; ok && i < n; ++i) {
+            if (end - p < 12) {
+                  ok = false;
+                  break;
+                  }
+            quint32 nameSize = qFromBigEndian<quint32>(p);
+            quint64 dataSize = qFromBigEndian<quint64>(p + 4);
+            p += 12;
+            if (quint64(end - p) < quint64(nameSize) + dataSize) {
+                  ok = false;
+                  break;
+                  }
+            QString name = QString::fromUtf8((const char*)p, nameSize);
+            p += nameSize;
+            if (name.isEmpty() || name.contains('/') || name.contains('\\') || name.startsWith('.')) {
+                  ok = false;
+                  break;
+                  }
+            files.append(QPair<QString, QByteArray>(name, QByteArray::fromRawData((const char*)p, dataSize)));
+            p += dataSize;
+            }
+      if (ok && n > 0) {
+            for (const QPair<QString, QByteArray>& file : files) {
+                  QSaveFile of(outDir.filePath(file.first));
+                  if (!of.open(QIODevice::WriteOnly) || of.write(file.second) != file.second.size() || !of.commit()) {
+                        qDebug("ConverterCache: cannot write <%s>", qPrintable(of.fileName()));
+                        ok = false;
+                        break;
+                        }
+                  }
+            }
+      f.unmap((uchar*)data);
+      return ok && n > 0;
+      }
+
+//---------------------------------------------------------
+//   store
+//    copy the files written by a conversion from srcDir
+//    to outDir and add them to the cache
+//---------------------------------------------------------
+
+bool ConverterCache::store(const QDir& srcDir, const QDir& outDir) const
+      {
+      QStringList names = srcDir.entryList(QDir::Files, QDir::Name);
+      QByteArray entry;
+      QDataStream ds(&entry, QIODevice::WriteOnly);
+      ds.writeRawData(CACHE_MAGIC, 4);
+      ds << CACHE_VERSION << quint32(names.size());
+
+      bool rv = true;
+      for (const QString& name : names) {
+            QFile f(srcDir.filePath(name));
+            if (!f.open(QIODevice::ReadOnly)) {
+                  rv = false;
+                  continue;
+                  }
+            QByteArray data = f.readAll();
+            f.close();
+            QByteArray n = name.toUtf8();
+            ds << quint32(n.size()) << quint64(data.size());
+            ds.writeRawData(n.constData(), n.size());
+            ds.writeRawData(data.constData(), data.size());
+
+            QSaveFile of(outDir.filePath(name));
+            if (!of.open(QIODevice::WriteOnly) || of.write(data) != data.size() || !of.commit()) {
+                  qDebug("ConverterCache: cannot write <%s>", qPrintable(of.fileName()));
+                  rv = false;
+                  }
+            }
+      if (!rv || names.isEmpty() || _key.isEmpty())
+            return rv;
+
+      // a failure to update the cache is not an error of
+      // the conversion
+      QDir().mkpath(_dir);
+      QSaveFile cf(entryPath());
+      if (!cf.open(QIODevice::WriteOnly) || cf.write(entry) != entry.size() || !cf.commit())
+            qDebug("ConverterCache: cannot write <%s>", qPrintable(cf.fileName()));
+      else
+            evict();
+      return rv;
+      }
+
+//---------------------------------------------------------
+//   evict
+//    remove the oldest entries until all fit into
+//    _maxSize; the entry just stored is always kept
+//---------------------------------------------------------
+
+void ConverterCache::evict() const
+      {
+      if (_maxSize <= 0)
+            return;
+      QFileInfo current(entryPath());
+      qint64 size = current.size();
+      QFileInfoList l = QDir(_dir).entryInfoList(QStringList("*.mscc"), QDir::Files, QDir::Time);
+      foreach (const QFileInfo& fi, l) {
+            if (fi.absoluteFilePath() == current.absoluteFilePath())
+                  continue;
+            size += fi.size();
+            if (size > _maxSize && !QFile::remove(fi.absoluteFilePath()))
+                  qDebug("ConverterCache: cannot remove <%s>", qPrintable(fi.absoluteFilePath()));
+            }
+      }
+
+}     // namespace Ms
+
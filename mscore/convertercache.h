@@ -0,0 +1,70 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __CONVERTERCACHE_H__
+#define __CONVERTERCACHE_H__
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   ConverterCache
+//    cache for the output of command line conversions
+//    (mscore -o), so converting an unchanged score again
+//    needs neither parsing nor layout.
+//
+//    An entry is keyed by a hash of the score file, the
+//    other files read by the conversion (style, synthesizer
+//    settings), the output file name, the conversion options
+//    (resolution, export preferences, sound fonts) and the
+//    program revision. It holds all files written by one
+//    conversion (an image export writes a file per page) in
+//    one binary file:
+//
+//      char[4]  magic "MSCC"
+//      quint32  format version
+//      quint32  number of files
+//      per file:
+//         quint32  size of name, quint64 size of data,
+//         name (utf8), data
+//
+//    Integers are big endian; the entry is read memory
+//    mapped. When the entries exceed maxSize bytes, the
+//    oldest ones are removed.
+//
+//    Only conversions use the cache. Opening a score in the
+//    editor (MuseScore::openScore()) still parses and lays
+//    out the score; a cache of the score model and layout
+//    for that path does not exist.
+//---------------------------------------------------------
+
+class ConverterCache {
+      QString _dir;
+      qint64 _maxSize;              ///< 0: unlimited
+      QByteArray _key;
+
+      QString entryPath() const;
+      void evict() const;
+
+   public:
+      static const qint64 DEFAULT_MAX_SIZE = 512 * 1024 * 1024;
+
+      ConverterCache(const QString& dir, qint64 maxSize = DEFAULT_MAX_SIZE) : _dir(dir), _maxSize(maxSize) {}
+
+      bool setKey(const QString& scoreFile, const QString& outFile, const QStringList& files, const QStringList& options);
+      const QByteArray& key() const { return _key; }
+      bool restore(const QDir& outDir) const;
+      bool store(const QDir& srcDir, const QDir& outDir) const;
+      };
+
+}     // namespace Ms
+#endif
+
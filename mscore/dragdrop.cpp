@@ -56,6 +56,7 @@ void ScoreView::setViewRect(const QRectF& r)
       _matrix.setMatrix(_matrix.m11(), _matrix.m12(), _matrix.m13(), _matrix.m21(),
          _matrix.m22(), _matrix.m23(), _matrix.dx()+dx, _matrix.dy()+dy, _matrix.m33());
       imatrix = _matrix.inverted();
+      layoutVisiblePages();
       scroll(dx, dy, QRect(0, 0, width(), height()));
       emit offsetChanged(_matrix.dx(), _matrix.dy());
       }
@@ -364,6 +364,7 @@ void EditStyle::getValues()
 
       lstyle.set(ST_FixMeasureNumbers,       fixNumberMeasures->value());
       lstyle.set(ST_FixMeasureWidth,         fixMeasureWidth->isChecked());
+      lstyle.set(ST_optimalBreaks,           optimalBreaks->isChecked());
 
       lstyle.set(ST_SlurEndWidth,            Spatium(slurEndLineWidth->value()));
       lstyle.set(ST_SlurMidWidth,            Spatium(slurMidLineWidth->value()));
@@ -648,6 +649,7 @@ void EditStyle::setValues()
 
       fixNumberMeasures->setValue(lstyle.value(ST_FixMeasureNumbers).toInt());
       fixMeasureWidth->setChecked(lstyle.value(ST_FixMeasureWidth).toBool());
+      optimalBreaks->setChecked(lstyle.value(ST_optimalBreaks).toBool());
 
       slurEndLineWidth->setValue(lstyle.value(ST_SlurEndWidth).toDouble());
       slurMidLineWidth->setValue(lstyle.value(ST_SlurMidWidth).toDouble());
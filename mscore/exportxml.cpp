@@ -287,6 +287,9 @@ class ExportMusicXml {
       double getTenthsFromInches(double);
       double getTenthsFromDots(double);
       void keysigTimesig(Measure* m, int strack, int etrack);
+      void writePart(int idx);
+      void writeParts(QIODevice* dev);
+      static QByteArray partData(Score* score, int div, int idx);
 
 public:
       ExportMusicXml(Score* s)
@@ -1225,7 +1228,8 @@ static Volta* findVolta(Measure* m, bool left)
       {
       int stick = m->tick();
       int etick = m->tick() + m->ticks();
-      for (auto i : m->score()->spannerMap().findOverlapping(stick, etick)) {
+      const SpannerMap& sm = m->score()->spannerMap();
+      for (auto i : sm.overlapping(stick, etick)) {
             Spanner* el = i.value;
             if (el->type() != Element::VOLTA)
                   continue;
@@ -4063,290 +4067,268 @@ void ExportMusicXml::write(QIODevice* dev)
             }
       xml.etag();
 
-      staffCount = 0;
+      writeParts(dev);
 
-      for (int idx = 0; idx < il.size(); ++idx) {
-            Part* part = il.at(idx);
-            tick = 0;
-            xml.stag(QString("part id=\"P%1\"").arg(idx+1));
-
-            int staves = part->nstaves();
-            int strack = _score->staffIdx(part) * VOICES;
-            int etrack = strack + staves * VOICES;
-
-            trillStart.clear();
-            trillStop.clear();
+      xml.etag();
+      }
 
-            int measureNo = 1;          // number of next regular measure
-            int irregularMeasureNo = 1; // number of next irregular measure
-            int pickupMeasureNo = 1;    // number of next pickup measure
+//---------------------------------------------------------
+//   partData
+//    serialize part idx with an exporter of its own;
+//    runs on a worker thread
+//---------------------------------------------------------
 
-            FigBassMap fbMap;           // pending figure base extends
+QByteArray ExportMusicXml::partData(Score* score, int div, int idx)
+      {
+      ExportMusicXml em(score);
+      em.div = div;
+      for (int i = 0; i < MAX_BRACKETS; ++i)
+            em.bracket[i] = 0;
+      QBuffer buf;
+      buf.open(QIODevice::WriteOnly);
+      em.xml.setDevice(&buf);
+      em.xml.setCodec("UTF-8");
+      // a part is nested in score-partwise: open it for the
+      // indentation only and drop the tag
+      em.xml.stag("score-partwise");
+      em.xml.flush();
+      buf.buffer().clear();
+      buf.seek(0);
+      em.writePart(idx);
+      em.xml.flush();
+      return buf.buffer();
+      }
 
-            for (MeasureBase* mb = _score->measures()->first(); mb; mb = mb->next()) {
-                  if (mb->type() != Element::MEASURE)
-                        continue;
-                  Measure* m = static_cast<Measure*>(mb);
-                  const PageFormat* pf = _score->pageFormat();
+//---------------------------------------------------------
+//   writeParts
+//    parts are independent of each other: serialize them
+//    in parallel and write the results in order; at most
+//    one part per thread is held in memory. The workers
+//    only read the score; the spanner tree is built here
+//    so they do not rebuild it concurrently.
+//---------------------------------------------------------
 
+void ExportMusicXml::writeParts(QIODevice* dev)
+      {
+      xml.flush();
+      _score->spannerMap().build();
+      int parts  = _score->parts().size();
+      int window = qMax(1, QThread::idealThreadCount());
+      QList<QFuture<QByteArray> > pending;
+      for (int idx = 0; idx < parts || !pending.isEmpty();) {
+            if (idx < parts && pending.size() < window) {
+                  pending.append(QtConcurrent::run(&ExportMusicXml::partData, _score, div, idx));
+                  ++idx;
+                  }
+            else
+                  dev->write(pending.takeFirst().result());
+            }
+      }
 
-                  // pickup and other irregular measures need special care
-                  QString measureTag = "measure number=";
-                  if ((irregularMeasureNo + measureNo) == 2 && m->irregular()) {
-                        measureTag += "\"0\" implicit=\"yes\"";
-                        pickupMeasureNo++;
-                        }
-                  else if (m->irregular())
-                        measureTag += QString("\"X%1\" implicit=\"yes\"").arg(irregularMeasureNo++);
-                  else
-                        measureTag += QString("\"%1\"").arg(measureNo++);
-                  if (preferences.musicxmlExportLayout)
-                        measureTag += QString(" width=\"%1\"").arg(QString::number(m->bbox().width() / MScore::DPMM / millimeters * tenths,'f',2));
-                  xml.stag(measureTag);
-
-                  // Handle the <print> element.
-                  // When exporting layout and all breaks, a <print> with layout informations
-                  // is generated for the measure types TopSystem, NewSystem and newPage.
-                  // When exporting layout but only manual or no breaks, a <print> with
-                  // layout informations is generated only for the measure type TopSystem,
-                  // as it is assumed the system layout is broken by the importing application
-                  // anyway and is thus useless.
-
-                  int currentSystem = NoSystem;
-                  Measure* previousMeasure = 0;
-
-                  for (MeasureBase* currentMeasureB = m->prev(); currentMeasureB; currentMeasureB = currentMeasureB->prev()) {
-                        if (currentMeasureB->type() == Element::MEASURE) {
-                              previousMeasure = (Measure*) currentMeasureB;
-                              break;
-                              }
-                        }
+//---------------------------------------------------------
+//   writePart
+//---------------------------------------------------------
 
-                  if (!previousMeasure)
-                        currentSystem = TopSystem;
-                  else if (m->parent() && previousMeasure->parent()) {
-                        if (m->parent()->parent() != previousMeasure->parent()->parent())
-                              currentSystem = NewPage;
-                        else if (m->parent() != previousMeasure->parent())
-                              currentSystem = NewSystem;
-                        }
+void ExportMusicXml::writePart(int idx)
+      {
+      Part* part = _score->parts().at(idx);
+      int staffCount = _score->staffIdx(part);
+      tick = 0;
+      xml.stag(QString("part id=\"P%1\"").arg(idx+1));
 
-                  bool prevMeasLineBreak = false;
-                  bool prevMeasPageBreak = false;
-                  if (previousMeasure) {
-                        prevMeasLineBreak = previousMeasure->lineBreak();
-                        prevMeasPageBreak = previousMeasure->pageBreak();
-                        }
+      int staves = part->nstaves();
+      int strack = _score->staffIdx(part) * VOICES;
+      int etrack = strack + staves * VOICES;
 
-                  if (currentSystem != NoSystem) {
+      trillStart.clear();
+      trillStop.clear();
 
-                        // determine if a new-system or new-page is required
-                        QString newThing; // new-[system|page]="yes" or empty
-                        if (preferences.musicxmlExportBreaks == ALL_BREAKS) {
-                              if (currentSystem == NewSystem)
-                                    newThing = " new-system=\"yes\"";
-                              else if (currentSystem == NewPage)
-                                    newThing = " new-page=\"yes\"";
-                              }
-                        else if (preferences.musicxmlExportBreaks == MANUAL_BREAKS) {
-                              if (currentSystem == NewSystem && prevMeasLineBreak)
-                                    newThing = " new-system=\"yes\"";
-                              else if (currentSystem == NewPage && prevMeasPageBreak)
-                                    newThing = " new-page=\"yes\"";
-                              }
+      int measureNo = 1;          // number of next regular measure
+      int irregularMeasureNo = 1; // number of next irregular measure
+      int pickupMeasureNo = 1;    // number of next pickup measure
 
-                        // determine if layout information is required
-                        bool doLayout = false;
-                        if (preferences.musicxmlExportLayout) {
-                              if (currentSystem == TopSystem
-                                  || (preferences.musicxmlExportBreaks == ALL_BREAKS && newThing != "")) {
-                                    doLayout = true;
-                                    }
-                              }
+      FigBassMap fbMap;           // pending figure base extends
 
-                        if (doLayout) {
-                              xml.stag(QString("print%1").arg(newThing));
-                              const double pageWidth  = getTenthsFromInches(pf->size().width());
-                              const double lm = getTenthsFromInches(pf->oddLeftMargin());
-                              const double rm = getTenthsFromInches(pf->oddRightMargin());
-                              const double tm = getTenthsFromInches(pf->oddTopMargin());
-
-                              // System Layout
-                              // Put the system print suggestions only for the first part in a score...
-                              if (idx == 0) {
-                                    // Find the right margin of the system.
-                                    double systemLM = getTenthsFromDots(m->pagePos().x() - m->system()->page()->pagePos().x()) - lm;
-                                    double systemRM = pageWidth - rm - (getTenthsFromDots(m->system()->bbox().width()) + lm);
-
-                                    xml.stag("system-layout");
-                                    xml.stag("system-margins");
-                                    xml.tag("left-margin", QString("%1").arg(QString::number(systemLM,'f',2)));
-                                    xml.tag("right-margin", QString("%1").arg(QString::number(systemRM,'f',2)) );
-                                    xml.etag();
-
-                                    if (currentSystem == NewPage || currentSystem == TopSystem) {
-                                          const double topSysDist = getTenthsFromDots(m->pagePos().y()) - tm;
-                                          xml.tag("top-system-distance", QString("%1").arg(QString::number(topSysDist,'f',2)) );
-                                          }
-                                    if (currentSystem == NewSystem) {
-                                          // see System::layout2() for the factor 2 * score()->spatium()
-                                          const double sysDist = getTenthsFromDots(m->pagePos().y()
-                                                                                   - previousMeasure->pagePos().y()
-                                                                                   - previousMeasure->bbox().height()
-                                                                                   + 2 * score()->spatium()
-                                                                                   );
-                                          xml.tag("system-distance",
-                                                  QString("%1").arg(QString::number(sysDist,'f',2)));
-                                          }
-
-                                    xml.etag();
-                                    }
-
-                              // Staff layout elements.
-                              for (int staffIdx = (staffCount == 0) ? 1 : 0; staffIdx < staves; staffIdx++) {
-                                    xml.stag(QString("staff-layout number=\"%1\"").arg(staffIdx + 1));
-                                    const double staffDist =
-                                          getTenthsFromDots(mb->system()->staff(staffCount + staffIdx - 1)->distanceDown());
-                                    xml.tag("staff-distance", QString("%1").arg(QString::number(staffDist,'f',2)));
-                                    xml.etag();
-                                    }
+      for (MeasureBase* mb = _score->measures()->first(); mb; mb = mb->next()) {
+            if (mb->type() != Element::MEASURE)
+                  continue;
+            Measure* m = static_cast<Measure*>(mb);
+            const PageFormat* pf = _score->pageFormat();
 
-                              xml.etag();
-                              }
-                        else {
-                              // !doLayout
-                              if (newThing != "")
-                                    xml.tagE(QString("print%1").arg(newThing));
-                              }
 
-                        } // if (currentSystem ...
+            // pickup and other irregular measures need special care
+            QString measureTag = "measure number=";
+            if ((irregularMeasureNo + measureNo) == 2 && m->irregular()) {
+                  measureTag += "\"0\" implicit=\"yes\"";
+                  pickupMeasureNo++;
+                  }
+            else if (m->irregular())
+                  measureTag += QString("\"X%1\" implicit=\"yes\"").arg(irregularMeasureNo++);
+            else
+                  measureTag += QString("\"%1\"").arg(measureNo++);
+            if (preferences.musicxmlExportLayout)
+                  measureTag += QString(" width=\"%1\"").arg(QString::number(m->bbox().width() / MScore::DPMM / millimeters * tenths,'f',2));
+            xml.stag(measureTag);
+
+            // Handle the <print> element.
+            // When exporting layout and all breaks, a <print> with layout informations
+            // is generated for the measure types TopSystem, NewSystem and newPage.
+            // When exporting layout but only manual or no breaks, a <print> with
+            // layout informations is generated only for the measure type TopSystem,
+            // as it is assumed the system layout is broken by the importing application
+            // anyway and is thus useless.
+
+            int currentSystem = NoSystem;
+            Measure* previousMeasure = 0;
+
+            for (MeasureBase* currentMeasureB = m->prev(); currentMeasureB; currentMeasureB = currentMeasureB->prev()) {
+                  if (currentMeasureB->type() == Element::MEASURE) {
+                        previousMeasure = (Measure*) currentMeasureB;
+                        break;
+                        }
+                  }
 
-                  attr.start();
+            if (!previousMeasure)
+                  currentSystem = TopSystem;
+            else if (m->parent() && previousMeasure->parent()) {
+                  if (m->parent()->parent() != previousMeasure->parent()->parent())
+                        currentSystem = NewPage;
+                  else if (m->parent() != previousMeasure->parent())
+                        currentSystem = NewSystem;
+                  }
 
-                  findTrills(m, strack, etrack, trillStart, trillStop);
+            bool prevMeasLineBreak = false;
+            bool prevMeasPageBreak = false;
+            if (previousMeasure) {
+                  prevMeasLineBreak = previousMeasure->lineBreak();
+                  prevMeasPageBreak = previousMeasure->pageBreak();
+                  }
 
-                  // barline left must be the first element in a measure
-                  barlineLeft(m);
+            if (currentSystem != NoSystem) {
 
-                  // output attributes with the first actual measure (pickup or regular)
-                  if ((irregularMeasureNo + measureNo + pickupMeasureNo) == 4) {
-                        attr.doAttr(xml, true);
-                        xml.tag("divisions", MScore::division / div);
+                  // determine if a new-system or new-page is required
+                  QString newThing; // new-[system|page]="yes" or empty
+                  if (preferences.musicxmlExportBreaks == ALL_BREAKS) {
+                        if (currentSystem == NewSystem)
+                              newThing = " new-system=\"yes\"";
+                        else if (currentSystem == NewPage)
+                              newThing = " new-page=\"yes\"";
                         }
-                  // output attributes at start of measure: key, time
-                  keysigTimesig(m, strack, etrack);
-                  // output attributes with the first actual measure (pickup or regular) only
-                  if ((irregularMeasureNo + measureNo + pickupMeasureNo) == 4) {
-                        if (staves > 1)
-                              xml.tag("staves", staves);
+                  else if (preferences.musicxmlExportBreaks == MANUAL_BREAKS) {
+                        if (currentSystem == NewSystem && prevMeasLineBreak)
+                              newThing = " new-system=\"yes\"";
+                        else if (currentSystem == NewPage && prevMeasPageBreak)
+                              newThing = " new-page=\"yes\"";
                         }
 
-                  {
-                  Measure* prevMeasure = m->prevMeasure();
-                  int tick             = m->tick();
-                  Segment* cs1;
-                  Segment* cs2         = m->findSegment(Segment::SegClef, tick);
-                  Segment* seg         = 0;
-
-                  if (prevMeasure)
-                        cs1 = prevMeasure->findSegment(Segment::SegClef,  tick);
-                  else
-                        cs1 = 0;
-
-                  if (cs1 && cs2)         // should not happen
-                        seg = cs2;
-                  else if (cs1)
-                        seg = cs1;
-                  else
-                        seg = cs2;
-
-                  // output attribute at start of measure: clef
-                  if (seg) {
-                        for (int st = strack; st < etrack; st += VOICES) {
-                              // sstaff - xml staff number, counting from 1 for this
-                              // instrument
-                              // special number 0 -> dont show staff number in
-                              // xml output (because there is only one staff)
-
-                              int sstaff = (staves > 1) ? st - strack + VOICES : 0;
-                              sstaff /= VOICES;
-
-                              Clef* cle = static_cast<Clef*>(seg->element(st));
-                              if (cle) {
-                                    ClefType ct = cle->clefType();
-                                    clefDebug("exportxml: clef at start measure ti=%d ct=%d gen=%d", tick, int(ct), cle->generated());
-                                    // output only clef changes, not generated clefs at line beginning
-                                    // exception: at tick=0, export clef anyway
-                                    if (tick == 0 || !cle->generated()) {
-                                          clefDebug("exportxml: clef exported");
-                                          clef(sstaff, ct);
-                                          }
-                                    else {
-                                          clefDebug("exportxml: clef not exported");
-                                          }
-                                    }
+                  // determine if layout information is required
+                  bool doLayout = false;
+                  if (preferences.musicxmlExportLayout) {
+                        if (currentSystem == TopSystem
+                            || (preferences.musicxmlExportBreaks == ALL_BREAKS && newThing != "")) {
+                              doLayout = true;
                               }
                         }
-                  }
 
-                  // output attributes with the first actual measure (pickup or regular) only
-                  if ((irregularMeasureNo + measureNo + pickupMeasureNo) == 4) {
-                        const Instrument* instrument = part->instr();
-
-                        // staff details
-                        // TODO: decide how to handle linked regular / TAB staff
-                        //       currently exported as a two staff part ...
-                        for (int i = 0; i < staves; i++) {
-                              Staff* st = part->staff(i);
-                              if (st->lines() != 5) {
-                                    if (staves > 1)
-                                          xml.stag(QString("staff-details number=\"%1\"").arg(i+1));
-                                    else
-                                          xml.stag("staff-details");
-                                    xml.tag("staff-lines", st->lines());
-                                    if (st->isTabStaff() && instrument->stringData()) {
-                                          QList<int> l = instrument->stringData()->stringList();
-                                          for (int i = 0; i < l.size(); i++) {
-                                                char step  = ' ';
-                                                int alter  = 0;
-                                                int octave = 0;
-                                                midipitch2xml(l.at(i), step, alter, octave);
-                                                xml.stag(QString("staff-tuning line=\"%1\"").arg(i+1));
-                                                xml.tag("tuning-step", QString("%1").arg(step));
-                                                if (alter)
-                                                      xml.tag("tuning-alter", alter);
-                                                xml.tag("tuning-octave", octave);
-                                                xml.etag();
-                                                }
-                                          }
-                                    xml.etag();
+                  if (doLayout) {
+                        xml.stag(QString("print%1").arg(newThing));
+                        const double pageWidth  = getTenthsFromInches(pf->size().width());
+                        const double lm = getTenthsFromInches(pf->oddLeftMargin());
+                        const double rm = getTenthsFromInches(pf->oddRightMargin());
+                        const double tm = getTenthsFromInches(pf->oddTopMargin());
+
+                        // System Layout
+                        // Put the system print suggestions only for the first part in a score...
+                        if (idx == 0) {
+                              // Find the right margin of the system.
+                              double systemLM = getTenthsFromDots(m->pagePos().x() - m->system()->page()->pagePos().x()) - lm;
+                              double systemRM = pageWidth - rm - (getTenthsFromDots(m->system()->bbox().width()) + lm);
+
+                              xml.stag("system-layout");
+                              xml.stag("system-margins");
+                              xml.tag("left-margin", QString("%1").arg(QString::number(systemLM,'f',2)));
+                              xml.tag("right-margin", QString("%1").arg(QString::number(systemRM,'f',2)) );
+                              xml.etag();
+
+                              if (currentSystem == NewPage || currentSystem == TopSystem) {
+                                    const double topSysDist = getTenthsFromDots(m->pagePos().y()) - tm;
+                                    xml.tag("top-system-distance", QString("%1").arg(QString::number(topSysDist,'f',2)) );
                                     }
+                              if (currentSystem == NewSystem) {
+                                    // see System::layout2() for the factor 2 * score()->spatium()
+                                    const double sysDist = getTenthsFromDots(m->pagePos().y()
+                                                                             - previousMeasure->pagePos().y()
+                                                                             - previousMeasure->bbox().height()
+                                                                             + 2 * score()->spatium()
+                                                                             );
+                                    xml.tag("system-distance",
+                                            QString("%1").arg(QString::number(sysDist,'f',2)));
+                                    }
+
+                              xml.etag();
                               }
-                        // instrument details
-                        if (instrument->transpose().chromatic) {
-                              xml.stag("transpose");
-                              xml.tag("diatonic",  instrument->transpose().diatonic % 7);
-                              xml.tag("chromatic", instrument->transpose().chromatic % 12);
-                              int octaveChange = instrument->transpose().chromatic / 12;
-                              if (octaveChange != 0)
-                                    xml.tag("octave-change", octaveChange);
+
+                        // Staff layout elements.
+                        for (int staffIdx = (staffCount == 0) ? 1 : 0; staffIdx < staves; staffIdx++) {
+                              xml.stag(QString("staff-layout number=\"%1\"").arg(staffIdx + 1));
+                              const double staffDist =
+                                    getTenthsFromDots(mb->system()->staff(staffCount + staffIdx - 1)->distanceDown());
+                              xml.tag("staff-distance", QString("%1").arg(QString::number(staffDist,'f',2)));
                               xml.etag();
                               }
+
+                        xml.etag();
+                        }
+                  else {
+                        // !doLayout
+                        if (newThing != "")
+                              xml.tagE(QString("print%1").arg(newThing));
                         }
 
-                  // output attribute at start of measure: measure-style
-                  measureStyle(xml, attr, m);
+                  } // if (currentSystem ...
 
-                  // set of spanners already stopped in this measure
-                  // required to prevent multiple spanner stops for the same spanner
-                  QSet<const Spanner*> spannersStopped;
+            attr.start();
 
-                  // MuseScore limitation: repeats are always in the first part
-                  // and are implicitly placed at either measure start or stop
-                  if (idx == 0)
-                        repeatAtMeasureStart(xml, attr, m, strack, etrack, strack);
+            findTrills(m, strack, etrack, trillStart, trillStop);
 
-                  for (int st = strack; st < etrack; ++st) {
+            // barline left must be the first element in a measure
+            barlineLeft(m);
+
+            // output attributes with the first actual measure (pickup or regular)
+            if ((irregularMeasureNo + measureNo + pickupMeasureNo) == 4) {
+                  attr.doAttr(xml, true);
+                  xml.tag("divisions", MScore::division / div);
+                  }
+            // output attributes at start of measure: key, time
+            keysigTimesig(m, strack, etrack);
+            // output attributes with the first actual measure (pickup or regular) only
+            if ((irregularMeasureNo + measureNo + pickupMeasureNo) == 4) {
+                  if (staves > 1)
+                        xml.tag("staves", staves);
+                  }
+
+            {
+            Measure* prevMeasure = m->prevMeasure();
+            int tick             = m->tick();
+            Segment* cs1;
+            Segment* cs2         = m->findSegment(Segment::SegClef, tick);
+            Segment* seg         = 0;
+
+            if (prevMeasure)
+                  cs1 = prevMeasure->findSegment(Segment::SegClef,  tick);
+            else
+                  cs1 = 0;
+
+            if (cs1 && cs2)         // should not happen
+                  seg = cs2;
+            else if (cs1)
+                  seg = cs1;
+            else
+                  seg = cs2;
+
+            // output attribute at start of measure: clef
+            if (seg) {
+                  for (int st = strack; st < etrack; st += VOICES) {
                         // sstaff - xml staff number, counting from 1 for this
                         // instrument
                         // special number 0 -> dont show staff number in
@@ -4354,135 +4336,215 @@ void ExportMusicXml::write(QIODevice* dev)
 
                         int sstaff = (staves > 1) ? st - strack + VOICES : 0;
                         sstaff /= VOICES;
-                        for (Segment* seg = m->first(); seg; seg = seg->next()) {
-                              Element* el = seg->element(st);
-                              if (!el) {
-                                    continue;
-                                    }
-                              // must ignore start repeat to prevent spurious backup/forward
-                              if (el->type() == Element::BAR_LINE && static_cast<BarLine*>(el)->barLineType() == START_REPEAT)
-                                    continue;
 
-                              // generate backup or forward to the start time of the element
-                              // but not for breath, which has the same start time as the
-                              // previous note, while tick is already at the end of that note
-                              if (tick != seg->tick()) {
-                                    attr.doAttr(xml, false);
-                                    if (el->type() != Element::BREATH)
-                                          moveToTick(seg->tick());
+                        Clef* cle = static_cast<Clef*>(seg->element(st));
+                        if (cle) {
+                              ClefType ct = cle->clefType();
+                              clefDebug("exportxml: clef at start measure ti=%d ct=%d gen=%d", tick, int(ct), cle->generated());
+                              // output only clef changes, not generated clefs at line beginning
+                              // exception: at tick=0, export clef anyway
+                              if (tick == 0 || !cle->generated()) {
+                                    clefDebug("exportxml: clef exported");
+                                    clef(sstaff, ct);
+                                    }
+                              else {
+                                    clefDebug("exportxml: clef not exported");
                                     }
+                              }
+                        }
+                  }
+            }
 
-                              // handle annotations and spanners (directions attached to this note or rest)
-                              if (el->isChordRest()) {
-                                    attr.doAttr(xml, false);
-                                    annotations(this, xml, strack, etrack, st, sstaff, seg);
-                                    // look for more harmony
-                                    for (Segment* seg1 = seg->next(); seg1; seg1 = seg1->next()) {
-                                          if(seg1->isChordRest()) {
-                                                Element* el1 = seg1->element(st);
-                                                if (el1) // found a ChordRest, next harmony will be attach to this one
-                                                      break;
-                                                foreach (Element* annot, seg1->annotations()) {
-                                                      if(annot->type() == Element::HARMONY && annot->track() == st)
-                                                            harmony(static_cast<Harmony*>(annot), 0, (seg1->tick() - seg->tick()) / div);
-                                                      }
-                                                }
+            // output attributes with the first actual measure (pickup or regular) only
+            if ((irregularMeasureNo + measureNo + pickupMeasureNo) == 4) {
+                  const Instrument* instrument = part->instr();
+
+                  // staff details
+                  // TODO: decide how to handle linked regular / TAB staff
+                  //       currently exported as a two staff part ...
+                  for (int i = 0; i < staves; i++) {
+                        Staff* st = part->staff(i);
+                        if (st->lines() != 5) {
+                              if (staves > 1)
+                                    xml.stag(QString("staff-details number=\"%1\"").arg(i+1));
+                              else
+                                    xml.stag("staff-details");
+                              xml.tag("staff-lines", st->lines());
+                              if (st->isTabStaff() && instrument->stringData()) {
+                                    QList<int> l = instrument->stringData()->stringList();
+                                    for (int i = 0; i < l.size(); i++) {
+                                          char step  = ' ';
+                                          int alter  = 0;
+                                          int octave = 0;
+                                          midipitch2xml(l.at(i), step, alter, octave);
+                                          xml.stag(QString("staff-tuning line=\"%1\"").arg(i+1));
+                                          xml.tag("tuning-step", QString("%1").arg(step));
+                                          if (alter)
+                                                xml.tag("tuning-alter", alter);
+                                          xml.tag("tuning-octave", octave);
+                                          xml.etag();
                                           }
-                                    figuredBass(xml, strack, etrack, st, static_cast<const ChordRest*>(el), fbMap);
-                                    spannerStart(this, strack, etrack, st, sstaff, seg);
                                     }
+                              xml.etag();
+                              }
+                        }
+                  // instrument details
+                  if (instrument->transpose().chromatic) {
+                        xml.stag("transpose");
+                        xml.tag("diatonic",  instrument->transpose().diatonic % 7);
+                        xml.tag("chromatic", instrument->transpose().chromatic % 12);
+                        int octaveChange = instrument->transpose().chromatic / 12;
+                        if (octaveChange != 0)
+                              xml.tag("octave-change", octaveChange);
+                        xml.etag();
+                        }
+                  }
 
-                              switch (el->type()) {
+            // output attribute at start of measure: measure-style
+            measureStyle(xml, attr, m);
+
+            // set of spanners already stopped in this measure
+            // required to prevent multiple spanner stops for the same spanner
+            QSet<const Spanner*> spannersStopped;
+
+            // MuseScore limitation: repeats are always in the first part
+            // and are implicitly placed at either measure start or stop
+            if (idx == 0)
+                  repeatAtMeasureStart(xml, attr, m, strack, etrack, strack);
+
+            for (int st = strack; st < etrack; ++st) {
+                  // sstaff - xml staff number, counting from 1 for this
+                  // instrument
+                  // special number 0 -> dont show staff number in
+                  // xml output (because there is only one staff)
+
+                  int sstaff = (staves > 1) ? st - strack + VOICES : 0;
+                  sstaff /= VOICES;
+                  for (Segment* seg = m->first(); seg; seg = seg->next()) {
+                        Element* el = seg->element(st);
+                        if (!el) {
+                              continue;
+                              }
+                        // must ignore start repeat to prevent spurious backup/forward
+                        if (el->type() == Element::BAR_LINE && static_cast<BarLine*>(el)->barLineType() == START_REPEAT)
+                              continue;
+
+                        // generate backup or forward to the start time of the element
+                        // but not for breath, which has the same start time as the
+                        // previous note, while tick is already at the end of that note
+                        if (tick != seg->tick()) {
+                              attr.doAttr(xml, false);
+                              if (el->type() != Element::BREATH)
+                                    moveToTick(seg->tick());
+                              }
 
-                                    case Element::CLEF:
-                                          {
-                                          // output only clef changes, not generated clefs
-                                          // at line beginning
-                                          // also ignore clefs at the start of a measure,
-                                          // these have already been output
-                                          // also ignore clefs at the end of a measure
-                                          //
-                                          ClefType ct = ((Clef*)el)->clefType();
-                                          int ti = seg->tick();
-                                          clefDebug("exportxml: clef in measure ti=%d ct=%d gen=%d", ti, ct, el->generated());
-                                          if (el->generated()) {
-                                                clefDebug("exportxml: generated clef not exported");
+                        // handle annotations and spanners (directions attached to this note or rest)
+                        if (el->isChordRest()) {
+                              attr.doAttr(xml, false);
+                              annotations(this, xml, strack, etrack, st, sstaff, seg);
+                              // look for more harmony
+                              for (Segment* seg1 = seg->next(); seg1; seg1 = seg1->next()) {
+                                    if(seg1->isChordRest()) {
+                                          Element* el1 = seg1->element(st);
+                                          if (el1) // found a ChordRest, next harmony will be attach to this one
                                                 break;
-                                                }
-                                          if (!el->generated() && ti != m->tick() && ti != m->endTick())
-                                                clef(sstaff, ct);
-                                          else {
-                                                clefDebug("exportxml: clef not exported");
+                                          foreach (Element* annot, seg1->annotations()) {
+                                                if(annot->type() == Element::HARMONY && annot->track() == st)
+                                                      harmony(static_cast<Harmony*>(annot), 0, (seg1->tick() - seg->tick()) / div);
                                                 }
                                           }
-                                          break;
+                                    }
+                              figuredBass(xml, strack, etrack, st, static_cast<const ChordRest*>(el), fbMap);
+                              spannerStart(this, strack, etrack, st, sstaff, seg);
+                              }
 
-                                    case Element::KEYSIG:
-                                          // ignore
+                        switch (el->type()) {
+
+                              case Element::CLEF:
+                                    {
+                                    // output only clef changes, not generated clefs
+                                    // at line beginning
+                                    // also ignore clefs at the start of a measure,
+                                    // these have already been output
+                                    // also ignore clefs at the end of a measure
+                                    //
+                                    ClefType ct = ((Clef*)el)->clefType();
+                                    int ti = seg->tick();
+                                    clefDebug("exportxml: clef in measure ti=%d ct=%d gen=%d", ti, ct, el->generated());
+                                    if (el->generated()) {
+                                          clefDebug("exportxml: generated clef not exported");
                                           break;
+                                          }
+                                    if (!el->generated() && ti != m->tick() && ti != m->endTick())
+                                          clef(sstaff, ct);
+                                    else {
+                                          clefDebug("exportxml: clef not exported");
+                                          }
+                                    }
+                                    break;
 
-                                    case Element::TIMESIG:
-                                          // ignore
-                                          break;
+                              case Element::KEYSIG:
+                                    // ignore
+                                    break;
 
-                                    case Element::CHORD:
-                                          {
-                                          Chord* c                 = static_cast<Chord*>(el);
-                                          const QList<Lyrics*>* ll = &c->lyricsList();
-                                          for (Chord* g : c->graceNotes()) {
-                                                chord(g, sstaff, ll, part->instr()->useDrumset());
-                                                }
-                                          chord(c, sstaff, ll, part->instr()->useDrumset());
-                                          break;
+                              case Element::TIMESIG:
+                                    // ignore
+                                    break;
+
+                              case Element::CHORD:
+                                    {
+                                    Chord* c                 = static_cast<Chord*>(el);
+                                    const QList<Lyrics*>* ll = &c->lyricsList();
+                                    for (Chord* g : c->graceNotes()) {
+                                          chord(g, sstaff, ll, part->instr()->useDrumset());
                                           }
-                                    case Element::REST:
-                                          rest((Rest*)el, sstaff);
-                                          break;
+                                    chord(c, sstaff, ll, part->instr()->useDrumset());
+                                    break;
+                                    }
+                              case Element::REST:
+                                    rest((Rest*)el, sstaff);
+                                    break;
 
-                                    case Element::BAR_LINE:
-                                          // Following must be enforced (ref MusicXML barline.dtd):
-                                          // If location is left, it should be the first element in the measure;
-                                          // if location is right, it should be the last element.
-                                          // implementation note: START_REPEAT already written by barlineLeft()
-                                          // any bars left should be "middle"
-                                          // TODO: print barline only if middle
-                                          // if (el->subtype() != START_REPEAT)
-                                          //       bar((BarLine*) el);
-                                          break;
-                                    case Element::BREATH:
-                                          // ignore, already exported as note articulation
-                                          break;
+                              case Element::BAR_LINE:
+                                    // Following must be enforced (ref MusicXML barline.dtd):
+                                    // If location is left, it should be the first element in the measure;
+                                    // if location is right, it should be the last element.
+                                    // implementation note: START_REPEAT already written by barlineLeft()
+                                    // any bars left should be "middle"
+                                    // TODO: print barline only if middle
+                                    // if (el->subtype() != START_REPEAT)
+                                    //       bar((BarLine*) el);
+                                    break;
+                              case Element::BREATH:
+                                    // ignore, already exported as note articulation
+                                    break;
 
-                                    default:
-                                          qDebug("ExportMusicXml::write unknown segment type %s", el->name());
-                                          break;
-                                    }
+                              default:
+                                    qDebug("ExportMusicXml::write unknown segment type %s", el->name());
+                                    break;
+                              }
 
-                              // handle annotations and spanners (directions attached to this note or rest)
-                              if (el->isChordRest()) {
-                                    int spannerStaff = (st / VOICES) * VOICES;
-                                    spannerStop(this, spannerStaff, tick, sstaff, spannersStopped);
-                                    }
+                        // handle annotations and spanners (directions attached to this note or rest)
+                        if (el->isChordRest()) {
+                              int spannerStaff = (st / VOICES) * VOICES;
+                              spannerStop(this, spannerStaff, tick, sstaff, spannersStopped);
+                              }
 
-                              } // for (Segment* seg = ...
-                        attr.stop(xml);
-                        } // for (int st = ...
-                  // move to end of measure (in case of incomplete last voice)
+                        } // for (Segment* seg = ...
+                  attr.stop(xml);
+                  } // for (int st = ...
+            // move to end of measure (in case of incomplete last voice)
 #ifdef DEBUG_TICK
-                  qDebug("end of measure");
+            qDebug("end of measure");
 #endif
-                  moveToTick(m->tick() + m->ticks());
-                  if (idx == 0)
-                        repeatAtMeasureStop(xml, m, strack, etrack, strack);
-                  // note: don't use "m->repeatFlags() & RepeatEnd" here, because more
-                  // barline types need to be handled besides repeat end ("light-heavy")
-                  barlineRight(m);
-                  xml.etag();
-                  }
-            staffCount += staves;
+            moveToTick(m->tick() + m->ticks());
+            if (idx == 0)
+                  repeatAtMeasureStop(xml, m, strack, etrack, strack);
+            // note: don't use "m->repeatFlags() & RepeatEnd" here, because more
+            // barline types need to be handled besides repeat end ("light-heavy")
+            barlineRight(m);
             xml.etag();
             }
-
       xml.etag();
       }
 
@@ -4557,14 +4619,14 @@ bool saveMxl(Score* score, const QString& name)
       //uz.addDirectory("META-INF");
       uz.addFile("META-INF/container.xml", cbuf.data());
 
-      QBuffer dbuf;
-      dbuf.open(QIODevice::ReadWrite);
+      // the score is compressed while it is exported
+      QIODevice* dev = uz.openFile(fn);
       ExportMusicXml em(score);
-      em.write(&dbuf);
-      dbuf.seek(0);
-      uz.addFile(fn, dbuf.data());
+      em.write(dev);
+      dev->close();
+      delete dev;
       uz.close();
-      return true;
+      return uz.status() == MQZipWriter::NoError;
       }
 
 double ExportMusicXml::getTenthsFromInches(double inches)
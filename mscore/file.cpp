@@ -313,6 +313,7 @@ Score* MuseScore::readScore(const QString& name)
             return 0;
 
       Score* score = new Score(MScore::baseStyle());  // start with built-in style
+      score->setProgressiveLayout(true);
       setMidiPrefOperations(name);
       Score::FileError rv = Ms::readScore(score, name, false);
       if (rv == Score::FILE_TOO_OLD || rv == Score::FILE_TOO_NEW) {
@@ -405,6 +406,7 @@ bool MuseScore::saveFile(Score* score)
             tab2->setTabText(idx, score->name());
       QString tmp = score->tmpName();
       if (!tmp.isEmpty()) {
+            autoSaveWatcher.waitForFinished();
             QFile f(tmp);
             if (!f.remove())
                   qDebug("cannot remove temporary file <%s>", qPrintable(f.fileName()));
@@ -1437,6 +1439,7 @@ void MuseScore::printFile()
       QPrintDialog pd(&printerDev, 0);
       if (!pd.exec())
             return;
+      cs->finishLayout();
       QPainter p(&printerDev);
       p.setRenderHint(QPainter::Antialiasing, true);
       p.setRenderHint(QPainter::TextAntialiasing, true);
@@ -1617,6 +1620,7 @@ bool MuseScore::exportParts()
 
 bool MuseScore::saveAs(Score* cs, bool saveCopy, const QString& path, const QString& ext)
       {
+      cs->finishLayout();     // exports need all pages
       bool rv = false;
       QString suffix = "." + ext;
       QString fn(path);
@@ -1721,6 +1725,7 @@ bool MuseScore::savePdf(const QString& saveName)
 
 bool MuseScore::savePdf(Score* cs, const QString& saveName)
       {
+      cs->finishLayout();
       QPrinter printerDev(QPrinter::HighResolution);
       const PageFormat* pf = cs->pageFormat();
       printerDev.setPaperSize(pf->size(), QPrinter::Inch);
@@ -2033,6 +2038,7 @@ bool MuseScore::savePng(Score* score, const QString& name)
 bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool transparent, double convDpi, QImage::Format format)
       {
       bool rv = true;
+      score->finishLayout();
       score->setPrinting(!screenshot);    // dont print page break symbols etc.
 
       QImage::Format f;
@@ -2120,6 +2126,76 @@ bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool
       return rv;
       }
 
+//---------------------------------------------------------
+//   benchmarkScore
+//    time layout, bsp tree rebuild, painting of all pages
+//    as in savePng() and pdf export; every step runs
+//    runs times, all times are in ms
+//---------------------------------------------------------
+
+QJsonObject MuseScore::benchmarkScore(Score* score, int runs)
+      {
+      QJsonArray layout, bsp, paint, pdf;
+      QVector<QJsonArray> paintPage;
+      QTemporaryDir tmpDir;
+      QString pdfName = QDir(tmpDir.path()).filePath("benchmark.pdf");
+      QElapsedTimer t;
+
+      for (int run = 0; run < runs; ++run) {
+            t.start();
+            score->doLayout();
+            score->finishLayout();
+            layout.append(t.nsecsElapsed() / 1e6);
+
+            const QList<Page*>& pl = score->pages();
+            t.start();
+            score->rebuildBspTree();
+            foreach (Page* page, pl)
+                  page->items(QPointF());
+            bsp.append(t.nsecsElapsed() / 1e6);
+
+            score->setPrinting(true);
+            paintPage.resize(pl.size());
+            double mag = converterDpi / MScore::DPI;
+            double total = 0.0;
+            for (int pageNumber = 0; pageNumber < pl.size(); ++pageNumber) {
+                  Page* page = pl.at(pageNumber);
+                  t.start();
+                  QRectF r = page->abbox();
+                  QImage printer(lrint(r.width() * mag), lrint(r.height() * mag), QImage::Format_ARGB32_Premultiplied);
+                  printer.fill(0);
+                  QPainter p(&printer);
+                  p.setRenderHint(QPainter::Antialiasing, true);
+                  p.setRenderHint(QPainter::TextAntialiasing, true);
+                  p.scale(mag, mag);
+                  paintElements(p, page->elements());
+                  p.end();
+                  double ms = t.nsecsElapsed() / 1e6;
+                  paintPage[pageNumber].append(ms);
+                  total += ms;
+                  }
+            score->setPrinting(false);
+            paint.append(total);
+
+            t.start();
+            if (tmpDir.isValid())
+                  savePdf(score, pdfName);
+            pdf.append(t.nsecsElapsed() / 1e6);
+            }
+
+      QJsonArray pages;
+      foreach (const QJsonArray& a, paintPage)
+            pages.append(a);
+      QJsonObject o;
+      o["pages"]     = score->pages().size();
+      o["layout"]    = layout;
+      o["bsp"]       = bsp;
+      o["paint"]     = paint;
+      o["paintPage"] = pages;
+      o["pdf"]       = pdf;
+      return o;
+      }
+
 //---------------------------------------------------------
 //   WallpaperPreview
 //---------------------------------------------------------
@@ -2220,6 +2296,7 @@ QString MuseScore::getWallpaper(const QString& caption)
 
 bool MuseScore::saveSvg(Score* score, const QString& saveName)
       {
+      score->finishLayout();
       SvgGenerator printer;
       printer.setResolution(converterDpi);
       QString title(score->metaTag("workTitle"));
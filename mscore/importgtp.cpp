@@ -95,9 +95,9 @@ GuitarPro::~GuitarPro()
 
 void GuitarPro::skip(qint64 len)
       {
-      char c;
-      while (len--)
-            read(&c, 1);
+      if (!f.skip(len))
+            throw GP_EOF;
+      curPos += len;
       }
 
 //---------------------------------------------------------
@@ -108,8 +108,8 @@ void GuitarPro::read(void* p, qint64 len)
       {
       if (len == 0)
             return;
-      qint64 rv = f->read((char*)p, len);
-      Q_ASSERT(rv == len);
+      if (f.read(p, len) != len)
+            throw GP_EOF;
       curPos += len;
       }
 
@@ -209,15 +209,10 @@ QString GuitarPro::readDelphiString()
 
 int GuitarPro::readInt()
       {
-      uchar x;
-      read(&x, 1);
-      int r = x;
-      read(&x, 1);
-      r += x << 8;
-      read(&x, 1);
-      r += x << 16;
-      read(&x, 1);
-      r += x << 24;
+      qint32 r;
+      if (!f.readLE(&r))
+            throw GP_EOF;
+      curPos += 4;
       return r;
       }
 
@@ -534,7 +529,7 @@ void GuitarPro::applyBeatEffects(Chord* chord, int beatEffect)
 
 void GuitarPro1::read(QFile* fp)
       {
-      f      = fp;
+      f.open(fp);
       curPos = 30;
 
       title  = readDelphiString();
@@ -724,7 +719,7 @@ void GuitarPro::setTempo(int tempo, Measure* measure)
 
 void GuitarPro2::read(QFile* fp)
       {
-      f      = fp;
+      f.open(fp);
       curPos = 30;
 
       title        = readDelphiString();
@@ -1280,7 +1275,7 @@ void GuitarPro1::readChord(Segment* seg, int track)
 
 void GuitarPro3::read(QFile* fp)
       {
-      f      = fp;
+      f.open(fp);
       curPos = 30;
 
       title        = readDelphiString();
@@ -2055,7 +2050,7 @@ void GuitarPro4::readChord(Segment* seg, int track)
 
 void GuitarPro4::read(QFile* fp)
       {
-      f      = fp;
+      f.open(fp);
       curPos = 30;
 
       readInfo();
@@ -3099,7 +3094,7 @@ void GuitarPro5::readMeasures()
 
 void GuitarPro5::read(QFile* fp)
       {
-      f = fp;
+      f.open(fp);
       readInfo();
       readLyrics();
       readPageSetup();
@@ -23,6 +23,7 @@
 
 #include "libmscore/mscore.h"
 #include "libmscore/fraction.h"
+#include "binaryreader.h"
 
 namespace Ms {
 
@@ -80,7 +81,7 @@ class GuitarPro {
       int key;
 
       Score* score;
-      QFile* f;
+      BinaryReader f;
       int curPos;
       int previousTempo;
 
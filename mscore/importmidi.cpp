@@ -144,24 +144,85 @@ bool noTooShortNotes(const std::multimap<int, MTrack> &tracks)
 #endif
 
 
+struct QuantizeTrack
+      {
+      MTrack *mtrack;
+      TrackOperations operations;
+      const TimeSigMap *sigmap;
+      ReducedFraction lastTick;
+      };
+
+static void quantizeTrack(QuantizeTrack &track)
+      {
+      TrackOperationsScope scope(track.operations);
+      MTrack &mtrack = *track.mtrack;
+      mtrack.tuplets = MidiTuplet::findAllTuplets(mtrack.chords, track.sigmap, track.lastTick);
+
+      Q_ASSERT_X(!doNotesOverlap(mtrack),
+                 "quantizeAllTracks",
+                 "There are overlapping notes of the same voice that is incorrect");
+
+      Quantize::quantizeChords(mtrack.chords, mtrack.tuplets, track.sigmap);
+      }
+
+// everything the quantization of a track depends on besides the MIDI file
+
+static QByteArray quantizationKey(const TrackOperations &operations)
+      {
+      QByteArray key;
+      QDataStream s(&key, QIODevice::WriteOnly);
+      s << preferences.shortestNote
+        << int(operations.quantize.value)
+        << operations.quantize.reduceToShorterNotesInBar
+        << operations.quantize.humanPerformance
+        << operations.tuplets.doSearch
+        << operations.tuplets.duplets
+        << operations.tuplets.triplets
+        << operations.tuplets.quadruplets
+        << operations.tuplets.quintuplets
+        << operations.tuplets.septuplets
+        << operations.tuplets.nonuplets
+        << operations.useMultipleVoices;
+      return key;
+      }
+
 void quantizeAllTracks(std::multimap<int, MTrack> &tracks,
                        TimeSigMap *sigmap,
-                       const ReducedFraction &lastTick)
+                       const ReducedFraction &lastTick,
+                       const QString &fileName)
       {
       auto &opers = preferences.midiImportOperations;
+      auto &midiData = opers.midiData();
+      QVector<QuantizeTrack> jobs;
+      QList<QByteArray> keys;
       for (auto &track: tracks) {
             MTrack &mtrack = track.second;
                         // pass current track index through MidiImportOperations
                         // for further usage
             opers.setCurrentTrack(mtrack.indexOfOperation);
             opers.adaptForPercussion(mtrack.indexOfOperation, mtrack.mtrack->drumTrack());
-            mtrack.tuplets = MidiTuplet::findAllTuplets(mtrack.chords, sigmap, lastTick);
-
-            Q_ASSERT_X(!doNotesOverlap(track.second),
-                       "quantizeAllTracks",
-                       "There are overlapping notes of the same voice that is incorrect");
-
-            Quantize::quantizeChords(mtrack.chords, mtrack.tuplets, sigmap);
+            const auto operations = opers.currentTrackOperations();
+            const QByteArray key = quantizationKey(operations);
+                        // reimport with other operations of other tracks:
+                        // the result of this track is still valid
+            const QuantizedTrack *cached = midiData.quantizedTrack(fileName, mtrack.indexOfOperation);
+            if (cached && cached->key == key) {
+                  mtrack.chords = cached->chords;
+                  mtrack.tuplets = cached->tuplets;
+                  continue;
+                  }
+            jobs.append({&mtrack, operations, sigmap, lastTick});
+            keys.append(key);
+            }
+                  // tracks don't share any data: tuplet search and quantization
+                  // of every track run in parallel, each with the operations
+                  // of its track, so the result doesn't depend on the order
+      QtConcurrent::blockingMap(jobs, quantizeTrack);
+
+      for (int i = 0; i != jobs.size(); ++i) {
+            const MTrack &mtrack = *jobs[i].mtrack;
+            midiData.setQuantizedTrack(fileName, mtrack.indexOfOperation,
+                                       {keys[i], mtrack.chords, mtrack.tuplets});
             }
       }
 
@@ -916,7 +977,7 @@ QList<TrackMeta> getTracksMeta(const QList<MTrack> &tracks,
       return tracksMeta;
       }
 
-void convertMidi(Score *score, const MidiFile *mf)
+void convertMidi(Score *score, const MidiFile *mf, const QString &fileName)
       {
       ReducedFraction lastTick;
       auto *sigmap = score->sigmap();
@@ -929,7 +990,7 @@ void convertMidi(Score *score, const MidiFile *mf)
       Q_ASSERT_X(!doNotesOverlap(tracks),
                  "convertMidi", "There are overlapping notes of the same voice that is incorrect");
 
-      quantizeAllTracks(tracks, sigmap, lastTick);
+      quantizeAllTracks(tracks, sigmap, lastTick, fileName);
 
       Q_ASSERT_X(!doNotesOverlap(tracks),
                  "convertMidi", "There are overlapping notes of the same voice that is incorrect");
@@ -1034,7 +1095,7 @@ Score::FileError importMidi(Score *score, const QString &name)
             midiData.setMidiFile(name, mf);
             }
 
-      convertMidi(score, midiData.midiFile(name));
+      convertMidi(score, midiData.midiFile(name), name);
 
       return Score::FILE_NO_ERROR;
       }
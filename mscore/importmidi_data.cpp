@@ -64,6 +64,7 @@ void MidiData::setSelectedRow(const QString &fileName, int row)
 void MidiData::setMidiFile(const QString &fileName, const MidiFile &midiFile)
       {
       data[fileName].midiFile = midiFile;
+      data[fileName].quantizedTracks.clear();
       }
 
 const MidiFile* MidiData::midiFile(const QString &fileName) const
@@ -74,6 +75,26 @@ const MidiFile* MidiData::midiFile(const QString &fileName) const
       return &(it.value().midiFile);
       }
 
+void MidiData::setQuantizedTrack(const QString &fileName, int trackIndex,
+                                 const QuantizedTrack &track)
+      {
+      const auto it = data.find(fileName);
+      if (it == data.end())
+            return;
+      it.value().quantizedTracks[trackIndex] = track;
+      }
+
+const QuantizedTrack* MidiData::quantizedTrack(const QString &fileName, int trackIndex) const
+      {
+      const auto it = data.find(fileName);
+      if (it == data.end())
+            return nullptr;
+      const auto tit = it.value().quantizedTracks.find(trackIndex);
+      if (tit == it.value().quantizedTracks.end())
+            return nullptr;
+      return &tit.value();
+      }
+
 void MidiData::addTrackLyrics(const QString &fileName,
                               const std::multimap<ReducedFraction, std::string> &trackLyrics)
       {
@@ -4,12 +4,23 @@
 #include "midi/midifile.h"
 #include "importmidi_fraction.h"
 #include "importmidi_inner.h"
+#include "importmidi_chord.h"
 
 
 namespace Ms {
 
 struct TrackData;
 
+      // chords and tuplets of a track after quantization;
+      // a reimport with the same key reuses them
+
+struct QuantizedTrack
+      {
+      QByteArray key;         // operations and preferences the result depends on
+      std::multimap<ReducedFraction, MidiChord> chords;
+      std::multimap<ReducedFraction, MidiTuplet::TupletData> tuplets;
+      };
+
 class MidiData
       {
    public:
@@ -24,6 +35,8 @@ class MidiData
       void setSelectedRow(const QString &fileName, int row);
       void setMidiFile(const QString &fileName, const MidiFile &midiFile);
       const MidiFile *midiFile(const QString &fileName) const;
+      void setQuantizedTrack(const QString &fileName, int trackIndex, const QuantizedTrack &track);
+      const QuantizedTrack *quantizedTrack(const QString &fileName, int trackIndex) const;
                   // lyrics
       void addTrackLyrics(const QString &fileName,
                           const std::multimap<ReducedFraction,  std::string> &trackLyrics);
@@ -42,6 +55,7 @@ class MidiData
             QList<std::multimap<ReducedFraction, std::string>> lyricTracks;
             int selectedRow = 0;
             MidiFile midiFile;
+            QMap<int, QuantizedTrack> quantizedTracks;      // <track index, track>
             QString charset = MidiCharset::defaultCharset();
             };
       QMap<QString, MidiDataStore> data;    // <file name, tracks data>
@@ -2,6 +2,7 @@
 #include "libmscore/mscore.h"
 
 #include <limits>
+#include <utility>
 
 
 namespace Ms {
@@ -81,17 +82,20 @@ namespace {
 
 int gcd(int a, int b)
       {
+      while (b != 0) {
 
-      Q_ASSERT_X(!isUnaryNegationOverflow(a),
-                 "ReducedFraction, gcd", "Unary negation overflow");
+            Q_ASSERT_X(!isRemainderOverflow(a, b),
+                       "ReducedFraction, gcd", "Remainder overflow");
 
-      if (b == 0)
-            return a < 0 ? -a : a;
+            const int tmp = a % b;
+            a = b;
+            b = tmp;
+            }
 
-      Q_ASSERT_X(!isRemainderOverflow(a, b),
-                 "ReducedFraction, gcd", "Remainder overflow");
+      Q_ASSERT_X(!isUnaryNegationOverflow(a),
+                 "ReducedFraction, gcd", "Unary negation overflow");
 
-      return gcd(b, a % b);
+      return a < 0 ? -a : a;
       }
 
 // least common multiple
@@ -108,6 +112,26 @@ unsigned lcm(int a, int b)
       return a * b / tmp;
       }
 
+// compare a/b with c/d: negative, zero or positive;
+// exact without any common denominator
+
+int compareFractions(int a, int b, int c, int d)
+      {
+      qint64 left = qint64(a) * d;
+      qint64 right = qint64(c) * b;
+      if ((b < 0) != (d < 0))
+            std::swap(left, right);
+      return (left < right) ? -1 : (left > right ? 1 : 0);
+      }
+
+// common denominator of the import: a whole note in MuseScore ticks
+// times 2520, the lcm of all tuplet numbers 2..9
+
+qint64 gridDenominator()
+      {
+      return qint64(MScore::division) * 4 * 2520;
+      }
+
 } // namespace
 
 //-----------------------------------------------------------------------------
@@ -116,6 +140,7 @@ unsigned lcm(int a, int b)
 ReducedFraction::ReducedFraction()
       : numerator_(0)
       , denominator_(1)
+      , gridTicks_(0)
       {
       }
 
@@ -123,12 +148,14 @@ ReducedFraction::ReducedFraction(int z, int n)
       : numerator_(z)
       , denominator_(n)
       {
+      updateGridTicks();
       }
 
 ReducedFraction::ReducedFraction(const Fraction &fraction)
       : numerator_(fraction.numerator())
       , denominator_(fraction.denominator())
       {
+      updateGridTicks();
       }
 
 ReducedFraction ReducedFraction::fromTicks(int ticks)
@@ -138,19 +165,19 @@ ReducedFraction ReducedFraction::fromTicks(int ticks)
 
 ReducedFraction ReducedFraction::reduced() const
       {
-      const int tmp = gcd(numerator_, denominator_);
-
-      Q_ASSERT_X(!isDivisionOverflow(numerator_, tmp),
-                 "ReducedFraction::reduced", "Division overflow");
-      Q_ASSERT_X(!isDivisionOverflow(denominator_, tmp),
-                 "ReducedFraction::reduced", "Division overflow");
-
-      return ReducedFraction(numerator_ / tmp, denominator_ / tmp);
+      ReducedFraction value = *this;
+      value.reduce();
+      return value;
       }
 
 ReducedFraction ReducedFraction::absValue() const
       {
-      return ReducedFraction(qAbs(numerator_), qAbs(denominator_));
+      ReducedFraction value = *this;
+      value.numerator_ = qAbs(numerator_);
+      value.denominator_ = qAbs(denominator_);
+      if (gridTicks_ != OFF_GRID)
+            value.gridTicks_ = qAbs(gridTicks_);
+      return value;
       }
 
 int ReducedFraction::ticks() const
@@ -189,6 +216,17 @@ void ReducedFraction::reduce()
       denominator_ /= tmp;
       }
 
+// value in grid ticks, or OFF_GRID if the denominator doesn't divide the grid
+
+void ReducedFraction::updateGridTicks()
+      {
+      const qint64 grid = gridDenominator();
+      if (denominator_ == 0 || grid % denominator_ != 0)
+            gridTicks_ = OFF_GRID;
+      else
+            gridTicks_ = numerator_ * (grid / denominator_);
+      }
+
 void ReducedFraction::preventOverflow()
       {
       static const int reduceLimit = 10000;
@@ -214,6 +252,19 @@ int fractionPart(int lcmPart, int numerator, int denominator)
 
 ReducedFraction& ReducedFraction::operator+=(const ReducedFraction& val)
       {
+      const bool bothOnGrid = onGrid(val);
+                  // values from ticks mostly have the same denominator
+      if (denominator_ == val.denominator_ && denominator_ > 0) {
+
+            Q_ASSERT_X(!isAdditionOverflow(numerator_, val.numerator_),
+                       "ReducedFraction::operator+=", "Addition overflow");
+
+            numerator_ += val.numerator_;
+            if (bothOnGrid)
+                  gridTicks_ += val.gridTicks_;
+            return *this;
+            }
+
       preventOverflow();
       ReducedFraction value = val;
       value.preventOverflow();
@@ -222,11 +273,28 @@ ReducedFraction& ReducedFraction::operator+=(const ReducedFraction& val)
       numerator_ = fractionPart(tmp, numerator_, denominator_)
                   + fractionPart(tmp, val.numerator_, val.denominator_);
       denominator_ = tmp;
+      if (bothOnGrid)
+            gridTicks_ += val.gridTicks_;
+      else
+            updateGridTicks();
       return *this;
       }
 
 ReducedFraction& ReducedFraction::operator-=(const ReducedFraction& val)
       {
+      const bool bothOnGrid = onGrid(val);
+                  // values from ticks mostly have the same denominator
+      if (denominator_ == val.denominator_ && denominator_ > 0) {
+
+            Q_ASSERT_X(!isSubtractionOverflow(numerator_, val.numerator_),
+                       "ReducedFraction::operator-=", "Subtraction overflow");
+
+            numerator_ -= val.numerator_;
+            if (bothOnGrid)
+                  gridTicks_ -= val.gridTicks_;
+            return *this;
+            }
+
       preventOverflow();
       ReducedFraction value = val;
       value.preventOverflow();
@@ -235,6 +303,10 @@ ReducedFraction& ReducedFraction::operator-=(const ReducedFraction& val)
       numerator_ = fractionPart(tmp, numerator_, denominator_)
                   - fractionPart(tmp, val.numerator_, val.denominator_);
       denominator_ = tmp;
+      if (bothOnGrid)
+            gridTicks_ -= val.gridTicks_;
+      else
+            updateGridTicks();
       return *this;
       }
 
@@ -251,6 +323,7 @@ ReducedFraction& ReducedFraction::operator*=(const ReducedFraction& val)
 
       numerator_ *= val.numerator_;
       denominator_ *= val.denominator_;
+      updateGridTicks();
       return *this;
       }
 
@@ -262,6 +335,8 @@ ReducedFraction& ReducedFraction::operator*=(int val)
                  "ReducedFraction::operator*=", "Multiplication overflow");
 
       numerator_ *= val;
+      if (gridTicks_ != OFF_GRID)
+            gridTicks_ *= val;
       return *this;
       }
 
@@ -278,6 +353,7 @@ ReducedFraction& ReducedFraction::operator/=(const ReducedFraction& val)
 
       numerator_ *= val.denominator_;
       denominator_  *= val.numerator_;
+      updateGridTicks();
       return *this;
       }
 
@@ -289,49 +365,15 @@ ReducedFraction& ReducedFraction::operator/=(int val)
                  "ReducedFraction::operator/=", "Multiplication overflow");
 
       denominator_ *= val;
+      updateGridTicks();
       return *this;
       }
 
-bool ReducedFraction::operator<(const ReducedFraction& val) const
-      {
-      const int v = lcm(denominator_, val.denominator_);
-      return fractionPart(v, numerator_, denominator_)
-                  < fractionPart(v, val.numerator_, val.denominator_);
-      }
-
-bool ReducedFraction::operator<=(const ReducedFraction& val) const
-      {
-      const int v = lcm(denominator_, val.denominator_);
-      return fractionPart(v, numerator_, denominator_)
-                  <= fractionPart(v, val.numerator_, val.denominator_);
-      }
-
-bool ReducedFraction::operator>(const ReducedFraction& val) const
-      {
-      const int v = lcm(denominator_, val.denominator_);
-      return fractionPart(v, numerator_, denominator_)
-                  > fractionPart(v, val.numerator_, val.denominator_);
-      }
-
-bool ReducedFraction::operator>=(const ReducedFraction& val) const
-      {
-      const int v = lcm(denominator_, val.denominator_);
-      return fractionPart(v, numerator_, denominator_)
-                  >= fractionPart(v, val.numerator_, val.denominator_);
-      }
-
-bool ReducedFraction::operator==(const ReducedFraction& val) const
-      {
-      const int v = lcm(denominator_, val.denominator_);
-      return fractionPart(v, numerator_, denominator_)
-                  == fractionPart(v, val.numerator_, val.denominator_);
-      }
+// exact comparison of values off the grid
 
-bool ReducedFraction::operator!=(const ReducedFraction& val) const
+int ReducedFraction::compare(const ReducedFraction& val) const
       {
-      const int v = lcm(denominator_, val.denominator_);
-      return fractionPart(v, numerator_, denominator_)
-                  != fractionPart(v, val.numerator_, val.denominator_);
+      return compareFractions(numerator_, denominator_, val.numerator_, val.denominator_);
       }
 
 
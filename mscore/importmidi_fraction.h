@@ -6,6 +6,13 @@
 
 namespace Ms {
 
+// Positions and durations of the import are kept as integer ticks on a
+// common grid (a whole note in MuseScore ticks times 2520, the lcm of
+// the tuplet numbers 2..9), so the chord and tuplet maps keyed by
+// ReducedFraction compare and add plain integers; numerator and
+// denominator are kept for the conversions at the edges of the import.
+// Values off the grid fall back to exact fraction arithmetic.
+
 class ReducedFraction
       {
    public:
@@ -37,18 +44,24 @@ class ReducedFraction
       ReducedFraction operator/(const ReducedFraction& v) const { return ReducedFraction(*this) /= v; }
       ReducedFraction operator/(int v)                    const { return ReducedFraction(*this) /= v; }
 
-      bool operator<(const ReducedFraction&) const;
-      bool operator<=(const ReducedFraction&) const;
-      bool operator>=(const ReducedFraction&) const;
-      bool operator>(const ReducedFraction&) const;
-      bool operator==(const ReducedFraction&) const;
-      bool operator!=(const ReducedFraction&) const;
+      bool operator<(const ReducedFraction& v)  const { return onGrid(v) ? gridTicks_ <  v.gridTicks_ : compare(v) <  0; }
+      bool operator<=(const ReducedFraction& v) const { return onGrid(v) ? gridTicks_ <= v.gridTicks_ : compare(v) <= 0; }
+      bool operator>=(const ReducedFraction& v) const { return onGrid(v) ? gridTicks_ >= v.gridTicks_ : compare(v) >= 0; }
+      bool operator>(const ReducedFraction& v)  const { return onGrid(v) ? gridTicks_ >  v.gridTicks_ : compare(v) >  0; }
+      bool operator==(const ReducedFraction& v) const { return onGrid(v) ? gridTicks_ == v.gridTicks_ : compare(v) == 0; }
+      bool operator!=(const ReducedFraction& v) const { return onGrid(v) ? gridTicks_ != v.gridTicks_ : compare(v) != 0; }
 
    private:
+      static const qint64 OFF_GRID = Q_INT64_C(-0x7fffffffffffffff) - 1;
+
+      bool onGrid(const ReducedFraction& v) const { return gridTicks_ != OFF_GRID && v.gridTicks_ != OFF_GRID; }
+      int compare(const ReducedFraction&) const;
       void preventOverflow();
+      void updateGridTicks();
 
       int numerator_;
       int denominator_;
+      qint64 gridTicks_;      // value in grid ticks, or OFF_GRID
       };
 
 ReducedFraction toMuseScoreTicks(int tick, int oldDivision);
@@ -3,6 +3,33 @@
 
 namespace Ms {
 
+struct ScopeOperations
+      {
+      bool active = false;
+      TrackOperations operations;
+      };
+
+static QThreadStorage<ScopeOperations> scopeOperations;
+
+TrackOperationsScope::TrackOperationsScope(const TrackOperations &operations)
+      {
+      ScopeOperations &scope = scopeOperations.localData();
+      scope.active = true;
+      scope.operations = operations;
+      }
+
+TrackOperationsScope::~TrackOperationsScope()
+      {
+      scopeOperations.localData().active = false;
+      }
+
+const TrackOperations *TrackOperationsScope::current()
+      {
+      if (!scopeOperations.hasLocalData() || !scopeOperations.localData().active)
+            return nullptr;
+      return &scopeOperations.localData().operations;
+      }
+
 bool MidiImportOperations::isValidIndex(int index) const
       {
       return index >= 0 && index < operations_.size();
@@ -35,6 +62,8 @@ void MidiImportOperations::setCurrentMidiFile(const QString &fileName)
 
 TrackOperations MidiImportOperations::currentTrackOperations() const
       {
+      if (const TrackOperations *operations = TrackOperationsScope::current())
+            return *operations;
       if (!isValidIndex(currentTrack_))
             return defaultOpers;
       return operations_[currentTrack_];
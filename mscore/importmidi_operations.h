@@ -117,6 +117,18 @@ class MidiImportOperations
       bool isValidIndex(int index) const;
       };
 
+      // while a scope exists, currentTrackOperations() returns its
+      // operations in the thread that created it;
+      // used for tracks that are processed in parallel
+
+class TrackOperationsScope
+      {
+   public:
+      explicit TrackOperationsScope(const TrackOperations &operations);
+      ~TrackOperationsScope();
+      static const TrackOperations *current();
+      };
+
 } // namespace Ms
 
 
@@ -661,25 +661,6 @@ int findAvailableVoice(
       return voice;
       }
 
-std::map<std::pair<const ReducedFraction, MidiChord> *, int>
-prepareUsedFirstChords(const std::vector<int> &selectedTuplets,
-                       const std::vector<TupletInfo> &tuplets)
-      {
-      std::map<std::pair<const ReducedFraction, MidiChord> *, int> usedFirstChords;
-      for (int i: selectedTuplets) {
-            if (tuplets[i].firstChordIndex != 0)
-                  continue;
-            const auto firstChord = tuplets[i].chords.begin();
-            const auto it = usedFirstChords.find(&*firstChord->second);
-            if (it != usedFirstChords.end())
-                  ++(it->second);
-            else
-                  usedFirstChords.insert({&*firstChord->second, 1});
-            }
-
-      return usedFirstChords;
-      }
-
 std::vector<int> findUnusedIndexes(const std::vector<int> &selectedTuplets)
       {
       std::vector<int> unusedIndexes;
@@ -736,19 +717,84 @@ void tryUpdateBestIndexes(
             }
       }
 
-std::map<int, std::vector<std::pair<ReducedFraction, ReducedFraction> > >
-prepareVoiceIntervals(
-            const std::vector<int> &selectedTuplets,
-            const std::vector<std::pair<ReducedFraction, ReducedFraction> > &tupletIntervals)
+      // nodes of the combination search in one bar
+
+struct SearchNodes
       {
+      int count;
+      int limit;
+      bool isLimitReached;
+      };
+
+      // selected tuplets of the combination search; voice intervals
+      // and used first chords are updated when a tuplet is selected
+      // or deselected instead of being rebuilt at every search level
+
+class SelectedTuplets
+      {
+   public:
+      SelectedTuplets(const std::vector<TupletInfo> &tuplets,
+                      const std::vector<std::pair<ReducedFraction, ReducedFraction> > &tupletIntervals)
+            : tuplets_(tuplets)
+            , tupletIntervals_(tupletIntervals)
+            {
+            }
+
+      const std::vector<int>& indexes() const
+            {
+            return indexes_;
+            }
+
+      bool empty() const
+            {
+            return indexes_.empty();
+            }
+
                   // <voice, intervals>
-      std::map<int, std::vector<std::pair<ReducedFraction, ReducedFraction>>> voiceIntervals;
-      for (int i: selectedTuplets) {
-            int voice = findAvailableVoice(i, tupletIntervals, voiceIntervals);
-            voiceIntervals[voice].push_back(tupletIntervals[i]);
+      const std::map<int, std::vector<std::pair<ReducedFraction, ReducedFraction>>>& voiceIntervals() const
+            {
+            return voiceIntervals_;
             }
-      return voiceIntervals;
-      }
+
+      const std::map<std::pair<const ReducedFraction, MidiChord> *, int>& usedFirstChords() const
+            {
+            return usedFirstChords_;
+            }
+
+      void push(int index)
+            {
+            const int voice = findAvailableVoice(index, tupletIntervals_, voiceIntervals_);
+            voiceIntervals_[voice].push_back(tupletIntervals_[index]);
+            voices_.push_back(voice);
+            indexes_.push_back(index);
+            if (tuplets_[index].firstChordIndex == 0)
+                  ++usedFirstChords_[&*tuplets_[index].chords.begin()->second];
+            }
+
+      void pop()
+            {
+            const int index = indexes_.back();
+            const auto it = voiceIntervals_.find(voices_.back());
+            it->second.pop_back();
+            if (it->second.empty())
+                  voiceIntervals_.erase(it);
+            if (tuplets_[index].firstChordIndex == 0) {
+                  const auto fit = usedFirstChords_.find(&*tuplets_[index].chords.begin()->second);
+                  if (--(fit->second) == 0)
+                        usedFirstChords_.erase(fit);
+                  }
+            voices_.pop_back();
+            indexes_.pop_back();
+            }
+
+   private:
+      const std::vector<TupletInfo> &tuplets_;
+      const std::vector<std::pair<ReducedFraction, ReducedFraction> > &tupletIntervals_;
+      std::vector<int> indexes_;
+      std::vector<int> voices_;           // voice of each selected tuplet
+      std::map<int, std::vector<std::pair<ReducedFraction, ReducedFraction>>> voiceIntervals_;
+      std::map<std::pair<const ReducedFraction, MidiChord> *, int> usedFirstChords_;
+      };
 
 class ValidTuplets
       {
@@ -787,71 +833,95 @@ class ValidTuplets
                   return index;
             int prev = indexes_[index].first;
             int next = indexes_[index].second;
-            indexes_[index].first = -1;
-            indexes_[index].second = indexes_.size();
+            change(index, {-1, (int)indexes_.size()});
             if (prev >= first_)
-                  indexes_[prev].second = next;
+                  change(prev, {indexes_[prev].first, next});
             if (next < (int)indexes_.size())
-                  indexes_[next].first = prev;
+                  change(next, {prev, indexes_[next].second});
             if (index == first_)
                   first_ = next;
             return next;
             }
 
-      std::vector<std::pair<int, int>> save()
+                  // state to return to with rollback()
+      size_t mark() const
             {
-            std::vector<std::pair<int, int>> indexes(indexes_.size() - first_);
-            for (int i = first_; i != (int)indexes_.size(); ++i)
-                  indexes[i - first_] = indexes_[i];
-            return indexes;
+            return changes_.size();
             }
 
-      void restore(const std::vector<std::pair<int, int>> &indexes)
+      void rollback(size_t mark)
             {
-            first_ = indexes_.size() - indexes.size();
-            for (int i = 0; i != (int)indexes.size(); ++i)
-                  indexes_[i + first_] = indexes[i];
+            while (changes_.size() > mark) {
+                  const Change &c = changes_.back();
+                  indexes_[c.index] = c.value;
+                  first_ = c.first;
+                  changes_.pop_back();
+                  }
             }
 
    private:
+      struct Change
+            {
+            int index;
+            std::pair<int, int> value;
+            int first;
+            };
+
+      void change(int index, const std::pair<int, int> &value)
+            {
+            changes_.push_back({index, indexes_[index], first_});
+            indexes_[index] = value;
+            }
+
       std::vector<std::pair<int, int>> indexes_;      // pair<prev, next>
       int first_;
+      std::vector<Change> changes_;                   // undo log of exclude()
       };
 
 
+      // the search stops when the node limit is reached
+      // and a valid combination of tuplets has been found
+
 void findNextTuplet(
-            std::vector<int> &selectedTuplets,
+            SelectedTuplets &selectedTuplets,
             ValidTuplets &validTuplets,
             std::vector<int> &bestTupletIndexes,
             TupletErrorResult &minCurrentError,
             const std::vector<TupletCommon> &tupletCommons,
             const std::vector<TupletInfo> &tuplets,
             const std::vector<std::pair<ReducedFraction, ReducedFraction> > &tupletIntervals,
-            size_t commonsSize)
+            size_t commonsSize,
+            SearchNodes &nodes)
       {
       while (!validTuplets.empty()) {
+            if (minCurrentError.isInitialized() && nodes.count >= nodes.limit) {
+                  nodes.isLimitReached = true;
+                  return;
+                  }
+            ++nodes.count;
             size_t index = validTuplets.first();
 
             bool isCommonGroupBegins = (selectedTuplets.empty() && index == commonsSize);
             if (isCommonGroupBegins) {      // first level
                   for (size_t i = index; i < tuplets.size(); ++i)
-                        selectedTuplets.push_back(i);
+                        selectedTuplets.push(i);
                   }
             else {
-                  selectedTuplets.push_back(index);
+                  selectedTuplets.push(index);
                   }
-            const auto voiceIntervals = prepareVoiceIntervals(selectedTuplets, tupletIntervals);
-            const auto usedFirstChords = prepareUsedFirstChords(selectedTuplets, tuplets);
+            const auto &selected = selectedTuplets.indexes();
+            const auto &voiceIntervals = selectedTuplets.voiceIntervals();
+            const auto &usedFirstChords = selectedTuplets.usedFirstChords();
 
-            Q_ASSERT_X(areCommonsDifferent(selectedTuplets), "MidiTuplet::findNextTuplet",
+            Q_ASSERT_X(areCommonsDifferent(selected), "MidiTuplet::findNextTuplet",
                        "There are duplicates in selected commons");
-            Q_ASSERT_X(areCommonsUncommon(selectedTuplets, tupletCommons),
+            Q_ASSERT_X(areCommonsUncommon(selected, tupletCommons),
                        "MidiTuplet::findNextTuplet", "Incompatible selected commons");
 
             if (isCommonGroupBegins) {
                   bool canAddMoreIndexes = false;
                   for (size_t i = 0; i != commonsSize; ++i) {
-                        if (!isInCommonIndexes(i, selectedTuplets, tupletCommons)
+                        if (!isInCommonIndexes(i, selected, tupletCommons)
                                     && canUseIndex(i, tuplets, tupletIntervals,
                                                    voiceIntervals, usedFirstChords)) {
                               canAddMoreIndexes = true;
@@ -860,13 +930,15 @@ void findNextTuplet(
                         }
                   if (!canAddMoreIndexes) {
                         tryUpdateBestIndexes(bestTupletIndexes, minCurrentError,
-                                             selectedTuplets, tuplets, voiceIntervals);
+                                             selected, tuplets, voiceIntervals);
                         }
+                  while (!selectedTuplets.empty())
+                        selectedTuplets.pop();
                   return;
                   }
 
             validTuplets.exclude(index);
-            const auto savedTuplets = validTuplets.save();
+            const size_t mark = validTuplets.mark();
                         // check tuplets for compatibility
             if (!validTuplets.empty()) {
                   for (int i: tupletCommons[index].commonIndexes) {
@@ -884,10 +956,10 @@ void findNextTuplet(
                   i = validTuplets.next(i);
                   }
             if (validTuplets.empty()) {
-                  const auto unusedIndexes = findUnusedIndexes(selectedTuplets);
+                  const auto unusedIndexes = findUnusedIndexes(selected);
                   bool canAddMoreIndexes = false;
                   for (int i: unusedIndexes) {
-                        if (!isInCommonIndexes(i, selectedTuplets, tupletCommons)
+                        if (!isInCommonIndexes(i, selected, tupletCommons)
                                     && canUseIndex(i, tuplets, tupletIntervals,
                                                    voiceIntervals, usedFirstChords)) {
                               canAddMoreIndexes = true;
@@ -896,16 +968,16 @@ void findNextTuplet(
                         }
                   if (!canAddMoreIndexes) {
                         tryUpdateBestIndexes(bestTupletIndexes, minCurrentError,
-                                             selectedTuplets, tuplets, voiceIntervals);
+                                             selected, tuplets, voiceIntervals);
                         }
                   }
             else {
                   findNextTuplet(selectedTuplets, validTuplets, bestTupletIndexes, minCurrentError,
-                                 tupletCommons, tuplets, tupletIntervals, commonsSize);
+                                 tupletCommons, tuplets, tupletIntervals, commonsSize, nodes);
                   }
 
-            selectedTuplets.pop_back();
-            validTuplets.restore(savedTuplets);
+            selectedTuplets.pop();
+            validTuplets.rollback(mark);
             }
       }
 
@@ -929,17 +1001,18 @@ void moveUncommonTupletsToEnd(std::vector<TupletInfo> &tuplets, std::set<int> &u
 std::vector<int> findBestTuplets(
             const std::vector<TupletCommon> &tupletCommons,
             const std::vector<TupletInfo> &tuplets,
-            size_t commonsSize)
+            size_t commonsSize,
+            SearchNodes &nodes)
       {
       std::vector<int> bestTupletIndexes;
-      std::vector<int> selectedTuplets;
       TupletErrorResult minCurrentError;
       const auto tupletIntervals = findTupletIntervals(tuplets);
 
+      SelectedTuplets selectedTuplets(tuplets, tupletIntervals);
       ValidTuplets validTuplets(tuplets.size());
 
       findNextTuplet(selectedTuplets, validTuplets, bestTupletIndexes, minCurrentError,
-                     tupletCommons, tuplets, tupletIntervals, commonsSize);
+                     tupletCommons, tuplets, tupletIntervals, commonsSize, nodes);
 
       return bestTupletIndexes;
       }
@@ -1020,12 +1093,13 @@ void removeExtraTuplets(std::vector<TupletInfo> &tuplets)
 
 // first chord in tuplet may belong to other tuplet at the same time
 // in the case if there are enough notes in this first chord
-// to be splitted into different voices
+// to be splitted into different voices;
+// returns true if the search was stopped at searchNodeLimit
 
-void filterTuplets(std::vector<TupletInfo> &tuplets)
+bool filterTuplets(std::vector<TupletInfo> &tuplets, int searchNodeLimit)
       {
       if (tuplets.empty())
-            return;
+            return false;
 
       Q_ASSERT_X(!areTupletChordsEmpty(tuplets),
                  "MIDI tuplets: filterTuplets", "Tuplet has no chords but it should");
@@ -1046,7 +1120,8 @@ void filterTuplets(std::vector<TupletInfo> &tuplets)
             }
       const auto tupletCommons = findTupletCommons(tuplets);
 
-      const std::vector<int> bestIndexes = findBestTuplets(tupletCommons, tuplets, commonsSize);
+      SearchNodes nodes = {0, searchNodeLimit, false};
+      const std::vector<int> bestIndexes = findBestTuplets(tupletCommons, tuplets, commonsSize, nodes);
 
       Q_ASSERT_X(validateSelectedTuplets(bestIndexes.begin(), bestIndexes.end(), tuplets),
                  "MIDI tuplets: filterTuplets", "Tuplets have common chords but they shouldn't");
@@ -1056,6 +1131,7 @@ void filterTuplets(std::vector<TupletInfo> &tuplets)
             newTuplets.push_back(tuplets[i]);
 
       std::swap(tuplets, newTuplets);
+      return nodes.isLimitReached;
       }
 
 int averagePitch(const std::map<ReducedFraction,
@@ -2057,8 +2133,12 @@ void findTiedQuantizedOffTime(const std::vector<TiedTuplet> &backTiedTuplets,
 std::vector<TupletData> findTuplets(const ReducedFraction &startBarTick,
                                     const ReducedFraction &endBarTick,
                                     const ReducedFraction &barFraction,
-                                    std::multimap<ReducedFraction, MidiChord> &chords)
+                                    std::multimap<ReducedFraction, MidiChord> &chords,
+                                    int searchNodeLimit = SEARCH_NODE_LIMIT,
+                                    bool *isSearchLimitReached = nullptr)
       {
+      if (isSearchLimitReached)
+            *isSearchLimitReached = false;
       if (chords.empty() || startBarTick >= endBarTick)     // invalid cases
             return std::vector<TupletData>();
       const auto operations = preferences.midiImportOperations.currentTrackOperations();
@@ -2120,7 +2200,9 @@ std::vector<TupletData> findTuplets(const ReducedFraction &startBarTick,
                   }
             }
 
-      filterTuplets(tuplets);
+      const bool isLimitReached = filterTuplets(tuplets, searchNodeLimit);
+      if (isSearchLimitReached)
+            *isSearchLimitReached = isLimitReached;
 
             // later notes will be sorted and their indexes become invalid
             // so assign staccato information to notes now
@@ -38,6 +38,10 @@ struct TupletLimits
 
 const TupletLimits& tupletLimits(int tupletNumber);
 
+            // upper limit of tuplet combinations that are tried in one bar;
+            // when it is reached the best combination found so far is used
+const int SEARCH_NODE_LIMIT = 1 << 20;
+
 std::vector<TupletData>
 findTupletsInBarForDuration(int voice,
                             const ReducedFraction &barStartTick,
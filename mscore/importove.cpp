@@ -21,6 +21,7 @@
 #include "ove.h"
 
 #include "globals.h"
+#include "binaryreader.h"
 #include "musescore.h"
 #include "libmscore/sig.h"
 #include "libmscore/tempo.h"
@@ -2387,15 +2388,17 @@ Score::FileError importOve(Score* score, const QString& name) {
 		return Score::FILE_OPEN_ERROR;
 	}
 
-	QByteArray buffer = oveFile.readAll();
-
-	oveFile.close();
+	// the file is parsed from memory, mapped if possible
+	BinaryReader buffer;
+	buffer.open(&oveFile);
 
 	oveSong.setTextCodecName(preferences.importCharsetOve);
 	oveLoader->setOve(&oveSong);
-	oveLoader->setFileStream((unsigned char*) buffer.data(), buffer.size());
+	oveLoader->setFileStream(const_cast<unsigned char*>(buffer.data()), buffer.size());
 	bool result = oveLoader->load();
 	oveLoader->release();
+	buffer.close();
+	oveFile.close();
 
 	if(result){
 		OveToMScore otm;
@@ -405,10 +405,10 @@ static void determineMeasureStart(const QVector<Fraction>& ml, QVector<int>& ms)
  MusicXml constructor.
  */
 
-MusicXml::MusicXml(QDomDocument* d, MxmlReaderFirstPass const& p1)
+MusicXml::MusicXml(MxmlStreamReader* r, MxmlReaderFirstPass const& p1)
       :
       lastVolta(0),
-      doc(d),
+      reader(r),
       pass1(p1),
       beamMode(BeamMode::NONE),
       pageWidth(0),
@@ -591,18 +591,21 @@ static Score::FileError doImport(Score* score, const QString& name, QIODevice* d
       {
       QTime t;
       t.start();
-      QDomDocument doc;
-      int line;
-      int column;
-      QString err;
-      if (!doc.setContent(dev, false, &err, &line, &column)) {
-            QString s = QT_TRANSLATE_NOOP("file", "Error at line %1 column %2: %3\n");
-            MScore::lastError = s.arg(line).arg(column).arg(err);
+      docName = name; // set filename for domError
+      MxmlStreamReader reader(dev);
+      if (reader.rootTag() != "score-partwise") {
+            if (reader.hasError())
+                  MScore::lastError = reader.errorMessage();
+            else
+                  MScore::lastError = QT_TRANSLATE_NOOP("file", "this is not a MusicXML score-partwise file\n");
             return Score::FILE_BAD_FORMAT;
             }
-      docName = name; // set filename for domError
-      MusicXml musicxml(&doc, pass1);
+      MusicXml musicxml(&reader, pass1);
       musicxml.import(score);
+      if (reader.hasError()) {
+            MScore::lastError = reader.errorMessage();
+            return Score::FILE_BAD_FORMAT;
+            }
       qDebug("Parsing time elapsed: %d ms", t.elapsed());
       return Score::FILE_NO_ERROR;
       }
@@ -627,10 +630,9 @@ static Score::FileError doValidateAndImport(Score* score, const QString& name, Q
       // pass 1
       dev->seek(0);
       MxmlReaderFirstPass pass1;
-      res = pass1.setContent(dev);
+      res = pass1.parseFile(dev);
       if (res != Score::FILE_NO_ERROR)
             return res;
-      pass1.parseFile();
 
       // import the file
       dev->seek(0);
@@ -741,12 +743,10 @@ void MusicXml::import(Score* s)
       // TODO only if multi-measure rests used ???
       // score->style()->set(ST_createMultiMeasureRests, true);
 
-      for (QDomElement e = doc->documentElement(); !e.isNull(); e = e.nextSiblingElement()) {
-            if (e.tagName() == "score-partwise")
-                  scorePartwise(e.firstChildElement());
-            else
-                  domError(e);
-            }
+      if (reader->rootTag() == "score-partwise")
+            scorePartwise();
+      else
+            qDebug("MusicXML import: unknown root element <%s>", qPrintable(reader->rootTag()));
       }
 
 //---------------------------------------------------------
@@ -1065,31 +1065,29 @@ void MusicXml::readPageFormat(PageFormat* pf, QDomElement de, qreal conversion)
  Read the MusicXML score-partwise element.
  */
 
-void MusicXml::scorePartwise(QDomElement ee)
+void MusicXml::scorePartwise()
       {
-      // In a first pass collect all parts in case the part-list does not
+      // Create all parts found by the first pass in case the part-list does not
       // list them all. Incomplete part-list's are generated by some versions
       // of Finale.
-      // Furthermore, determine the length in ticks of each measure in the part
-      for (QDomElement e = ee; !e.isNull(); e = e.nextSiblingElement()) {
-            if (e.tagName() == "part") {
-                  QString id = e.attribute(QString("id"));
-                  if (id == "")
-                        qDebug("MusicXML import: part without id");
-                  else {
-                        Part* part = new Part(score);
-                        part->setId(id);
-                        score->appendPart(part);
-                        Staff* staff = new Staff(score, part, 0);
-                        part->staves()->push_back(staff);
-                        score->staves().push_back(staff);
-                        tuplets.resize(VOICES); // part now contains one staff, thus VOICES voices
-                        }
+      foreach (const QString& id, pass1.getPartIds()) {
+            if (id == "")
+                  qDebug("MusicXML import: part without id");
+            else {
+                  Part* part = new Part(score);
+                  part->setId(id);
+                  score->appendPart(part);
+                  Staff* staff = new Staff(score, part, 0);
+                  part->staves()->push_back(staff);
+                  score->staves().push_back(staff);
+                  tuplets.resize(VOICES); // part now contains one staff, thus VOICES voices
                   }
             }
 
-      // Read the score
-      for (QDomElement e = ee; !e.isNull(); e = e.nextSiblingElement()) {
+      // Read the score one top level element at a time; the reader
+      // reads the next part while this one is converted
+      for (QDomDocument doc = reader->next(); !doc.isNull(); doc = reader->next()) {
+            QDomElement e = doc.documentElement();
             QString tag(e.tagName());
             if (tag == "part-list")
                   xmlPartList(e.firstChildElement());
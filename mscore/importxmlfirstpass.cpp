@@ -736,23 +736,6 @@ VoiceList MxmlReaderFirstPass::getVoiceList(const QString id) const
       }
 
 
-Score::FileError MxmlReaderFirstPass::setContent(QIODevice* d)
-      {
-      int line;
-      int column;
-      QString err;
-
-      if (!doc.setContent(d, false, &err, &line, &column)) {
-            QString s = QT_TRANSLATE_NOOP("file", "Error at line %1 column %2: %3\n");
-            MScore::lastError = s.arg(line).arg(column).arg(err);
-            return Score::FILE_BAD_FORMAT;
-            }
-
-      // return OK
-      return Score::FILE_NO_ERROR;
-      }
-
-
 // parse the part
 // in: e is the "part" node
 // equivalent to MuseScores xmlPart
@@ -791,22 +774,28 @@ void MxmlReaderFirstPass::parsePartList(QDomElement e)
 
 
 // parse the file
+// streams the file one top level element at a time,
+// only a single part is held as DOM
 
-void MxmlReaderFirstPass::parseFile()
+Score::FileError MxmlReaderFirstPass::parseFile(QIODevice* d)
       {
       qDebug("MxmlReaderFirstPass::parseFile() begin");
       QTime t;
       t.start();
-      // get the root element
-      QDomElement e = doc.documentElement();
+      MxmlStreamReader reader(d);
 
       // read the score
       int partNr = 0; // part number while reading parts
       qDebug("part list");
-      for (e = e.firstChildElement(); !e.isNull(); e = e.nextSiblingElement()) {
+      for (QDomDocument doc = reader.next(); !doc.isNull(); doc = reader.next()) {
+            QDomElement e = doc.documentElement();
             if (e.tagName() == "part") {
                   QString partName = e.attribute("id");
-                  parsePart(e, partName, partNr);
+                  if (partNr < parts.size())
+                        parsePart(e, partName, partNr);
+                  else
+                        qDebug("part id '%s' not in part-list", qPrintable(partName));
+                  partIds.append(partName);
                   ++partNr;
                   qDebug("part %d id '%s'", partNr, qPrintable(partName));
                   }
@@ -817,6 +806,10 @@ void MxmlReaderFirstPass::parseFile()
                   // ignore
                   }
             }
+      if (reader.hasError()) {
+            MScore::lastError = reader.errorMessage();
+            return Score::FILE_BAD_FORMAT;
+            }
 
       // debug: print results
       /*
@@ -827,6 +820,6 @@ void MxmlReaderFirstPass::parseFile()
 
       qDebug("Parsing time elapsed: %d ms", t.elapsed());
       qDebug("MxmlReaderFirstPass::parseFile() end");
+      return Score::FILE_NO_ERROR;
       }
 }
-
@@ -47,11 +47,11 @@ public:
       int nParts() const { return parts.size(); }
       void parsePart(QDomElement e, QString& partName, int partNr);
       void parsePartList(QDomElement e);
-      void parseFile();
-      Score::FileError setContent(QIODevice* d);
+      Score::FileError parseFile(QIODevice* d);
+      QStringList getPartIds() const { return partIds; }
 private:
-      QDomDocument doc;
       QList<MusicXmlPart> parts;
+      QStringList partIds;         // id of every part element, in document order
       };
 
 
@@ -24,6 +24,7 @@
 #include "preferences.h"
 // #include "msynth/synti.h"
 #include "seq.h"
+#include "synthesizer/msynthesizer.h"
 
 #include <jack/midiport.h>
 
@@ -311,6 +312,18 @@ static int graph_callback(void*)
       return 0;
       }
 
+//---------------------------------------------------------
+//   xrun
+//    JACK callback
+//---------------------------------------------------------
+
+int JackAudio::xrun(void* p)
+      {
+      JackAudio* audio = (JackAudio*)p;
+      audio->seq->synti()->stats()->xrun();
+      return 0;
+      }
+
 //---------------------------------------------------------
 //   processAudio
 //    JACK callback
@@ -422,6 +435,7 @@ bool JackAudio::init()
       jack_set_port_registration_callback(client, registration_callback, this);
       jack_set_graph_order_callback(client, graph_callback, this);
       jack_set_freewheel_callback (client, freewheel_callback, this);
+      jack_set_xrun_callback(client, xrun, this);
       _segmentSize  = jack_get_buffer_size(client);
 
       MScore::sampleRate = sampleRate();
@@ -46,6 +46,7 @@ class JackAudio : public Driver {
       QList<jack_port_t*> midiInputPorts;
 
       static int processAudio(jack_nframes_t, void*);
+      static int xrun(void*);
 
    public:
       JackAudio(Seq*);
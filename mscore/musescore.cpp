@@ -29,6 +29,7 @@
 #include "pagesettings.h"
 #include "debugger/debugger.h"
 #include "editstyle.h"
+#include "convertercache.h"
 #include "playpanel.h"
 #include "libmscore/page.h"
 #include "mixer.h"
@@ -44,6 +45,7 @@
 #include "magbox.h"
 #include "libmscore/sig.h"
 #include "libmscore/undo.h"
+#include "libmscore/msczarchive.h"
 #include "synthcontrol.h"
 #include "pianoroll.h"
 #include "drumroll.h"
@@ -95,11 +97,13 @@
 #include "synthesizer/msynthesizer.h"
 #include "fluid/fluid.h"
 #include "qmlplugin.h"
+#include "libmscore/trace.h"
 
 #ifdef AEOLUS
 extern Ms::Synthesizer* createAeolus();
 #endif
 #ifdef ZERBERUS
+#include "zerberus/zerberus.h"
 extern Ms::Synthesizer* createZerberus();
 #endif
 
@@ -127,6 +131,10 @@ static QString outFileName;
 static QString audioDriver;
 static QString pluginName;
 static QString styleFile;
+static QString converterCacheDir;
+static QString benchmarkFileName;
+static const int benchmarkRuns = 5;
+static QString traceFileName;
 QString localeName;
 bool useFactorySettings = false;
 QString styleName;
@@ -244,6 +252,7 @@ void MuseScore::closeEvent(QCloseEvent* ev)
       foreach(Score* score, removeList)
             scoreList.removeAll(score);
 
+      autoSaveWatcher.waitForFinished();
       writeSessionFile(true);
       foreach(Score* score, scoreList) {
             if (!score->tmpName().isEmpty()) {
@@ -1113,6 +1122,8 @@ MuseScore::MuseScore()
       autoSaveTimer = new QTimer(this);
       autoSaveTimer->setSingleShot(true);
       connect(autoSaveTimer, SIGNAL(timeout()), this, SLOT(autoSaveTimerTimeout()));
+      connect(&autoSaveWatcher, SIGNAL(finished()), this, SLOT(autoSaveFinished()));
+      autoSaveSessionChanged = false;
       initOsc();
       startAutoSave();
       if (enableExperimental) {
@@ -1409,6 +1420,9 @@ static void usage()
         "   -i        load icons from INSTALLPATH/icons\n"
         "   -e        enable experimental features\n"
         "   -c dir    override config/settings folder\n"
+        "   -C dir    cache converted files in dir (with -o)\n"
+        "   -B file   write layout and rendering timings of the scores to 'file'\n"
+        "   -T file   trace layout, rendering and audio, write the spans to 'file'\n"
         "   -t        set testMode flag for all files\n"
         "   -w        write buildin workspace\n"
         );
@@ -1995,6 +2009,7 @@ void MuseScore::removeTab(int i)
             setCurrentScoreView((firstTab ? tab1 : tab2)->view());
       writeSessionFile(false);
       if (!tmpName.isEmpty()) {
+            autoSaveWatcher.waitForFinished();
             QFile f(tmpName);
             f.remove();
             }
@@ -2241,6 +2256,126 @@ static bool processNonGui()
       return true;
       }
 
+//---------------------------------------------------------
+//   converterCacheOptions
+//    the settings which change the output of a conversion;
+//    sound fonts are too large to be hashed and are
+//    identified by size and modification time
+//---------------------------------------------------------
+
+static QStringList converterCacheOptions()
+      {
+      QStringList o;
+      o << QString("dpi=%1").arg(converterDpi)
+        << QString("pngTransparent=%1").arg(preferences.pngTransparent)
+        << QString("musicxmlExportLayout=%1").arg(preferences.musicxmlExportLayout)
+        << QString("exportAudioSampleRate=%1").arg(preferences.exportAudioSampleRate);
+      QFileInfoList sl = FluidS::Fluid::sfFiles();
+#ifdef ZERBERUS
+      sl += Zerberus::sfzFiles();
+#endif
+      foreach (const QFileInfo& fi, sl) {
+            o << QString("soundfont=%1 %2 %3").arg(fi.absoluteFilePath()).arg(fi.size())
+               .arg(fi.lastModified().toMSecsSinceEpoch());
+            }
+      return o;
+      }
+
+//---------------------------------------------------------
+//   processNonGuiCached
+//    converter mode with a cache directory: the output of
+//    an unchanged score is copied from the cache without
+//    loading the score; otherwise the conversion writes
+//    to a temporary directory and its files are added to
+//    the cache
+//---------------------------------------------------------
+
+static bool processNonGuiCached(const QStringList& argv)
+      {
+      ConverterCache cache(converterCacheDir);
+      QString outFile(outFileName);
+      QDir outDir = QFileInfo(outFile).absoluteDir();
+      QTemporaryDir tmpDir;
+      // synthesizer.xml holds the synthesizer state used for
+      // scores without one
+      QStringList files;
+      files << styleFile << dataPath + "/synthesizer.xml";
+      if (pluginMode || argv.size() != 1 || !tmpDir.isValid()
+         || !cache.setKey(argv[0], outFile, files, converterCacheOptions())) {
+            loadScores(argv);
+            return processNonGui();
+            }
+      if (cache.restore(outDir))
+            return true;
+
+      outFileName = QDir(tmpDir.path()).filePath(QFileInfo(outFile).fileName());
+      loadScores(argv);
+      bool rv = processNonGui();
+      outFileName = outFile;
+      return rv && cache.store(QDir(tmpDir.path()), outDir);
+      }
+
+//---------------------------------------------------------
+//   processBenchmark
+//    load every score benchmarkRuns times and write the
+//    timings of loading, layout and rendering as json;
+//    vtest/gen-perf runs this over the vtest scores,
+//    vtest/compare-perf compares the results of two builds
+//---------------------------------------------------------
+
+static bool processBenchmark(const QStringList& argv)
+      {
+      QJsonArray scores;
+      bool rv = true;
+      foreach (const QString& name, argv) {
+            QJsonArray load;
+            Score* score = 0;
+            QElapsedTimer t;
+            for (int run = 0; run < benchmarkRuns; ++run) {
+                  delete score;
+                  t.start();
+                  score = mscore->readScore(name);
+                  load.append(t.nsecsElapsed() / 1e6);
+                  if (!score)
+                        break;
+                  }
+            if (!score) {
+                  qDebug("benchmark: cannot read <%s>", qPrintable(name));
+                  rv = false;
+                  continue;
+                  }
+            QJsonObject o = mscore->benchmarkScore(score, benchmarkRuns);
+            o["file"] = QFileInfo(name).fileName();
+            o["load"] = load;
+            scores.append(o);
+            delete score;
+            }
+      QJsonObject o;
+      o["version"]  = QString(VERSION);
+      o["revision"] = revision;
+      o["dpi"]      = converterDpi;
+      o["runs"]     = benchmarkRuns;
+      o["scores"]   = scores;
+
+      QFile f(benchmarkFileName);
+      if (!f.open(QIODevice::WriteOnly) || f.write(QJsonDocument(o).toJson()) < 0) {
+            qDebug("benchmark: cannot write <%s>", qPrintable(benchmarkFileName));
+            return false;
+            }
+      return rv;
+      }
+
+//---------------------------------------------------------
+//   saveTrace
+//    called at exit if tracing is enabled
+//---------------------------------------------------------
+
+static void saveTrace()
+      {
+      if (!Trace::save(traceFileName))
+            qDebug("trace: cannot write <%s>", qPrintable(traceFileName));
+      }
+
 //---------------------------------------------------------
 //   StartDialog
 //---------------------------------------------------------
@@ -3210,22 +3345,63 @@ void MuseScore::removeSessionFile()
             }
       }
 
+//---------------------------------------------------------
+//   AutoSave
+//---------------------------------------------------------
+
+struct AutoSave {
+      QString path;
+      MsczSnapshot snapshot;
+      };
+
+//---------------------------------------------------------
+//   writeAutoSaves
+//    runs in a worker thread; QSaveFile replaces the old
+//    autosave file by an atomic rename, so a crash while
+//    writing leaves the previous version intact
+//---------------------------------------------------------
+
+static bool writeAutoSaves(const QList<AutoSave>& autoSaves)
+      {
+      bool rv = true;
+      foreach(const AutoSave& as, autoSaves) {
+            QSaveFile f(as.path);
+            if (!f.open(QIODevice::WriteOnly)) {
+                  qDebug("autosave: cannot open <%s>", qPrintable(as.path));
+                  rv = false;
+                  continue;
+                  }
+            try {
+                  as.snapshot.write(&f, MScore::autoSaveCompressionLevel);
+                  }
+            catch (QString s) {
+                  qDebug("autosave <%s> failed: %s", qPrintable(as.path), qPrintable(s));
+                  f.cancelWriting();
+                  }
+            if (!f.commit())
+                  rv = false;
+            }
+      return rv;
+      }
+
 //---------------------------------------------------------
 //   autoSaveTimerTimeout
+//    serialize dirty scores, compress and write them in
+//    the background
 //---------------------------------------------------------
 
 void MuseScore::autoSaveTimerTimeout()
       {
-      bool sessionChanged = false;
+      if (autoSaveWatcher.isRunning()) {
+            // previous autosave still writing, try again later
+            autoSaveTimer->start(10 * 1000);
+            return;
+            }
+      QList<AutoSave> autoSaves;
       foreach(Score* s, scoreList) {
             if (s->autosaveDirty()) {
                   QString tmp = s->tmpName();
-                  if (!tmp.isEmpty()) {
-                        QFileInfo fi(tmp);
-                        // TODO: cannot catch exeption here:
-                        cs->saveCompressedFile(fi, false);
-                        }
-                  else {
+                  if (tmp.isEmpty()) {
                         QDir dir;
                         dir.mkpath(dataPath);
                         QTemporaryFile tf(dataPath + "/scXXXXXX.mscz");
@@ -3234,23 +3410,44 @@ void MuseScore::autoSaveTimerTimeout()
                               qDebug("autoSaveTimerTimeout(): create temporary file failed");
                               return;
                               }
-                        s->setTmpName(tf.fileName());
-                        QFileInfo info(tf.fileName());
-                        s->saveCompressedFile(&tf, info, false);
+                        tmp = tf.fileName();
                         tf.close();
-                        sessionChanged = true;
+                        s->setTmpName(tmp);
+                        autoSaveSessionChanged = true;
                         }
+                  // only the snapshot is taken on the GUI thread
+                  AutoSave as;
+                  as.path = tmp;
+                  QFileInfo info(tmp);
+                  s->createSnapshot(&as.snapshot, info, false);
+                  autoSaves.append(as);
                   s->setAutosaveDirty(false);
                   }
             }
-      if (sessionChanged)
-            writeSessionFile(false);
+      if (!autoSaves.isEmpty())
+            autoSaveWatcher.setFuture(QtConcurrent::run(writeAutoSaves, autoSaves));
+      else if (autoSaveSessionChanged)
+            autoSaveFinished();
       if (preferences.autoSave) {
             int t = preferences.autoSaveTime * 60 * 1000;
             autoSaveTimer->start(t);
             }
       }
 
+//---------------------------------------------------------
+//   autoSaveFinished
+//    the session file refers to the autosave files, write
+//    it after they exist
+//---------------------------------------------------------
+
+void MuseScore::autoSaveFinished()
+      {
+      if (autoSaveSessionChanged) {
+            autoSaveSessionChanged = false;
+            writeSessionFile(false);
+            }
+      }
+
 //---------------------------------------------------------
 //   restoreSession
 //    Restore last session. If "always" is true, then restore
@@ -4656,6 +4853,23 @@ int main(int argc, char* av[])
                               }
                         }
                         break;
+                  case 'C':
+                        if (argv.size() - i < 2)
+                              usage();
+                        converterCacheDir = argv.takeAt(i + 1);
+                        break;
+                  case 'B':
+                        converterMode = true;
+                        MScore::noGui = true;
+                        if (argv.size() - i < 2)
+                              usage();
+                        benchmarkFileName = argv.takeAt(i + 1);
+                        break;
+                  case 'T':
+                        if (argv.size() - i < 2)
+                              usage();
+                        traceFileName = argv.takeAt(i + 1);
+                        break;
                   case 't':
                         {
                         enableTestMode = true;
@@ -4752,6 +4966,13 @@ int main(int argc, char* av[])
       if (!useFactorySettings)
             preferences.read();
 
+      if (traceFileName.isEmpty())
+            traceFileName = preferences.traceFile;
+      if (!traceFileName.isEmpty()) {
+            Trace::setEnabled(true);
+            atexit(saveTrace);
+            }
+
       preferences.readDefaultStyle();
 
       if (converterDpi == 0)
@@ -4902,6 +5123,10 @@ int main(int argc, char* av[])
 
       int files = 0;
       if (MScore::noGui) {
+            if (!benchmarkFileName.isEmpty())
+                  exit(processBenchmark(argv) ? 0 : -1);
+            if (converterMode && !converterCacheDir.isEmpty())
+                  exit(processNonGuiCached(argv) ? 0 : -1);
             loadScores(argv);
             exit(processNonGui() ? 0 : -1);
             }
@@ -292,6 +292,8 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
       void createMenuEntry(PluginDescription*);
 
       QTimer* autoSaveTimer;
+      QFutureWatcher<bool> autoSaveWatcher;     ///< compresses and writes autosave files
+      bool autoSaveSessionChanged;
       QList<QAction*> qmlPluginActions;
       QList<QAction*> pluginActions;
       QSignalMapper* pluginMapper;
@@ -402,6 +404,7 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
    private slots:
       void cmd(QAction* a, const QString& cmd);
       void autoSaveTimerTimeout();
+      void autoSaveFinished();
       void helpBrowser1() const;
       void about();
       void aboutQt();
@@ -592,6 +595,7 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
       bool saveMp3(Score*, const QString& name);
       bool saveSvg(Score*, const QString& name);
       bool savePng(Score*, const QString& name);
+      QJsonObject benchmarkScore(Score*, int runs);
 //      bool saveLilypond(Score*, const QString& name);
       bool saveMidi(Score* score, const QString& name);
 
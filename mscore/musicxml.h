@@ -160,7 +160,7 @@ class MusicXml {
       Tie* tie;
       Volta* lastVolta;
 
-      QDomDocument* doc;
+      MxmlStreamReader* reader;
       MxmlReaderFirstPass const& pass1;
       int tick;                                 ///< Current position in MuseScore time
       int maxtick;                              ///< Maxtick of a measure, used to calculate measure len
@@ -197,7 +197,7 @@ class MusicXml {
 
       void doCredits();
       void direction(Measure* measure, int staff, QDomElement node);
-      void scorePartwise(QDomElement);
+      void scorePartwise();
       void xmlPartList(QDomElement);
       void xmlPart(QDomElement, QString id);
       void xmlScorePart(QDomElement node, QString id, int& parts);
@@ -214,7 +214,7 @@ class MusicXml {
       void readPageFormat(PageFormat* pf, QDomElement de, qreal conversion);
 
 public:
-      MusicXml(QDomDocument* d, MxmlReaderFirstPass const& p1);
+      MusicXml(MxmlStreamReader* r, MxmlReaderFirstPass const& p1);
       void import(Score*);
       };
 
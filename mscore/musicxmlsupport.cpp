@@ -185,6 +185,130 @@ void ValidatorMessageHandler::handleMessage(QtMsgType type, const QString& descr
       errors += errorStr;
       }
 
+//---------------------------------------------------------
+//   MxmlStreamReader
+//---------------------------------------------------------
+
+/**
+ Start reading the document from \a dev: skip to the root element
+ and start reading its first child.
+ */
+
+MxmlStreamReader::MxmlStreamReader(QIODevice* dev)
+      : _xml(dev)
+      {
+      _xml.setNamespaceProcessing(false);
+      while (!_xml.atEnd()) {
+            if (_xml.readNext() == QXmlStreamReader::StartElement) {
+                  _rootTag = _xml.qualifiedName().toString();
+                  _next = QtConcurrent::run(this, &MxmlStreamReader::readElement);
+                  break;
+                  }
+            }
+      }
+
+MxmlStreamReader::~MxmlStreamReader()
+      {
+      _next.waitForFinished();
+      }
+
+//---------------------------------------------------------
+//   next
+//---------------------------------------------------------
+
+/**
+ Return the next child of the root element as the document
+ element of a DOM document, or a null document at the end of
+ the root element or on error.
+ */
+
+QDomDocument MxmlStreamReader::next()
+      {
+      if (_next.isCanceled())
+            return QDomDocument();
+      QDomDocument doc = _next.result();
+      if (doc.isNull())
+            _next = QFuture<QDomDocument>();
+      else
+            _next = QtConcurrent::run(this, &MxmlStreamReader::readElement);
+      return doc;
+      }
+
+//---------------------------------------------------------
+//   readElement
+//---------------------------------------------------------
+
+/**
+ Read the next child of the root element into a new DOM document.
+ Like QDomDocument::setContent(), whitespace only text is dropped.
+ Runs on a worker thread.
+ */
+
+QDomDocument MxmlStreamReader::readElement()
+      {
+      while (_xml.readNext() != QXmlStreamReader::StartElement) {
+            if (_xml.atEnd() || _xml.isEndElement())
+                  return QDomDocument();
+            }
+      QDomDocument doc;
+      QDomNode parent = doc;
+      int depth = 0;
+      do {
+            switch (_xml.tokenType()) {
+                  case QXmlStreamReader::StartElement:
+                        {
+                        QDomElement e = doc.createElement(_xml.qualifiedName().toString());
+                        foreach (const QXmlStreamAttribute& a, _xml.attributes())
+                              e.setAttribute(a.qualifiedName().toString(), a.value().toString());
+                        parent.appendChild(e);
+                        parent = e;
+                        ++depth;
+                        }
+                        break;
+                  case QXmlStreamReader::EndElement:
+                        parent = parent.parentNode();
+                        --depth;
+                        break;
+                  case QXmlStreamReader::Characters:
+                        if (!_xml.isWhitespace())
+                              parent.appendChild(doc.createTextNode(_xml.text().toString()));
+                        break;
+                  default:
+                        break;
+                  }
+            } while (depth > 0 && _xml.readNext() != QXmlStreamReader::Invalid);
+      if (_xml.hasError())
+            return QDomDocument();
+      return doc;
+      }
+
+//---------------------------------------------------------
+//   hasError
+//---------------------------------------------------------
+
+/**
+ Return true if the document is not well formed. Waits for the
+ element being read on the worker thread, as _xml is not to be
+ touched while it runs.
+ */
+
+bool MxmlStreamReader::hasError() const
+      {
+      _next.waitForFinished();
+      return _xml.hasError();
+      }
+
+//---------------------------------------------------------
+//   errorMessage
+//---------------------------------------------------------
+
+QString MxmlStreamReader::errorMessage() const
+      {
+      _next.waitForFinished();
+      QString s = QT_TRANSLATE_NOOP("file", "Error at line %1 column %2: %3\n");
+      return s.arg(_xml.lineNumber()).arg(_xml.columnNumber()).arg(_xml.errorString());
+      }
+
 //---------------------------------------------------------
 //   printDomElementPath
 //---------------------------------------------------------
@@ -162,6 +162,33 @@ public:
       static Fraction calculateFraction(QString type, int dots, int normalNotes, int actualNotes);
 };
 
+//---------------------------------------------------------
+//   MxmlStreamReader
+//---------------------------------------------------------
+
+/**
+ Reads a MusicXML document one top level element (part-list,
+ part, credit, ...) at a time. Each element is returned as a
+ small DOM document of its own, so the document as a whole is
+ never held as a DOM. The next element is read on a worker
+ thread while the caller handles the current one.
+ */
+
+class MxmlStreamReader {
+public:
+      MxmlStreamReader(QIODevice* dev);
+      ~MxmlStreamReader();
+      QString rootTag() const { return _rootTag; }
+      QDomDocument next();
+      bool hasError() const;
+      QString errorMessage() const;
+private:
+      QDomDocument readElement();
+      QXmlStreamReader _xml;
+      QString _rootTag;
+      mutable QFuture<QDomDocument> _next;
+      };
+
 //---------------------------------------------------------
 //   ValidatorMessageHandler
 //---------------------------------------------------------
@@ -315,13 +315,19 @@ void Navigator::paintEvent(QPaintEvent* ev)
             if (pr.left() > fr.right())
                   break;
 
-            p.fillRect(pr, Qt::white);
             p.translate(pos);
-            foreach(System* s, *page->systems()) {
-                  foreach(MeasureBase* m, s->measures())
-                        m->scanElements(&p, paintElement, false);
+            if (page->layoutPending()) {
+                  // placeholder, see ScoreView::layoutPendingPages()
+                  p.fillRect(page->bbox(), QColor(230, 230, 230));
+                  }
+            else {
+                  p.fillRect(page->bbox(), Qt::white);
+                  foreach(System* s, *page->systems()) {
+                        foreach(MeasureBase* m, s->measures())
+                              m->scanElements(&p, paintElement, false);
+                        }
+                  page->scanElements(&p, paintElement, false);
                   }
-            page->scanElements(&p, paintElement, false);
             if (page->score()->layoutMode() == LayoutPage) {
                   p.setFont(QFont("FreeSans", 400));  // !!
                   p.setPen(MScore::layoutBreakColor);
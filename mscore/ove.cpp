@@ -3347,6 +3347,16 @@ bool StreamHandle::read(char* buff, int size) {
 	return false;
 }
 
+bool StreamHandle::skip(int size) {
+	if (point_ != NULL && curPos_ + size <= size_) {
+		curPos_ += size;
+
+		return true;
+	}
+
+	return false;
+}
+
 bool StreamHandle::write(char* /*buff*/, int /*size*/) {
 	return true;
 }
@@ -3689,8 +3699,7 @@ bool BasicParse::jump(int offset) {
 	}
 
 	if (offset > 0) {
-		Block placeHolder(offset);
-		return handle_->read((char*) placeHolder.data(), placeHolder.size());
+		return handle_->skip(offset);
 	}
 
 	return true;
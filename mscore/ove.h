@@ -2235,6 +2235,7 @@ private:
 
 public:
 	virtual bool read(char* buff, int size);
+	virtual bool skip(int size);
 	virtual bool write(char* buff, int size);
 
 private:
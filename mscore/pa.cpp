@@ -22,6 +22,7 @@
 #include "libmscore/score.h"
 #include "musescore.h"
 #include "seq.h"
+#include "synthesizer/msynthesizer.h"
 #include "pa.h"
 
 #ifdef USE_ALSA
@@ -42,8 +43,10 @@ static PaStream* stream;
 //---------------------------------------------------------
 
 int paCallback(const void*, void* out, long unsigned frames,
-   const PaStreamCallbackTimeInfo*, PaStreamCallbackFlags, void *)
+   const PaStreamCallbackTimeInfo*, PaStreamCallbackFlags flags, void *)
       {
+      if (flags & (paOutputUnderflow | paOutputOverflow))
+            seq->synti()->stats()->xrun();
       seq->process((unsigned)frames, (float*)out);
       return 0;
       }
@@ -34,6 +34,7 @@
 #include "pa.h"
 #include "pm.h"
 #include "libmscore/page.h"
+#include "libmscore/undo.h"
 #include "file.h"
 #include "libmscore/mscore.h"
 #include "shortcut.h"
@@ -182,6 +183,7 @@ void Preferences::init()
       styleName               = "light";   // ??
       globalStyle             = STYLE_LIGHT;
       animations              = true;
+      traceFile               = "";
 
       QString wd      = QString("%1/%2").arg(QDesktopServices::storageLocation(QDesktopServices::DocumentsLocation)).arg(QCoreApplication::applicationName());
 
@@ -319,6 +321,7 @@ void Preferences::write()
       s.setValue("oscPort", oscPort);
       s.setValue("style", styleName);
       s.setValue("animations", animations);
+      s.setValue("traceFile", traceFile);
       s.setValue("singlePalette", singlePalette);
 
       s.setValue("myScoresPath", myScoresPath);
@@ -331,6 +334,7 @@ void Preferences::write()
 
       s.setValue("hraster", MScore::hRaster());
       s.setValue("vraster", MScore::vRaster());
+      s.setValue("undoMemoryBudget", int(MScore::undoMemoryBudget / (1024 * 1024)));   // MB
       s.setValue("nativeDialogs", nativeDialogs);
       s.setValue("exportAudioSampleRate", exportAudioSampleRate);
 
@@ -461,6 +465,7 @@ void Preferences::read()
             globalStyle  = STYLE_LIGHT;
 
       animations       = s.value("animations",       animations).toBool();
+      traceFile        = s.value("traceFile",        traceFile).toString();
       singlePalette    = s.value("singlePalette",    singlePalette).toBool();
       myScoresPath     = s.value("myScoresPath",     myScoresPath).toString();
       myStylesPath     = s.value("myStylesPath",     myStylesPath).toString();
@@ -486,6 +491,7 @@ void Preferences::read()
 
       MScore::setHRaster(s.value("hraster", MScore::hRaster()).toInt());
       MScore::setVRaster(s.value("vraster", MScore::vRaster()).toInt());
+      MScore::undoMemoryBudget = size_t(s.value("undoMemoryBudget", int(MScore::undoMemoryBudget / (1024 * 1024))).toInt()) * 1024 * 1024;
 
       nativeDialogs    = s.value("nativeDialogs", nativeDialogs).toBool();
       exportAudioSampleRate = s.value("exportAudioSampleRate", exportAudioSampleRate).toInt();
@@ -861,6 +867,12 @@ void PreferenceDialog::updateValues()
       midiPorts->setValue(prefs.midiPorts);
       rememberLastMidiConnections->setChecked(prefs.rememberLastMidiConnections);
       proximity->setValue(prefs.proximity);
+      undoMemoryBudget->setValue(int(MScore::undoMemoryBudget / (1024 * 1024)));
+      Score* cs = mscore->currentScore();
+      if (cs)
+            undoMemoryUsage->setText(tr("Current score: %1 MB").arg(double(cs->undo()->memoryUsage()) / (1024 * 1024), 0, 'f', 1));
+      else
+            undoMemoryUsage->setText("");
       autoSave->setChecked(prefs.autoSave);
       autoSaveTime->setValue(prefs.autoSaveTime);
       pngResolution->setValue(prefs.pngResolution);
@@ -1356,6 +1368,7 @@ void PreferenceDialog::apply()
       prefs.midiPorts          = midiPorts->value();
       prefs.rememberLastMidiConnections = rememberLastMidiConnections->isChecked();
       prefs.proximity          = proximity->value();
+      MScore::undoMemoryBudget = size_t(undoMemoryBudget->value()) * 1024 * 1024;
       prefs.autoSave           = autoSave->isChecked();
       prefs.autoSaveTime       = autoSaveTime->value();
       prefs.pngResolution      = pngResolution->value();
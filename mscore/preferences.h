@@ -155,6 +155,7 @@ struct Preferences {
       QString styleName;
       int globalStyle;        // 0 - dark, 1 - light
       bool animations;
+      QString traceFile;      // write trace spans to this file at exit
 
       QString myScoresPath;
       QString myStylesPath;
@@ -12,6 +12,7 @@
 
 #include "libmscore/score.h"
 #include "seq.h"
+#include "synthesizer/msynthesizer.h"
 #include <pulse/pulseaudio.h>
 #include "driver.h"
 #include "preferences.h"
@@ -35,6 +36,7 @@ class PulseAudio : public Driver {
       pthread_t thread;
 
       static void paCallback(pa_stream* s, size_t len, void* data);
+      static void underflowCallback(pa_stream* s, void* data);
       static void* paLoop(void*);
 
    public:
@@ -64,6 +66,16 @@ void PulseAudio::paCallback(pa_stream* s, size_t len, void* data)
       pa_stream_write(s, p, len, NULL, 0LL, PA_SEEK_RELATIVE);
       }
 
+//---------------------------------------------------------
+//   underflowCallback
+//---------------------------------------------------------
+
+void PulseAudio::underflowCallback(pa_stream*, void* data)
+      {
+      PulseAudio* pa = (PulseAudio*)data;
+      pa->seq->synti()->stats()->xrun();
+      }
+
 //---------------------------------------------------------
 //   PulseAudio
 //---------------------------------------------------------
@@ -141,6 +153,7 @@ bool PulseAudio::init()
             return false;
             }
       pa_stream_set_write_callback(playstream, paCallback, this);
+      pa_stream_set_underflow_callback(playstream, underflowCallback, this);
 
       bufattr.fragsize  = (uint32_t)-1;
       bufattr.maxlength = FRAMES * 2 * sizeof(float);
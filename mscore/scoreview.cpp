@@ -81,6 +81,7 @@
 #include "libmscore/stafftype.h"
 
 #include "inspector/inspector.h"
+#include "libmscore/trace.h"
 
 namespace Ms {
 
@@ -669,6 +670,11 @@ ScoreView::ScoreView(QWidget* parent)
       _curLoopOut = new PositionCursor(this);
       _curLoopOut->setType(CursorType::LOOP_OUT);
 
+      layoutTimer = new QTimer(this);
+      layoutTimer->setSingleShot(true);
+      layoutTimer->setInterval(0);
+      connect(layoutTimer, SIGNAL(timeout()), SLOT(layoutPendingPages()));
+
       //---setup state machine-------------------------------------------------
       sm          = new QStateMachine(this);
       QState* stateActive = new QState;
@@ -1586,6 +1592,7 @@ static void paintElement(void* data, Element* e)
 
 void ScoreView::paintEvent(QPaintEvent* ev)
       {
+      TRACE("ScoreView::paintEvent");
       if (!_score)
             return;
       QPainter vp(this);
@@ -1776,6 +1783,7 @@ void ScoreView::paintPageBorder(QPainter& p, Page* page)
 
 void ScoreView::paint(const QRect& r, QPainter& p)
       {
+      TRACE("ScoreView::paint");
       p.save();
       if (fgPixmap == 0 || fgPixmap->isNull())
             p.fillRect(r, _fgColor);
@@ -1803,6 +1811,14 @@ void ScoreView::paint(const QRect& r, QPainter& p)
                         continue;
                   if (pr.left() > fr.right())
                         break;
+                  if (page->layoutPending()) {
+                        // placeholder until layoutPendingPages() has
+                        // finished the page
+                        p.fillRect(page->canvasBoundingRect(), QColor(0, 0, 0, 20));
+                        layoutTimer->start();
+                        r1 -= _matrix.mapRect(pr).toAlignedRect();
+                        continue;
+                        }
                   QList<Element*> ell = page->items(fr.translated(-page->pos()));
                   qStableSort(ell.begin(), ell.end(), elementLessThan);
                   QPointF pos(page->pos());
@@ -2517,6 +2533,7 @@ void ScoreView::cmd(const QAction* a)
       QString cmd(a ? a->data().toString() : "");
       if (MScore::debugMode)
             qDebug("ScoreView::cmd <%s>", qPrintable(cmd));
+      finishPendingLayout();
 
       if (cmd == "escape")
             sm->postEvent(new CommandEvent(cmd));
@@ -3891,6 +3908,17 @@ void ScoreView::exitState()
 
 bool ScoreView::event(QEvent* event)
       {
+      switch (event->type()) {
+            case QEvent::MouseButtonPress:
+            case QEvent::MouseButtonDblClick:
+            case QEvent::KeyPress:
+            case QEvent::DragEnter:
+            case QEvent::Drop:
+                  finishPendingLayout();
+                  break;
+            default:
+                  break;
+            }
       if (event->type() == QEvent::KeyPress && editObject) {
             QKeyEvent* ke = static_cast<QKeyEvent*>(event);
             if (ke->key() == Qt::Key_Tab || ke->key() == Qt::Key_Backtab) {
@@ -5317,6 +5345,77 @@ void ScoreView::layoutChanged()
       {
       if (mscore->navigator())
             mscore->navigator()->layoutChanged();
+      if (_score && _score->nextPendingPage())
+            layoutTimer->start();
+      }
+
+//---------------------------------------------------------
+//   layoutPendingPages
+//    finish one page left pending by progressive layout,
+//    visible pages first; restarts itself until all
+//    pages are done
+//---------------------------------------------------------
+
+void ScoreView::layoutPendingPages()
+      {
+      if (!_score)
+            return;
+      QRectF fr = imatrix.mapRect(QRectF(rect()));
+      Page* page = 0;
+      foreach (Page* p, _score->pages()) {
+            if (p->layoutPending() && fr.intersects(p->abbox().translated(p->pos()))) {
+                  page = p;
+                  break;
+                  }
+            }
+      if (!page)
+            page = _score->nextPendingPage();
+      if (page) {
+            _score->layoutPendingPage(page);
+            update(_matrix.mapRect(page->abbox().translated(page->pos())).toAlignedRect());
+            layoutTimer->start();
+            }
+      else {
+            _score->finishLayout();
+            if (mscore->navigator())
+                  mscore->navigator()->update();
+            }
+      }
+
+//---------------------------------------------------------
+//   layoutVisiblePages
+//    finish all visible pages left pending by progressive
+//    layout at once, e.g. after a jump with the navigator
+//---------------------------------------------------------
+
+void ScoreView::layoutVisiblePages()
+      {
+      if (!_score || !_score->nextPendingPage())
+            return;
+      QRectF fr = imatrix.mapRect(QRectF(rect()));
+      foreach (Page* p, _score->pages()) {
+            if (p->layoutPending() && fr.intersects(p->abbox().translated(p->pos())))
+                  _score->layoutPendingPage(p);
+            }
+      }
+
+//---------------------------------------------------------
+//   finishPendingLayout
+//    input can select or edit elements on any page,
+//    also through keyboard navigation and commands: lay
+//    out all pages left pending by progressive layout
+//    before it is handled
+//---------------------------------------------------------
+
+void ScoreView::finishPendingLayout()
+      {
+      if (!_score || !_score->nextPendingPage())
+            return;
+      layoutTimer->stop();
+      _score->finishLayout();
+      update();
+      if (mscore->navigator())
+            mscore->navigator()->update();
       }
 
 //---------------------------------------------------------
@@ -5508,6 +5607,10 @@ Element* ScoreView::elementNear(QPointF p)
             // qDebug("  no page");
             return 0;
             }
+      // the shapes and the bsp tree of a pending page are
+      // not laid out yet
+      if (page->layoutPending())
+            _score->layoutPendingPage(page);
 
       p -= page->pos();
       double w  = (preferences.proximity * .5) / matrix().m11();
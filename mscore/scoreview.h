@@ -178,6 +178,11 @@ class ScoreView : public QWidget, public MuseScoreView {
       QPixmap* bgPixmap;
       QPixmap* fgPixmap;
 
+      QTimer* layoutTimer;    ///< finishes pages left pending by progressive layout
+
+      void finishPendingLayout();
+      void layoutVisiblePages();
+
       virtual void paintEvent(QPaintEvent*);
       void paint(const QRect&, QPainter&);
 
@@ -263,6 +268,7 @@ class ScoreView : public QWidget, public MuseScoreView {
 
       void posChanged(POS pos, unsigned tick);
       void loopToggled(bool);
+      void layoutPendingPages();
 
    public slots:
       void setViewRect(const QRectF&);
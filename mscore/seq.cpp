@@ -44,6 +44,7 @@
 #include "pianoroll.h"
 
 #include "click.h"
+#include "libmscore/trace.h"
 
 #include <vorbis/vorbisfile.h>
 
@@ -501,6 +502,7 @@ void Seq::playEvent(const NPlayEvent& event)
 
 void Seq::processMessages()
       {
+      TRACE("Seq::processMessages");
       for (;;) {
             if (toSeq.isEmpty())
                   break;
@@ -646,6 +648,8 @@ void Seq::addCountInClicks()
 
 void Seq::process(unsigned n, float* buffer)
       {
+      TRACE("Seq::process");
+      AudioCallbackTimer timer(_synti->stats(), n, MScore::sampleRate);
       unsigned frames = n;
       int driverState = _driver->getState();
 
@@ -32,6 +32,9 @@ extern bool useFactorySettings;
 
 static std::vector<const char*> effectNames = { "None", "Freeverb", "Zita1" };
 
+enum { STATS_CALLBACKS, STATS_BUFFER, STATS_LOAD, STATS_MAX_LOAD, STATS_MISSED,
+       STATS_XRUNS, STATS_HISTOGRAM, STATS_SYNTHESIZERS, STATS_EFFECTS };
+
 //---------------------------------------------------------
 //   SynthControl
 //---------------------------------------------------------
@@ -77,6 +80,7 @@ SynthControl::SynthControl(QWidget* parent)
             settings.endGroup();
             }
 
+      createStatsTab();
       updateGui();
 
       tabWidget->setCurrentIndex(0);
@@ -96,6 +100,111 @@ SynthControl::SynthControl(QWidget* parent)
       connect(gain,         SIGNAL(valueChanged(double,int)), SLOT(setDirty()));
       }
 
+//---------------------------------------------------------
+//   createStatsTab
+//    timing of the audio callbacks, to choose a buffer
+//    size for the driver
+//---------------------------------------------------------
+
+void SynthControl::createStatsTab()
+      {
+      QWidget* w = new QWidget;
+      QVBoxLayout* layout = new QVBoxLayout(w);
+      statsList = new QTreeWidget;
+      statsList->setColumnCount(2);
+      statsList->setHeaderLabels(QStringList() << tr("Audio Callback") << tr("Value"));
+      statsList->setRootIsDecorated(true);
+      layout->addWidget(statsList);
+      QHBoxLayout* hl = new QHBoxLayout;
+      hl->addStretch();
+      QPushButton* reset = new QPushButton(tr("Reset"));
+      hl->addWidget(reset);
+      layout->addLayout(hl);
+
+      QStringList labels;
+      labels << tr("Callbacks") << tr("Buffer size") << tr("Average load")
+             << tr("Maximum load") << tr("Missed deadlines") << tr("Driver overruns")
+             << tr("Load histogram") << tr("Synthesizers") << tr("Effects");
+      foreach (const QString& s, labels)
+            new QTreeWidgetItem(statsList, QStringList(s));
+
+      QTreeWidgetItem* histogram = statsList->topLevelItem(STATS_HISTOGRAM);
+      for (int i = 0; i < AudioStats::BUCKETS; ++i) {
+            QString s = i == AudioStats::BUCKETS - 1
+               ? QString(">= %1%").arg(i * 10)
+               : QString("%1 - %2%").arg(i * 10).arg((i + 1) * 10);
+            new QTreeWidgetItem(histogram, QStringList(s));
+            }
+      QTreeWidgetItem* synths = statsList->topLevelItem(STATS_SYNTHESIZERS);
+      int idx = 0;
+      for (Synthesizer* s : synti->synthesizer()) {
+            if (idx++ == AudioStats::MAX_SYNTHS)
+                  break;
+            new QTreeWidgetItem(synths, QStringList(tr(s->name())));
+            }
+      QTreeWidgetItem* effects = statsList->topLevelItem(STATS_EFFECTS);
+      for (int i = 0; i < AudioStats::MAX_EFFECTS; ++i)
+            new QTreeWidgetItem(effects);
+      statsList->expandAll();
+      statsList->resizeColumnToContents(0);
+
+      tabWidget->addTab(w, tr("Performance"));
+
+      statsTimer = new QTimer(this);
+      statsTimer->setInterval(500);
+      connect(statsTimer, SIGNAL(timeout()), SLOT(updateStats()));
+      connect(reset,      SIGNAL(clicked()), SLOT(resetStats()));
+      statsTimer->start();
+      }
+
+//---------------------------------------------------------
+//   updateStats
+//---------------------------------------------------------
+
+void SynthControl::updateStats()
+      {
+      if (!statsList->isVisible())
+            return;
+      const AudioStats* st = synti->stats();
+      quint64 callbacks = st->callbacks();
+      unsigned frames   = st->frames();
+      QString percent("%1%");
+
+      statsList->topLevelItem(STATS_CALLBACKS)->setText(1, QString::number(callbacks));
+      statsList->topLevelItem(STATS_BUFFER)->setText(1, frames == 0 ? QString() :
+         tr("%1 frames (%2 ms)").arg(frames).arg(frames * 1000.0 / MScore::sampleRate, 0, 'f', 1));
+      statsList->topLevelItem(STATS_LOAD)->setText(1, percent.arg(st->load() * 100.0, 0, 'f', 1));
+      statsList->topLevelItem(STATS_MAX_LOAD)->setText(1, percent.arg(st->maxLoad() * 100.0, 0, 'f', 1));
+      statsList->topLevelItem(STATS_MISSED)->setText(1, QString::number(st->missed()));
+      statsList->topLevelItem(STATS_XRUNS)->setText(1, QString::number(st->xruns()));
+
+      QTreeWidgetItem* histogram = statsList->topLevelItem(STATS_HISTOGRAM);
+      for (int i = 0; i < AudioStats::BUCKETS; ++i) {
+            quint64 n = st->histogram(i);
+            histogram->child(i)->setText(1, QString("%1 (%2%)").arg(n)
+               .arg(callbacks ? n * 100.0 / callbacks : 0.0, 0, 'f', 1));
+            }
+      QTreeWidgetItem* synths = statsList->topLevelItem(STATS_SYNTHESIZERS);
+      for (int i = 0; i < synths->childCount(); ++i)
+            synths->child(i)->setText(1, percent.arg(st->synthLoad(i) * 100.0, 0, 'f', 1));
+      QTreeWidgetItem* effects = statsList->topLevelItem(STATS_EFFECTS);
+      for (int i = 0; i < AudioStats::MAX_EFFECTS; ++i) {
+            Effect* e = synti->effect(i);
+            effects->child(i)->setText(0, QString("%1: %2").arg(QChar('A' + i)).arg(e ? tr(e->name()) : tr("None")));
+            effects->child(i)->setText(1, percent.arg(st->effectLoad(i) * 100.0, 0, 'f', 1));
+            }
+      }
+
+//---------------------------------------------------------
+//   resetStats
+//---------------------------------------------------------
+
+void SynthControl::resetStats()
+      {
+      synti->stats()->reset();
+      updateStats();
+      }
+
 //---------------------------------------------------------
 //   setGain
 //---------------------------------------------------------
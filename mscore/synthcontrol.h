@@ -35,9 +35,13 @@ class SynthControl : public QWidget, Ui::SynthControl {
       Q_OBJECT
 
       Score* _score;
+      QTreeWidget* statsList;
+      QTimer* statsTimer;
+
       virtual void closeEvent(QCloseEvent*);
       void updateGui();
       void updateUpDownButtons();
+      void createStatsTab();
 
    private slots:
       void gainChanged(double, int);
@@ -50,6 +54,8 @@ class SynthControl : public QWidget, Ui::SynthControl {
       void storeButtonClicked();
       void recallButtonClicked();
       void setDirty();
+      void updateStats();
+      void resetStats();
 
    signals:
       void gainChanged(float);
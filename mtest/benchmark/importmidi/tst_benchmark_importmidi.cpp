@@ -0,0 +1,237 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "libmscore/mscore.h"
+#include "libmscore/score.h"
+#include "mtest/testutils.h"
+#include "mscore/importmidi_fraction.h"
+#include "mscore/importmidi_chord.h"
+#include "mscore/importmidi_tuplet.h"
+#include "mtest/importmidi/inner_func_decl.h"
+#include "mscore/importmidi_data.h"
+#include "mscore/preferences.h"
+
+namespace Ms {
+      extern Score::FileError importMidi(Score*, const QString&);
+      }
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestBenchmarkImportMidi
+//    time of the MIDI import, of its chord maps and of the
+//    tuplet search
+//---------------------------------------------------------
+
+class TestBenchmarkImportMidi : public QObject, public MTest
+      {
+      Q_OBJECT
+
+   private slots:
+      void initTestCase();
+      void fractionMap();
+      void tickMap();
+      void import();
+      void pathologicalBar();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestBenchmarkImportMidi::initTestCase()
+      {
+      initMTest();
+      }
+
+//--------------------------------------------------------------------------
+      // chord maps
+
+            // the same on times as ReducedFraction, which compares on
+            // its grid ticks, and as plain integer ticks of a common
+            // denominator (1/48 of a whole note covers 16ths and 8th
+            // triplets); the gap between both benchmarks is the cost of
+            // the fraction keys in the chord maps
+
+static std::vector<std::pair<int, int>> benchmarkOnTimes()
+      {
+      std::vector<std::pair<int, int>> times;    // <numerator, denominator>
+      for (int beat = 0; beat != 20000; ++beat) {
+            const int notes = (beat % 2) ? 3 : 4;
+            for (int i = 0; i != notes; ++i)
+                  times.push_back({beat * notes + i, notes * 4});
+            }
+      return times;
+      }
+
+void TestBenchmarkImportMidi::fractionMap()
+      {
+      const auto times = benchmarkOnTimes();
+      QBENCHMARK {
+            std::multimap<ReducedFraction, int> chords;
+            for (const auto &t: times)
+                  chords.insert({ReducedFraction(t.first, t.second), t.first});
+            int found = 0;
+            for (const auto &t: times) {
+                  const ReducedFraction onTime(t.first, t.second);
+                  if (chords.lower_bound(onTime + ReducedFraction(1, 48)) != chords.end())
+                        ++found;
+                  }
+            QVERIFY(found > 0);
+            }
+      }
+
+void TestBenchmarkImportMidi::tickMap()
+      {
+      const int lcm = 48;
+      const auto times = benchmarkOnTimes();
+      QBENCHMARK {
+            std::multimap<int, int> chords;
+            for (const auto &t: times)
+                  chords.insert({t.first * (lcm / t.second), t.first});
+            int found = 0;
+            for (const auto &t: times) {
+                  const int onTime = t.first * (lcm / t.second);
+                  if (chords.lower_bound(onTime + 1) != chords.end())
+                        ++found;
+                  }
+            QVERIFY(found > 0);
+            }
+      }
+
+//--------------------------------------------------------------------------
+      // import of a generated file
+
+static void appendVarLen(QByteArray &data, int value)
+      {
+      QByteArray bytes(1, char(value & 0x7f));
+      while (value >>= 7)
+            bytes.prepend(char((value & 0x7f) | 0x80));
+      data.append(bytes);
+      }
+
+static void appendInt(QByteArray &data, int value, int bytes)
+      {
+      for (int i = bytes - 1; i >= 0; --i)
+            data.append(char((value >> (i * 8)) & 0xff));
+      }
+
+            // a track of humanized 16ths and triplets, one beat each
+
+static QByteArray benchmarkTrack(int bars, int basePitch)
+      {
+      const int division = 480;
+      QByteArray events;
+      int lastTick = 0;
+      int n = 0;
+      for (int beat = 0; beat != bars * 4; ++beat) {
+            const int notes = (beat % 2) ? 3 : 4;
+            const int len = division / notes;
+            for (int i = 0; i != notes; ++i, ++n) {
+                  const int onTime = qMax(lastTick, beat * division + i * len + (n * 7) % 11 - 5);
+                  const int offTime = onTime + len - 10 - (n * 3) % 7;
+                  const int pitch = basePitch + (n * 5) % 12;
+                  appendVarLen(events, onTime - lastTick);
+                  events.append(char(0x90)).append(char(pitch)).append(char(80));
+                  appendVarLen(events, offTime - onTime);
+                  events.append(char(0x80)).append(char(pitch)).append(char(0));
+                  lastTick = offTime;
+                  }
+            }
+      appendVarLen(events, 0);
+      events.append(char(0xff)).append(char(0x2f)).append(char(0));
+
+      QByteArray track("MTrk");
+      appendInt(track, events.size(), 4);
+      track.append(events);
+      return track;
+      }
+
+void TestBenchmarkImportMidi::import()
+      {
+      const int bars = 500;
+      QByteArray data("MThd");
+      appendInt(data, 6, 4);
+      appendInt(data, 1, 2);        // format
+      appendInt(data, 2, 2);        // tracks
+      appendInt(data, 480, 2);      // division
+      data.append(benchmarkTrack(bars, 60));
+      data.append(benchmarkTrack(bars, 36));
+
+      QTemporaryDir dir;
+      QVERIFY(dir.isValid());
+      const QString fileName = QDir(dir.path()).filePath("benchmark.mid");
+      QFile file(fileName);
+      QVERIFY(file.open(QIODevice::WriteOnly));
+      file.write(data);
+      file.close();
+
+      preferences.midiImportOperations.clear();
+      auto &midiData = preferences.midiImportOperations.midiData();
+      QBENCHMARK {
+                        // read and quantize the file again every time
+            midiData.excludeFile(fileName);
+            Score* score = new Score(mscore->baseStyle());
+            QCOMPARE(importMidi(score, fileName), Score::FILE_NO_ERROR);
+            QVERIFY(score->lastMeasure());
+            delete score;
+            }
+      midiData.excludeFile(fileName);
+      preferences.midiImportOperations.clear();
+      }
+
+//--------------------------------------------------------------------------
+      // tuplet search
+
+            // 4/4 bar where every beat has chords on the triplet, quintuplet
+            // and septuplet grid: many overlapping tuplet candidates
+
+static std::multimap<ReducedFraction, MidiChord> pathologicalChords()
+      {
+      const ReducedFraction beatLen = ReducedFraction::fromTicks(MScore::division);
+      std::multimap<ReducedFraction, MidiChord> chords;
+      int pitch = 60;
+      for (int beat = 0; beat != 4; ++beat) {
+            for (int tupletNumber: {3, 5, 7}) {
+                  const ReducedFraction noteLen = beatLen / tupletNumber;
+                  for (int i = 0; i != tupletNumber; ++i) {
+                        const ReducedFraction onTime = beatLen * beat + noteLen * i;
+                        MidiChord chord;
+                        for (int p: {pitch, pitch + 4, pitch + 7}) {
+                              MidiNote note;
+                              note.offTime = onTime + noteLen;
+                              note.pitch = p;
+                              chord.notes.push_back(note);
+                              }
+                        chords.insert({onTime, chord});
+                        pitch = 48 + (pitch + 5) % 24;
+                        }
+                  }
+            }
+      return chords;
+      }
+
+void TestBenchmarkImportMidi::pathologicalBar()
+      {
+      const ReducedFraction barFraction(4, 4);
+      const auto bar = pathologicalChords();
+      QBENCHMARK {
+            auto chords = bar;
+            MidiTuplet::findTuplets({0, 1}, barFraction, barFraction, chords,
+                                    MidiTuplet::SEARCH_NODE_LIMIT, nullptr);
+            }
+      }
+
+QTEST_MAIN(TestBenchmarkImportMidi)
+#include "tst_benchmark_importmidi.moc"
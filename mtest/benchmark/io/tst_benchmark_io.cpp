@@ -0,0 +1,399 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <atomic>
+#include <functional>
+#include <new>
+#include <cstdlib>
+#ifndef Q_OS_WIN
+#include <sys/resource.h>
+#endif
+#include "config.h"
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/scoregenerator.h"
+#include "synthesizer/event.h"
+#include "mscore/exportmidi.h"
+#include "mscore/preferences.h"
+
+using namespace Ms;
+
+namespace Ms {
+      extern Score::FileError importMidi(Score*, const QString&);
+      extern bool saveXml(Score*, const QString&);
+      }
+
+//---------------------------------------------------------
+//   operator new counters
+//    all operator new calls of the process; Qt containers
+//    and C code allocate with malloc and are not counted
+//---------------------------------------------------------
+
+static std::atomic<quint64> operatorNewCalls(0);
+static std::atomic<quint64> operatorNewBytes(0);
+
+void* operator new(size_t size)
+      {
+      operatorNewCalls.fetch_add(1, std::memory_order_relaxed);
+      operatorNewBytes.fetch_add(size, std::memory_order_relaxed);
+      if (void* p = malloc(size ? size : 1))
+            return p;
+      throw std::bad_alloc();
+      }
+
+void operator delete(void* p) noexcept
+      {
+      free(p);
+      }
+
+//---------------------------------------------------------
+//   resetPeakRss
+//    on Linux the peak can be reset per measurement,
+//    elsewhere the peak of the process is reported
+//---------------------------------------------------------
+
+static void resetPeakRss()
+      {
+#ifdef Q_OS_LINUX
+      QFile f("/proc/self/clear_refs");
+      if (f.open(QIODevice::WriteOnly))
+            f.write("5");
+#endif
+      }
+
+//---------------------------------------------------------
+//   peakRss
+//    in kB
+//---------------------------------------------------------
+
+static qint64 peakRss()
+      {
+#ifdef Q_OS_LINUX
+      QFile f("/proc/self/status");
+      if (f.open(QIODevice::ReadOnly)) {
+            foreach (const QByteArray& line, f.readAll().split('\n')) {
+                  if (line.startsWith("VmHWM:"))
+                        return line.mid(6).trimmed().split(' ').first().toLongLong();
+                  }
+            }
+#endif
+#ifndef Q_OS_WIN
+      struct rusage ru;
+      getrusage(RUSAGE_SELF, &ru);
+      return ru.ru_maxrss;
+#else
+      return 0;
+#endif
+      }
+
+//---------------------------------------------------------
+//   Result
+//    all runs of one operation on one input
+//---------------------------------------------------------
+
+struct Result {
+      QString operation;
+      QString input;
+      QList<qint64> wallNs;
+      QList<qint64> newCalls;
+      QList<qint64> newBytes;
+      qint64 peakRss;
+
+      Result(const QString& op, const QString& in)
+         : operation(op), input(in), peakRss(0) {}
+      QJsonObject toJson() const;
+      };
+
+//---------------------------------------------------------
+//   minMedian
+//    smallest and median value of all runs
+//---------------------------------------------------------
+
+static QPair<qint64, qint64> minMedian(QList<qint64> values)
+      {
+      if (values.isEmpty())
+            return QPair<qint64, qint64>(0, 0);
+      qSort(values);
+      return QPair<qint64, qint64>(values.first(), values[values.size() / 2]);
+      }
+
+//---------------------------------------------------------
+//   toJson
+//---------------------------------------------------------
+
+QJsonObject Result::toJson() const
+      {
+      const QPair<qint64, qint64> t = minMedian(wallNs);
+      const QPair<qint64, qint64> c = minMedian(newCalls);
+      const QPair<qint64, qint64> b = minMedian(newBytes);
+      QJsonObject o;
+      o["operation"]              = operation;
+      o["input"]                  = input;
+      o["runs"]                   = wallNs.size();
+      o["wallMsMin"]              = t.first / 1e6;
+      o["wallMsMedian"]           = t.second / 1e6;
+      o["operatorNewCallsMin"]    = double(c.first);
+      o["operatorNewCallsMedian"] = double(c.second);
+      o["operatorNewBytesMin"]    = double(b.first);
+      o["operatorNewBytesMedian"] = double(b.second);
+      o["peakRssKb"]              = double(peakRss);
+      return o;
+      }
+
+//---------------------------------------------------------
+//   Probe
+//    measure one run
+//---------------------------------------------------------
+
+class Probe {
+      QElapsedTimer timer;
+      quint64 a;
+      quint64 b;
+
+   public:
+      Probe() {
+            resetPeakRss();
+            a = operatorNewCalls.load();
+            b = operatorNewBytes.load();
+            timer.start();
+            }
+      void stop(Result* r) {
+            r->wallNs.append(timer.nsecsElapsed());
+            r->newCalls.append(operatorNewCalls.load() - a);
+            r->newBytes.append(operatorNewBytes.load() - b);
+            r->peakRss = qMax(r->peakRss, peakRss());
+            }
+      };
+
+//---------------------------------------------------------
+//   TestBenchmarkIo
+//    time, operator new calls and peak memory of the importers,
+//    layout, save, MIDI rendering, MusicXML and MIDI export
+//    over the test corpora and over generated scores.
+//
+//    Environment:
+//      MTEST_BENCHMARK_OUTPUT  result file (benchmark_io.json)
+//      MTEST_BENCHMARK_REPEAT  runs per measurement (3)
+//      MTEST_BENCHMARK_SCALE   measures of the generated
+//                              scores (100,1000)
+//      MTEST_BENCHMARK_PARTS   parts of the generated
+//                              scores (8)
+//---------------------------------------------------------
+
+class TestBenchmarkIo : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      int repeat;
+      QList<Result> results;
+
+      Score* importFile(const QString& path);
+      void operations(Score*, const QString& input);
+      void measure(const QString& op, const QString& input, std::function<bool()> f);
+
+   private slots:
+      void initTestCase();
+      void corpus_data();
+      void corpus();
+      void generated_data();
+      void generated();
+      void cleanupTestCase();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestBenchmarkIo::initTestCase()
+      {
+      initMTest();
+      bool ok;
+      repeat = qgetenv("MTEST_BENCHMARK_REPEAT").toInt(&ok);
+      if (!ok || repeat < 1)
+            repeat = 3;
+      }
+
+//---------------------------------------------------------
+//   importFile
+//    path relative to mtest
+//---------------------------------------------------------
+
+Score* TestBenchmarkIo::importFile(const QString& path)
+      {
+      if (!path.endsWith(".mid"))
+            return readScore(path);
+      Score* s = new Score(mscore->baseStyle());
+      s->setName(path);
+      if (importMidi(s, root + "/" + path) != Score::FILE_NO_ERROR) {
+            delete s;
+            return 0;
+            }
+      return s;
+      }
+
+//---------------------------------------------------------
+//   measure
+//    run f repeat times
+//---------------------------------------------------------
+
+void TestBenchmarkIo::measure(const QString& op, const QString& input, std::function<bool()> f)
+      {
+      Result r(op, input);
+      for (int i = 0; i < repeat; ++i) {
+            Probe p;
+            bool ok = f();
+            p.stop(&r);
+            QVERIFY2(ok, qPrintable(op + " " + input));
+            }
+      results.append(r);
+      }
+
+//---------------------------------------------------------
+//   operations
+//    measure layout, midi rendering and all exports of
+//    score
+//---------------------------------------------------------
+
+void TestBenchmarkIo::operations(Score* score, const QString& input)
+      {
+      measure("layout", input, [score]() { score->doLayout(); return true; });
+      measure("renderMidi", input, [score]() {
+            EventMap events;
+            score->renderMidi(&events);
+            return !events.empty();
+            });
+      measure("save", input, [this, score]() { return saveScore(score, "benchmark.mscx"); });
+      measure("exportMusicXml", input, [score]() { return saveXml(score, "benchmark.xml"); });
+      measure("exportMidi", input, [score]() {
+            ExportMidi em(score);
+            return em.write("benchmark.mid", true);
+            });
+      }
+
+//---------------------------------------------------------
+//   corpus
+//---------------------------------------------------------
+
+void TestBenchmarkIo::corpus_data()
+      {
+      QTest::addColumn<QString>("file");
+      static const char* dirs[][2] = {
+            { "guitarpro",   "*.gp3 *.gp4 *.gp5" },
+            { "capella/io",  "*.cap *.capx"      },
+            { "musicxml/io", "*.xml"             },
+            { "importmidi",  "*.mid"             },
+            };
+      for (auto d : dirs) {
+            QDir dir(root + "/" + d[0]);
+            QStringList files = dir.entryList(QString(d[1]).split(' '), QDir::Files, QDir::Name);
+            foreach (const QString& file, files) {
+                  if (file.endsWith("_ref.xml"))
+                        continue;
+                  QString path = QString(d[0]) + "/" + file;
+                  QTest::newRow(qPrintable(path)) << path;
+                  }
+            }
+      }
+
+void TestBenchmarkIo::corpus()
+      {
+      QFETCH(QString, file);
+      measure("import", file, [this, file]() {
+            Score* s = importFile(file);
+            delete s;
+            return s != 0;
+            });
+      Score* score = importFile(file);
+      QVERIFY(score);
+      operations(score, file);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   generated
+//    a score of the ScoreGenerator, saved and loaded
+//    again like any other input
+//---------------------------------------------------------
+
+void TestBenchmarkIo::generated_data()
+      {
+      QTest::addColumn<int>("measures");
+      QByteArray scale = qgetenv("MTEST_BENCHMARK_SCALE");
+      if (scale.isEmpty())
+            scale = "100,1000";
+      foreach (const QByteArray& n, scale.split(','))
+            QTest::newRow(n.constData()) << n.toInt();
+      }
+
+void TestBenchmarkIo::generated()
+      {
+      QFETCH(int, measures);
+      ScoreGenerator gen;
+      gen.measures = measures;
+      bool ok;
+      gen.parts = qgetenv("MTEST_BENCHMARK_PARTS").toInt(&ok);
+      if (!ok || gen.parts < 1)
+            gen.parts = 8;
+      QString input = QString("generated-%1x%2").arg(gen.parts).arg(measures);
+      QString file  = input + ".mscx";
+      Score* score  = gen.create();
+      score->doLayout();
+      QVERIFY(saveScore(score, file));
+      QVERIFY(saveXml(score, input + ".xml"));
+      delete score;
+
+      measure("import", file, [this, file]() {
+            Score* s = readCreatedScore(file);
+            delete s;
+            return s != 0;
+            });
+      measure("import", input + ".xml", [this, input]() {
+            Score* s = readCreatedScore(input + ".xml");
+            delete s;
+            return s != 0;
+            });
+      score = readCreatedScore(file);
+      QVERIFY(score);
+      operations(score, file);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   cleanupTestCase
+//    write the results
+//---------------------------------------------------------
+
+void TestBenchmarkIo::cleanupTestCase()
+      {
+      QJsonArray a;
+      foreach (const Result& r, results)
+            a.append(r.toJson());
+      QJsonObject o;
+      o["date"]    = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+      o["version"] = QString(VERSION);
+      o["repeat"]  = repeat;
+      o["results"] = a;
+
+      QString name = QString::fromLocal8Bit(qgetenv("MTEST_BENCHMARK_OUTPUT"));
+      if (name.isEmpty())
+            name = "benchmark_io.json";
+      QFile f(name);
+      QVERIFY(f.open(QIODevice::WriteOnly));
+      f.write(QJsonDocument(o).toJson());
+      qDebug("benchmark results written to <%s>", qPrintable(QFileInfo(f).absoluteFilePath()));
+      }
+
+QTEST_MAIN(TestBenchmarkIo)
+#include "tst_benchmark_io.moc"
+
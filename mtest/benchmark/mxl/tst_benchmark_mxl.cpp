@@ -0,0 +1,126 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+
+using namespace Ms;
+
+namespace Ms {
+      extern bool saveMxl(Score*, const QString&);
+      }
+
+//---------------------------------------------------------
+//   procStatus
+//    a field of /proc/self/status in kB, 0 where there
+//    is no such file
+//---------------------------------------------------------
+
+static qint64 procStatus(const char* field)
+      {
+#ifdef Q_OS_LINUX
+      QFile f("/proc/self/status");
+      if (f.open(QIODevice::ReadOnly)) {
+            foreach (const QByteArray& line, f.readAll().split('\n')) {
+                  if (line.startsWith(field))
+                        return line.mid(int(strlen(field))).trimmed().split(' ').first().toLongLong();
+                  }
+            }
+#else
+      Q_UNUSED(field);
+#endif
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   resetPeakRss
+//    let VmHWM start again at the current resident size
+//---------------------------------------------------------
+
+static void resetPeakRss()
+      {
+#ifdef Q_OS_LINUX
+      QFile f("/proc/self/clear_refs");
+      if (f.open(QIODevice::WriteOnly))
+            f.write("5");
+#endif
+      }
+
+//---------------------------------------------------------
+//   TestBenchmarkMxl
+//    time and memory of the compressed MusicXML export
+//    of a large score.
+//
+//    Environment:
+//      MTEST_BENCHMARK_SCALE   measures appended to the
+//                              score (200)
+//---------------------------------------------------------
+
+class TestBenchmarkMxl : public QObject, public MTest
+      {
+      Q_OBJECT
+
+   private slots:
+      void initTestCase();
+      void exportMxl();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestBenchmarkMxl::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   exportMxl
+//    the memory numbers cover the export only: resident
+//    size before it, peak during it and resident size
+//    after it (Linux only)
+//---------------------------------------------------------
+
+void TestBenchmarkMxl::exportMxl()
+      {
+      bool ok;
+      int measures = qgetenv("MTEST_BENCHMARK_SCALE").toInt(&ok);
+      if (!ok || measures < 0)
+            measures = 200;
+
+      QTemporaryDir dir;
+      QVERIFY(dir.isValid());
+      QString file = dir.path() + "/benchmark.mxl";
+
+      Score* score = readScore("libmscore/concertpitch/concertpitchbenchmark.mscx");
+      QVERIFY(score);
+      score->appendMeasures(measures);
+      score->doLayout();
+
+      QBENCHMARK {
+            QVERIFY(saveMxl(score, file));
+            }
+
+      qint64 before = procStatus("VmRSS:");
+      resetPeakRss();
+      QVERIFY(saveMxl(score, file));
+      qint64 peak  = procStatus("VmHWM:");
+      qint64 after = procStatus("VmRSS:");
+      qDebug("mxl export of %d measures: %lld bytes, resident %lld kB before, peak %lld kB (+%lld kB), %lld kB after",
+         score->measures()->size(), QFileInfo(file).size(), before, peak, peak - before, after);
+      delete score;
+      }
+
+QTEST_MAIN(TestBenchmarkMxl)
+#include "tst_benchmark_mxl.moc"
@@ -0,0 +1,87 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/scoregenerator.h"
+#include "synthesizer/event.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestBenchmarkScaling
+//---------------------------------------------------------
+
+class TestBenchmarkScaling : public QObject, public MTest
+      {
+      Q_OBJECT
+
+   private slots:
+      void initTestCase();
+      void scaling();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestBenchmarkScaling::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   scaling
+//    time per measure of layout, save, load and midi
+//    rendering at doubling sizes; a growing time per
+//    measure shows super-linear behavior
+//---------------------------------------------------------
+
+void TestBenchmarkScaling::scaling()
+      {
+      qDebug("measures  layout    save    load    midi   (ms per 100 measures)");
+      for (int measures = 125; measures <= 1000; measures *= 2) {
+            ScoreGenerator gen;
+            gen.measures = measures;
+            gen.parts    = 8;
+            Score* score = gen.create();
+            QElapsedTimer t;
+
+            t.start();
+            score->doLayout();
+            double layout = t.elapsed();
+
+            t.start();
+            QVERIFY(saveScore(score, "scoregenerator-scaling.mscx"));
+            double save = t.elapsed();
+
+            t.start();
+            EventMap events;
+            score->renderMidi(&events);
+            double midi = t.elapsed();
+            delete score;
+
+            t.start();
+            score = readCreatedScore("scoregenerator-scaling.mscx");
+            double load = t.elapsed();
+            QVERIFY(score);
+            delete score;
+
+            double f = 100.0 / measures;
+            qDebug("%8d %7.1f %7.1f %7.1f %7.1f", measures, layout * f, save * f, load * f, midi * f);
+            }
+      }
+
+QTEST_MAIN(TestBenchmarkScaling)
+#include "tst_benchmark_scaling.moc"
@@ -0,0 +1,189 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "mscore/convertercache.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestConverterCache
+//---------------------------------------------------------
+
+class TestConverterCache : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QTemporaryDir tmp;
+      QString score;
+      QString style;
+      QDir outDir;
+      QDir srcDir;
+
+      QString path(const QString& name) const { return QDir(tmp.path()).filePath(name); }
+      void writeFile(const QString& path, const QByteArray& data);
+      QByteArray readFile(const QString& path);
+      QByteArray key(const QString& outFile, const QStringList& options);
+
+   private slots:
+      void initTestCase();
+      void hitAndMiss();
+      void invalidation();
+      void eviction();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestConverterCache::initTestCase()
+      {
+      initMTest();
+      QVERIFY(tmp.isValid());
+      QDir(tmp.path()).mkdir("out");
+      QDir(tmp.path()).mkdir("src");
+      outDir = QDir(path("out"));
+      srcDir = QDir(path("src"));
+      score  = path("score.mscx");
+      style  = path("score.mss");
+      writeFile(score, "<museScore/>");
+      writeFile(style, "<museScore/>");
+      }
+
+//---------------------------------------------------------
+//   writeFile
+//---------------------------------------------------------
+
+void TestConverterCache::writeFile(const QString& path, const QByteArray& data)
+      {
+      QFile f(path);
+      QVERIFY(f.open(QIODevice::WriteOnly));
+      f.write(data);
+      }
+
+//---------------------------------------------------------
+//   readFile
+//---------------------------------------------------------
+
+QByteArray TestConverterCache::readFile(const QString& path)
+      {
+      QFile f(path);
+      if (!f.open(QIODevice::ReadOnly))
+            return QByteArray();
+      return f.readAll();
+      }
+
+//---------------------------------------------------------
+//   key
+//---------------------------------------------------------
+
+QByteArray TestConverterCache::key(const QString& outFile, const QStringList& options)
+      {
+      ConverterCache cache(path("cache"));
+      cache.setKey(score, outDir.filePath(outFile), QStringList(style), options);
+      return cache.key();
+      }
+
+//---------------------------------------------------------
+//   hitAndMiss
+//    a stored conversion is restored without running it
+//---------------------------------------------------------
+
+void TestConverterCache::hitAndMiss()
+      {
+      QStringList options("dpi=300");
+      ConverterCache cache(path("cache"));
+      QVERIFY(cache.setKey(score, outDir.filePath("hit.pdf"), QStringList(style), options));
+      QVERIFY(!cache.restore(outDir));
+
+      writeFile(srcDir.filePath("hit.pdf"), "pdf");
+      QVERIFY(cache.store(srcDir, outDir));
+      QCOMPARE(readFile(outDir.filePath("hit.pdf")), QByteArray("pdf"));
+      QFile::remove(srcDir.filePath("hit.pdf"));
+      QFile::remove(outDir.filePath("hit.pdf"));
+
+      ConverterCache cache2(path("cache"));
+      QVERIFY(cache2.setKey(score, outDir.filePath("hit.pdf"), QStringList(style), options));
+      QVERIFY(cache2.restore(outDir));
+      QCOMPARE(readFile(outDir.filePath("hit.pdf")), QByteArray("pdf"));
+
+      ConverterCache cache3(path("cache"));
+      QVERIFY(!cache3.setKey(path("missing.mscx"), outDir.filePath("hit.pdf"), QStringList(style), options));
+      QVERIFY(!cache3.restore(outDir));
+      }
+
+//---------------------------------------------------------
+//   invalidation
+//    every input of a conversion is part of the key
+//---------------------------------------------------------
+
+void TestConverterCache::invalidation()
+      {
+      QStringList options;
+      options << "dpi=300" << "pngTransparent=1" << "musicxmlExportLayout=1"
+              << "exportAudioSampleRate=44100" << "soundfont=/sf/a.sf2 100 1";
+      QByteArray k = key("a.png", options);
+      QCOMPARE(key("a.png", options), k);
+      QVERIFY(key("b.png", options) != k);
+
+      for (int i = 0; i < options.size(); ++i) {
+            QStringList o(options);
+            o[i] += "0";
+            QVERIFY(key("a.png", o) != k);
+            }
+      QVERIFY(key("a.png", options.mid(0, 4)) != k);
+
+      writeFile(style, "<museScore version=\"2.0\"/>");
+      QVERIFY(key("a.png", options) != k);
+      writeFile(style, "<museScore/>");
+      QCOMPARE(key("a.png", options), k);
+
+      writeFile(score, "<museScore version=\"2.0\"/>");
+      QVERIFY(key("a.png", options) != k);
+      writeFile(score, "<museScore/>");
+      QCOMPARE(key("a.png", options), k);
+      }
+
+//---------------------------------------------------------
+//   eviction
+//    the oldest entries are removed, the newest one is
+//    kept
+//---------------------------------------------------------
+
+void TestConverterCache::eviction()
+      {
+      QString dir = path("evict");
+      QByteArray data(1000, 'x');
+      QByteArray last;
+      for (int i = 0; i < 5; ++i) {
+            ConverterCache cache(dir, 2500);
+            QString name = QString("evict%1.pdf").arg(i);
+            QVERIFY(cache.setKey(score, outDir.filePath(name), QStringList(), QStringList()));
+            writeFile(srcDir.filePath(name), data);
+            QVERIFY(cache.store(srcDir, outDir));
+            QFile::remove(srcDir.filePath(name));
+            last = cache.key();
+            }
+      QFileInfoList l = QDir(dir).entryInfoList(QStringList("*.mscc"), QDir::Files);
+      qint64 size = 0;
+      foreach (const QFileInfo& fi, l)
+            size += fi.size();
+      QVERIFY(l.size() >= 1 && l.size() <= 2);
+      QVERIFY(size <= 2500);
+      QVERIFY(QFile::exists(QDir(dir).filePath(QString::fromLatin1(last) + ".mscc")));
+      }
+
+QTEST_MAIN(TestConverterCache)
+#include "tst_convertercache.moc"
+
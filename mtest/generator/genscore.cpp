@@ -0,0 +1,119 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/scoregenerator.h"
+#include "mscore/exportmidi.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   GenScore
+//---------------------------------------------------------
+
+class GenScore : public MTest {
+   public:
+      GenScore() { initMTest(); }
+      bool write(Score* score, const QString& name);
+      };
+
+//---------------------------------------------------------
+//   write
+//    format depends on the file extension
+//---------------------------------------------------------
+
+bool GenScore::write(Score* score, const QString& name)
+      {
+      if (name.endsWith(".xml"))
+            return saveMusicXml(score, name);
+      if (name.endsWith(".mid")) {
+            ExportMidi em(score);
+            return em.write(name, true);
+            }
+      return saveScore(score, name);
+      }
+
+//---------------------------------------------------------
+//   usage
+//---------------------------------------------------------
+
+static void usage()
+      {
+      ScoreGenerator g;
+      fprintf(stderr, "Usage: genscore flags file.mscx|file.xml|file.mid\n"
+        "   Flags:\n"
+        "   -m n      measures (%d)\n"
+        "   -p n      parts, one staff each (%d)\n"
+        "   -s n      random seed (%u)\n"
+        "   -n n      max notes per chord (%d)\n"
+        "   -t n      percent of beats with triplets (%d)\n"
+        "   -l n      percent of chords starting a slur (%d)\n"
+        "   -y n      percent of chords with lyrics (%d)\n"
+        "   -c n      percent of half measures with chord symbols (%d)\n",
+        g.measures, g.parts, g.seed, g.chordNotes, g.tuplets, g.slurs, g.lyrics, g.harmonies);
+      exit(-1);
+      }
+
+//---------------------------------------------------------
+//   main
+//---------------------------------------------------------
+
+int main(int argc, char* argv[])
+      {
+      QApplication app(argc, argv);
+      QStringList args = app.arguments();
+      args.removeFirst();
+
+      ScoreGenerator gen;
+      QString name;
+      while (!args.isEmpty()) {
+            QString s = args.takeFirst();
+            if (!s.startsWith("-") || s.size() != 2) {
+                  if (!name.isEmpty())
+                        usage();
+                  name = s;
+                  continue;
+                  }
+            if (args.isEmpty())
+                  usage();
+            bool ok;
+            int val = args.takeFirst().toInt(&ok);
+            if (!ok || val < 0)
+                  usage();
+            switch (s[1].toLatin1()) {
+                  case 'm': gen.measures   = val; break;
+                  case 'p': gen.parts      = val; break;
+                  case 's': gen.seed       = val; break;
+                  case 'n': gen.chordNotes = val; break;
+                  case 't': gen.tuplets    = val; break;
+                  case 'l': gen.slurs      = val; break;
+                  case 'y': gen.lyrics     = val; break;
+                  case 'c': gen.harmonies  = val; break;
+                  default:
+                        usage();
+                  }
+            }
+      if (name.isEmpty() || gen.measures < 1 || gen.parts < 1 || gen.chordNotes < 1)
+            usage();
+
+      GenScore gs;
+      Score* score = gen.create();
+      score->doLayout();
+      bool rv = gs.write(score, name);
+      if (!rv)
+            fprintf(stderr, "genscore: cannot write <%s>\n", qPrintable(name));
+      delete score;
+      return rv ? 0 : -1;
+      }
+
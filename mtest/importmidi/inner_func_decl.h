@@ -12,6 +12,7 @@ class ReducedFraction;
 namespace MidiTuplet {
 
 struct TupletInfo;
+struct TupletData;
 
 std::pair<std::multimap<ReducedFraction, MidiChord>::iterator, ReducedFraction>
 findBestChordForTupletNote(const ReducedFraction &tupletNotePos,
@@ -37,6 +38,13 @@ void splitFirstTupletChords(std::vector<TupletInfo> &tuplets,
 
 std::set<int> findLongestUncommonGroup(const std::vector<TupletInfo> &tuplets);
 
+std::vector<TupletData> findTuplets(const ReducedFraction &startBarTick,
+                                    const ReducedFraction &endBarTick,
+                                    const ReducedFraction &barFraction,
+                                    std::multimap<ReducedFraction, MidiChord> &chords,
+                                    int searchNodeLimit,
+                                    bool *isSearchLimitReached);
+
 } // namespace MidiTuplet
 
 namespace Meter {
@@ -30,6 +30,7 @@
 #include "mscore/importmidi_meter.h"
 #include "mscore/importmidi_inner.h"
 #include "mscore/importmidi_fraction.h"
+#include "mscore/importmidi_data.h"
 #include "mscore/preferences.h"
 
 
@@ -73,6 +74,9 @@ class TestImportMidi : public QObject, public MTest
             preferences.midiImportOperations.clear();
             }
 
+      // reimport with changed operations, quantized tracks are cached
+      void reimportQuantization();
+
       // test tuplet recognition functions
       void findChordInBar();
       void bestChordForTupletNote();
@@ -82,6 +86,12 @@ class TestImportMidi : public QObject, public MTest
       void findTupletApproximation();
       void separateTupletVoices();
       void findLongestUncommonGroup();
+      void tupletSearchLimit();
+
+      // fraction arithmetic
+      void fractionCompare();
+      void fractionSameDenominator();
+      void fractionOffGrid();
 
       // metric bar analysis
       void metricDivisionsOfTuplet();
@@ -260,6 +270,84 @@ void TestImportMidi::mf(const char* name)
       delete score;
       }
 
+//---------------------------------------------------------
+//   quantizedTrackIndex
+//    index of the first track with a cached quantization
+//---------------------------------------------------------
+
+static int quantizedTrackIndex(const QString &fileName)
+      {
+      const auto &midiData = preferences.midiImportOperations.midiData();
+      for (int i = 0; i != 16; ++i) {
+            if (midiData.quantizedTrack(fileName, i))
+                  return i;
+            }
+      return -1;
+      }
+
+//---------------------------------------------------------
+//   reimportQuantization
+//    a reimport must not reuse tracks quantized with other
+//    operations, but reuses them for the same operations
+//---------------------------------------------------------
+
+void TestImportMidi::reimportQuantization()
+      {
+      const int defaultQuant = preferences.shortestNote;
+      const QString fileName = TESTROOT "/mtest/" + DIR + "quant_dotted_4th.mid";
+      auto &midiData = preferences.midiImportOperations.midiData();
+      preferences.midiImportOperations.clear();
+      midiData.excludeFile(fileName);
+      Score* score = new Score(mscore->baseStyle());
+      score->setName("quant_dotted_4th");
+      QCOMPARE(importMidi(score, fileName), Score::FILE_NO_ERROR);
+      delete score;
+
+      const int track = quantizedTrackIndex(fileName);
+      QVERIFY(track >= 0);
+      const QByteArray defaultKey = midiData.quantizedTrack(fileName, track)->key;
+      QVERIFY(!midiData.quantizedTrack(fileName, track)->chords.empty());
+
+                  // other operations: a new key
+      preferences.shortestNote = MScore::division;
+      TrackOperations opers;
+      opers.quantize.reduceToShorterNotesInBar = false;
+      preferences.midiImportOperations.appendTrackOperations(opers);
+      mf("quant_dotted_4th");
+      QVERIFY(midiData.quantizedTrack(fileName, track));
+      const QByteArray key = midiData.quantizedTrack(fileName, track)->key;
+      QVERIFY(key != defaultKey);
+
+                  // same operations: same key and result
+      mf("quant_dotted_4th");
+      QVERIFY(midiData.quantizedTrack(fileName, track));
+      QCOMPARE(midiData.quantizedTrack(fileName, track)->key, key);
+
+                  // the cached track is used as it is: replace it with
+                  // its first chord only and import again
+      QuantizedTrack cached = *midiData.quantizedTrack(fileName, track);
+      QVERIFY(cached.chords.size() > 1);
+      cached.chords.erase(std::next(cached.chords.begin()), cached.chords.end());
+      midiData.setQuantizedTrack(fileName, track, cached);
+      score = new Score(mscore->baseStyle());
+      QCOMPARE(importMidi(score, fileName), Score::FILE_NO_ERROR);
+      delete score;
+      QCOMPARE(midiData.quantizedTrack(fileName, track)->chords.size(), size_t(1));
+
+                  // a changed key field forces a new quantization
+      preferences.shortestNote = MScore::division / 2;
+      score = new Score(mscore->baseStyle());
+      QCOMPARE(importMidi(score, fileName), Score::FILE_NO_ERROR);
+      delete score;
+      QVERIFY(midiData.quantizedTrack(fileName, track));
+      QVERIFY(midiData.quantizedTrack(fileName, track)->key != key);
+      QVERIFY(midiData.quantizedTrack(fileName, track)->chords.size() > 1);
+
+      preferences.shortestNote = defaultQuant;
+      preferences.midiImportOperations.clear();
+      midiData.excludeFile(fileName);
+      }
+
 //---------------------------------------------------------
 //  tuplet recognition fuctions
 //---------------------------------------------------------
@@ -637,6 +725,59 @@ void TestImportMidi::findLongestUncommonGroup()
       QVERIFY(result.size() == 1);
       }
 
+//--------------------------------------------------------------------------
+      // fraction arithmetic
+
+void TestImportMidi::fractionCompare()
+      {
+      QVERIFY(ReducedFraction(1, 3) < ReducedFraction(1, 2));
+      QVERIFY(ReducedFraction(2, 4) == ReducedFraction(1, 2));
+      QVERIFY(ReducedFraction(2, 4) <= ReducedFraction(1, 2));
+      QVERIFY(ReducedFraction(0, 1) == ReducedFraction(0, 7));
+      QVERIFY(ReducedFraction(-1, 3) < ReducedFraction(0, 1));
+      QVERIFY(ReducedFraction(1, -3) < ReducedFraction(1, 5));
+      QVERIFY(ReducedFraction(-1, -3) > ReducedFraction(1, 5));
+      QVERIFY(ReducedFraction(1, -2) == ReducedFraction(-1, 2));
+      QVERIFY(ReducedFraction(1, -2) != ReducedFraction(1, 2));
+                  // large values that overflow a common int denominator
+      QVERIFY(ReducedFraction(1000003, 1000033) < ReducedFraction(1000004, 1000033));
+      QVERIFY(ReducedFraction(1000000, 999983) < ReducedFraction(999999, 999979));
+      }
+
+void TestImportMidi::fractionSameDenominator()
+      {
+      const ReducedFraction a(25000, 1920);
+      const ReducedFraction b(7, 1920);
+      QCOMPARE((a + b).numerator(), 25007);
+      QCOMPARE((a + b).denominator(), 1920);
+      QCOMPARE((a - b).numerator(), 24993);
+      QCOMPARE((a - b).denominator(), 1920);
+      QVERIFY(a + ReducedFraction(1, 3) == ReducedFraction(25640, 1920));
+      QVERIFY(ReducedFraction::fromTicks(480) + ReducedFraction::fromTicks(960)
+              == ReducedFraction::fromTicks(1440));
+      }
+
+void TestImportMidi::fractionOffGrid()
+      {
+                  // 1/11 is off the common tick grid, results compare exactly
+      const ReducedFraction a(1, 11);
+      QVERIFY(a * 11 == ReducedFraction(1, 1));
+      QVERIFY(ReducedFraction(10, 11) + a == ReducedFraction::fromTicks(4 * MScore::division));
+      QVERIFY(ReducedFraction(1, 3) + a > ReducedFraction(1, 3));
+      QVERIFY(ReducedFraction(1, 3) + a < ReducedFraction(1, 2));
+      QVERIFY(ReducedFraction(-1, 11) < ReducedFraction(0, 1));
+      QCOMPARE((a + a).numerator(), 2);
+      QCOMPARE((a + a).denominator(), 11);
+                  // tuplet lengths stay on the grid
+      const ReducedFraction beat = ReducedFraction::fromTicks(MScore::division);
+      for (int tupletNumber = 2; tupletNumber != 10; ++tupletNumber) {
+            const ReducedFraction noteLen = beat / tupletNumber;
+            QVERIFY(noteLen * tupletNumber == beat);
+            QVERIFY(noteLen * (tupletNumber - 1) < beat);
+            QVERIFY(beat - noteLen + noteLen == beat);
+            }
+      }
+
 //--------------------------------------------------------------------------
       // tuplet voice separation
 
@@ -662,6 +803,55 @@ MidiChord chordFactory(const ReducedFraction &offTime, const std::vector<int> &p
       return chord;
       }
 
+// 4/4 bar where every beat has chords on the triplet, quintuplet
+// and septuplet grid: many overlapping tuplet candidates
+
+std::multimap<ReducedFraction, MidiChord> pathologicalBar()
+      {
+      const ReducedFraction beatLen = ReducedFraction::fromTicks(MScore::division);
+      std::multimap<ReducedFraction, MidiChord> chords;
+      int pitch = 60;
+      for (int beat = 0; beat != 4; ++beat) {
+            for (int tupletNumber: {3, 5, 7}) {
+                  const ReducedFraction noteLen = beatLen / tupletNumber;
+                  for (int i = 0; i != tupletNumber; ++i) {
+                        const ReducedFraction onTime = beatLen * beat + noteLen * i;
+                        chords.insert({onTime, chordFactory(onTime + noteLen,
+                                                            {pitch, pitch + 4, pitch + 7})});
+                        pitch = 48 + (pitch + 5) % 24;
+                        }
+                  }
+            }
+      return chords;
+      }
+
+void TestImportMidi::tupletSearchLimit()
+      {
+      const ReducedFraction barFraction(4, 4);
+      auto chords = pathologicalBar();
+      bool isLimitReached = false;
+                  // the search stops early but still yields a valid combination
+      const auto tuplets = MidiTuplet::findTuplets({0, 1}, barFraction, barFraction, chords,
+                                                   1, &isLimitReached);
+      QVERIFY(isLimitReached);
+      QVERIFY(!tuplets.empty());
+
+      for (size_t i = 0; i != tuplets.size(); ++i) {
+            const auto &t = tuplets[i];
+            QVERIFY(t.tupletNumber >= 2 && t.tupletNumber <= 9);
+            QVERIFY(t.len > ReducedFraction(0, 1));
+            QVERIFY(t.tupletQuant == t.len / t.tupletNumber);
+            QVERIFY(t.onTime >= ReducedFraction(0, 1));
+            QVERIFY(t.onTime + t.len <= barFraction);
+                        // tuplets of one voice don't overlap
+            for (size_t j = 0; j != i; ++j) {
+                  const auto &u = tuplets[j];
+                  if (u.voice == t.voice)
+                        QVERIFY(u.onTime >= t.onTime + t.len || t.onTime >= u.onTime + u.len);
+                  }
+            }
+      }
+
 void TestImportMidi::separateTupletVoices()
       {
       const ReducedFraction tupletLen = ReducedFraction::fromTicks(MScore::division);
@@ -0,0 +1,249 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/measure.h"
+#include "libmscore/system.h"
+#include "libmscore/layoutbreak.h"
+#include "libmscore/optimalbreaks.h"
+
+#define DIR QString("libmscore/concertpitch/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestBreaks
+//---------------------------------------------------------
+
+class TestBreaks : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      Score* bigScore(bool optimal);
+      void addLineBreaks(Score*, int measures);
+
+   private slots:
+      void initTestCase();
+      void balanced();
+      void raggedLast();
+      void overfull();
+      void layoutBreak();
+      void cacheBounded();
+      void benchmarkGreedy();
+      void benchmarkOptimal();
+      void benchmarkOptimalRelayout();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestBreaks::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   bigScore
+//    500+ pages
+//---------------------------------------------------------
+
+Score* TestBreaks::bigScore(bool optimal)
+      {
+      Score* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      score->appendMeasures(4000);
+      score->style()->set(ST_optimalBreaks, optimal);
+      score->doLayout();
+      return score;
+      }
+
+//---------------------------------------------------------
+//   addLineBreaks
+//    a line break after every measures measures
+//---------------------------------------------------------
+
+void TestBreaks::addLineBreaks(Score* score, int measures)
+      {
+      int n = 0;
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+            if (++n % measures)
+                  continue;
+            LayoutBreak* lb = new LayoutBreak(score);
+            lb->setLayoutBreakType(LayoutBreak::LINE);
+            lb->setTrack(0);
+            lb->setParent(m);
+            score->undoAddElement(lb);
+            }
+      score->doLayout();
+      }
+
+//---------------------------------------------------------
+//   balanced
+//    4 equal items, 3 fit on a line
+//---------------------------------------------------------
+
+void TestBreaks::balanced()
+      {
+      QVector<BreakItem> items;
+      for (int i = 0; i < 4; ++i)
+            items.append(BreakItem(30.0, 30.0));
+      // greedy: 3+1; optimal without ragged last line: 2+2
+      QList<int> breaks = OptimalBreaker::computeBreaks(items, 100.0, 0.0);
+      QCOMPARE(breaks.size(), 1);
+      QCOMPARE(breaks[0], 1);
+      }
+
+//---------------------------------------------------------
+//   raggedLast
+//---------------------------------------------------------
+
+void TestBreaks::raggedLast()
+      {
+      QVector<BreakItem> items;
+      for (int i = 0; i < 4; ++i)
+            items.append(BreakItem(30.0, 30.0));
+      // last line filled 30% -> no cost, so 3+1
+      QList<int> breaks = OptimalBreaker::computeBreaks(items, 100.0, 0.3);
+      QCOMPARE(breaks.size(), 1);
+      QCOMPARE(breaks[0], 2);
+      }
+
+//---------------------------------------------------------
+//   overfull
+//    an item wider than a line gets a line of its own
+//---------------------------------------------------------
+
+void TestBreaks::overfull()
+      {
+      QVector<BreakItem> items;
+      items.append(BreakItem(30.0, 30.0));
+      items.append(BreakItem(150.0, 150.0));
+      items.append(BreakItem(30.0, 30.0));
+      QList<int> breaks = OptimalBreaker::computeBreaks(items, 100.0, 0.0);
+      QCOMPARE(breaks.size(), 2);
+      QCOMPARE(breaks[0], 0);
+      QCOMPARE(breaks[1], 1);
+      }
+
+//---------------------------------------------------------
+//   layoutBreak
+//    optimal breaking must honor line breaks
+//---------------------------------------------------------
+
+void TestBreaks::layoutBreak()
+      {
+      Score* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      score->style()->set(ST_optimalBreaks, true);
+
+      Measure* m = score->firstMeasure()->nextMeasure()->nextMeasure();
+      LayoutBreak* lb = new LayoutBreak(score);
+      lb->setLayoutBreakType(LayoutBreak::LINE);
+      lb->setTrack(0);
+      lb->setParent(m);
+      score->undoAddElement(lb);
+      score->doLayout();
+
+      QVERIFY(m->system() != m->nextMeasure()->system());
+      qreal w = score->pageFormat()->printableWidth() * MScore::DPI;
+      foreach (System* s, *score->systems())
+            QVERIFY(s->width() <= w + 0.1);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   cacheBounded
+//    plans of deleted paragraphs are dropped from the
+//    cache
+//---------------------------------------------------------
+
+void TestBreaks::cacheBounded()
+      {
+      Score* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      score->appendMeasures(400);
+      score->style()->set(ST_optimalBreaks, true);
+      addLineBreaks(score, 20);
+      int paragraphs = score->lineBreaker().size();
+      QVERIFY(paragraphs >= 20);
+
+      // replace all measures but the first twenty
+      for (int i = 0; i < 3; ++i) {
+            Measure* m = score->firstMeasure();
+            for (int k = 0; k < 20; ++k)
+                  m = m->nextMeasure();
+            score->startCmd();
+            score->undoRemoveMeasures(m, score->lastMeasure());
+            score->endCmd();
+            score->appendMeasures(400);
+            addLineBreaks(score, 20);
+            score->doLayout();
+            }
+      QVERIFY(score->lineBreaker().size() <= paragraphs + 2);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   benchmarkGreedy
+//---------------------------------------------------------
+
+void TestBreaks::benchmarkGreedy()
+      {
+      Score* score = bigScore(false);
+      QVERIFY(score->npages() >= 500);
+      QBENCHMARK {
+            score->doLayout();
+            }
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   benchmarkOptimal
+//---------------------------------------------------------
+
+void TestBreaks::benchmarkOptimal()
+      {
+      Score* score = bigScore(true);
+      QVERIFY(score->npages() >= 500);
+      QBENCHMARK {
+            score->doLayout();
+            }
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   benchmarkOptimalRelayout
+//    relayout after changing the stretch of one measure;
+//    the score is split into paragraphs by line breaks,
+//    all paragraphs but the edited one come from the cache
+//---------------------------------------------------------
+
+void TestBreaks::benchmarkOptimalRelayout()
+      {
+      Score* score = bigScore(true);
+      addLineBreaks(score, 32);
+      Measure* m = score->firstMeasure();
+      for (int i = 0; i < 100; ++i)
+            m = m->nextMeasure();
+      qreal stretch = m->userStretch();
+      QBENCHMARK {
+            stretch = stretch > 1.0 ? 1.0 : 1.5;
+            m->setUserStretch(stretch);
+            score->doLayout();
+            }
+      delete score;
+      }
+
+QTEST_MAIN(TestBreaks)
+#include "tst_breaks.moc"
+
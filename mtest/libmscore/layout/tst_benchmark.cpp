@@ -14,6 +14,9 @@
 #include <QtTest/QtTest>
 #include "mtest/testutils.h"
 #include "libmscore/score.h"
+#include "libmscore/page.h"
+#include "libmscore/segment.h"
+#include "libmscore/chordrest.h"
 
 #define DIR QString("libmscore/layout/")
 
@@ -33,12 +36,17 @@ class TestBenchmark : public QObject, public MTest
 
       Score* score;
       void beam(const char* path);
+      Score* bigScore();
 
    private slots:
       void initTestCase();
       void benchmark3();
       void benchmark1();
       void benchmark2();
+      void progressive();
+      void editNotPending();
+      void benchmarkProgressive();
+      void timeToFirstPage();
       };
 
 //---------------------------------------------------------
@@ -82,6 +90,114 @@ void TestBenchmark::benchmark2()
             }
       }
 
+//---------------------------------------------------------
+//   bigScore
+//---------------------------------------------------------
+
+Score* TestBenchmark::bigScore()
+      {
+      Score* s = readScore("libmscore/concertpitch/concertpitchbenchmark.mscx");
+      s->appendMeasures(1000);
+      return s;
+      }
+
+//---------------------------------------------------------
+//   progressive
+//    progressive layout places the same pages; all pages
+//    are pending until finished
+//---------------------------------------------------------
+
+void TestBenchmark::progressive()
+      {
+      Score* s = bigScore();
+      s->doLayout();
+      int pages = s->npages();
+      s->setProgressiveLayout(true);
+      s->doLayout();
+      QCOMPARE(s->npages(), pages);
+      QVERIFY(s->nextPendingPage() == s->pages().front());
+      s->layoutPendingPage(s->pages().back());
+      QVERIFY(!s->pages().back()->layoutPending());
+      QVERIFY(s->nextPendingPage() == s->pages().front());
+      s->finishLayout();
+      QVERIFY(s->nextPendingPage() == 0);
+      delete s;
+      }
+
+//---------------------------------------------------------
+//   editNotPending
+//    only the first layout is progressive; the relayout
+//    after an edit lays out all pages
+//---------------------------------------------------------
+
+void TestBenchmark::editNotPending()
+      {
+      Score* s = bigScore();
+      QVERIFY(s->nmeasures() > 200);
+      s->setProgressiveLayout(true);
+      s->doLayout();
+      QVERIFY(s->nextPendingPage() != 0);
+      QVERIFY(!s->progressiveLayout());
+
+      ChordRest* cr = s->firstSegment(Segment::SegChordRest)->cr(0);
+      QVERIFY(cr);
+      s->startCmd();
+      s->undoChangeProperty(cr, P_USER_OFF, QPointF(1.0, 0.0));
+      s->setLayoutAll(true);
+      s->endCmd();
+      QVERIFY(s->nextPendingPage() == 0);
+
+      s->undo()->undo();
+      s->endUndoRedo();
+      QVERIFY(s->nextPendingPage() == 0);
+      delete s;
+      }
+
+//---------------------------------------------------------
+//   benchmarkProgressive
+//    time to first page
+//---------------------------------------------------------
+
+void TestBenchmark::benchmarkProgressive()
+      {
+      Score* s = bigScore();
+      QBENCHMARK {
+            s->setProgressiveLayout(true);
+            s->doLayout();
+            s->layoutPendingPage(s->pages().front());
+            }
+      delete s;
+      }
+
+//---------------------------------------------------------
+//   timeToFirstPage
+//    wall time until the first page can be shown, with a
+//    full and with a progressive layout of the same score
+//---------------------------------------------------------
+
+void TestBenchmark::timeToFirstPage()
+      {
+      Score* s = bigScore();
+      s->doLayout();                      // warm up caches
+      QElapsedTimer t;
+      t.start();
+      s->doLayout();
+      qint64 full = t.elapsed();
+
+      t.restart();
+      s->setProgressiveLayout(true);
+      s->doLayout();
+      s->layoutPendingPage(s->pages().front());
+      qint64 firstPage = t.elapsed();
+      s->finishLayout();
+      qint64 total = t.elapsed();
+
+      qDebug("%d measures, %d pages: full layout %lld ms, first page %lld ms, all pages %lld ms",
+         s->nmeasures(), s->npages(), full, firstPage, total);
+      QVERIFY(s->nextPendingPage() == 0);
+      delete s;
+      }
+
 QTEST_MAIN(TestBenchmark)
 #include "tst_benchmark.moc"
 
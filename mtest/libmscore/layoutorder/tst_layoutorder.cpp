@@ -0,0 +1,246 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/staff.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/note.h"
+#include "libmscore/beam.h"
+#include "libmscore/tie.h"
+
+#define DIR QString("libmscore/layoutorder/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   SegmentOrderScore
+//    places beams, stems, ties, slurs and articulations
+//    in the former order: all segments once per track,
+//    bar lines in their track pass, annotations in the
+//    pass of the last track
+//---------------------------------------------------------
+
+class SegmentOrderScore : public Score
+      {
+   protected:
+      virtual void placeSpannerAndBeams();
+
+   public:
+      SegmentOrderScore(const MStyle* s) : Score(s) {}
+      };
+
+//---------------------------------------------------------
+//   placeSpannerAndBeams
+//---------------------------------------------------------
+
+void SegmentOrderScore::placeSpannerAndBeams()
+      {
+      int tracks = nstaves() * VOICES;
+      for (int track = 0; track < tracks; ++track) {
+            for (Segment* segment = firstSegmentMM(); segment; segment = segment->next1MM()) {
+                  if (track == tracks - 1) {
+                        for (Element* e : segment->annotations())
+                              e->layout();
+                        }
+                  Element* e = segment->element(track);
+                  if (!e)
+                        continue;
+                  if (e->isChordRest()) {
+                        if (!staff(track2staff(track))->show())
+                              continue;
+                        ChordRest* cr = static_cast<ChordRest*>(e);
+                        if (cr->beam() && cr->beam()->elements().front() == cr)
+                              cr->beam()->layout();
+                        if (cr->type() == Element::CHORD) {
+                              Chord* c = static_cast<Chord*>(cr);
+                              for (Chord* cc : c->graceNotes()) {
+                                    if (cc->beam() && cc->beam()->elements().front() == cc)
+                                          cc->beam()->layout();
+                                    for (Element* e : cc->el()) {
+                                          if (e->type() == Element::SLUR)
+                                                e->layout();
+                                          }
+                                    }
+                              c->layoutStem();
+                              c->layoutArpeggio2();
+                              for (Note* n : c->notes()) {
+                                    if (n->tieFor())
+                                          n->tieFor()->layout();
+                                    for (Spanner* sp : n->spannerFor())
+                                          sp->layout();
+                                    }
+                              }
+                        cr->layoutArticulations();
+                        }
+                  else if (e->type() == Element::BAR_LINE)
+                        e->layout();
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   TestLayoutOrder
+//    doLayout() places beams, stems, ties, slurs and
+//    articulations track by track and the annotations
+//    after all tracks. The result must be the same as
+//    with the former order, which visited all segments
+//    once per track and laid out annotations and bar
+//    lines during those passes.
+//---------------------------------------------------------
+
+class TestLayoutOrder : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QStringList dump(Score*);
+      Score* load(Score*);
+
+   private slots:
+      void initTestCase();
+      void sameLayout();
+      void stableLayout();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestLayoutOrder::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   collectElement
+//---------------------------------------------------------
+
+static void collectElement(void* data, Element* e)
+      {
+      QStringList* l = static_cast<QStringList*>(data);
+      QPointF p = e->pagePos();
+      QRectF r  = e->bbox();
+      l->append(QString("%1 track %2: %3 %4 %5 %6 %7 %8")
+         .arg(e->name()).arg(e->track())
+         .arg(p.x(), 0, 'f', 3).arg(p.y(), 0, 'f', 3)
+         .arg(r.x(), 0, 'f', 3).arg(r.y(), 0, 'f', 3)
+         .arg(r.width(), 0, 'f', 3).arg(r.height(), 0, 'f', 3));
+      }
+
+//---------------------------------------------------------
+//   dump
+//    position and size of all laid out elements
+//---------------------------------------------------------
+
+QStringList TestLayoutOrder::dump(Score* score)
+      {
+      QStringList l;
+      score->scanElements(&l, collectElement, false);
+      return l;
+      }
+
+//---------------------------------------------------------
+//   load
+//    read the test score into score, which is not laid
+//    out yet
+//---------------------------------------------------------
+
+Score* TestLayoutOrder::load(Score* score)
+      {
+      QString path = root + "/" + DIR + "layoutorder.mscx";
+      score->setName(path);
+      if (score->loadMsc(path, false) != Score::FILE_NO_ERROR) {
+            delete score;
+            return 0;
+            }
+      score->updateNotes();
+      return score;
+      }
+
+//---------------------------------------------------------
+//   sameLayout
+//    beams and ties in two voices and on two staves,
+//    a slur, chord symbols, staff text in voice 2 and
+//    dynamics on the second staff. Two fresh copies of
+//    the score are laid out, one in each order.
+//---------------------------------------------------------
+
+void TestLayoutOrder::sameLayout()
+      {
+      Score* score = load(new Score(mscore->baseStyle()));
+      QVERIFY(score);
+      score->doLayout();
+      QStringList tracked = dump(score);
+
+      // tie and slur segments are both SlurSegments
+      int beams = 0, segments = 0, annotations = 0;
+      for (const QString& s : tracked) {
+            if (s.startsWith("Beam "))
+                  ++beams;
+            else if (s.startsWith("SlurSegment "))
+                  ++segments;
+            else if (s.startsWith("Harmony ") || s.startsWith("StaffText ") || s.startsWith("Dynamic "))
+                  ++annotations;
+            }
+      int ties = 0;
+      for (Segment* s = score->firstSegment(Segment::SegChordRest); s; s = s->next1(Segment::SegChordRest)) {
+            for (int track = 0; track < score->ntracks(); ++track) {
+                  Element* e = s->element(track);
+                  if (e && e->type() == Element::CHORD) {
+                        for (Note* n : static_cast<Chord*>(e)->notes()) {
+                              if (n->tieFor() && n->tieFor()->endNote())
+                                    ++ties;
+                              }
+                        }
+                  }
+            }
+      QVERIFY(beams >= 16);
+      QVERIFY(ties >= 14);
+      QVERIFY(segments >= ties + 2);
+      QVERIFY(annotations >= 11);
+
+      Score* segmentOrderScore = load(new SegmentOrderScore(mscore->baseStyle()));
+      QVERIFY(segmentOrderScore);
+      segmentOrderScore->doLayout();
+      QStringList segmentOrder = dump(segmentOrderScore);
+      QCOMPARE(segmentOrder.size(), tracked.size());
+      for (int i = 0; i < tracked.size(); ++i)
+            QCOMPARE(tracked[i], segmentOrder[i]);
+      delete segmentOrderScore;
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   stableLayout
+//    a second layout does not move anything
+//---------------------------------------------------------
+
+void TestLayoutOrder::stableLayout()
+      {
+      Score* score = readScore(DIR + "layoutorder.mscx");
+      QVERIFY(score);
+      score->doLayout();
+      QStringList first = dump(score);
+      score->doLayout();
+      QStringList second = dump(score);
+      QCOMPARE(second.size(), first.size());
+      for (int i = 0; i < first.size(); ++i)
+            QCOMPARE(second[i], first[i]);
+      delete score;
+      }
+
+QTEST_MAIN(TestLayoutOrder)
+#include "tst_layoutorder.moc"
+
@@ -0,0 +1,130 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/tuplet.h"
+#include "libmscore/scoregenerator.h"
+#include "synthesizer/event.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestScoreGenerator
+//---------------------------------------------------------
+
+class TestScoreGenerator : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QByteArray generate(unsigned seed);
+
+   private slots:
+      void initTestCase();
+      void sameSeed();
+      void content();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestScoreGenerator::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   generate
+//    return the saved score
+//---------------------------------------------------------
+
+QByteArray TestScoreGenerator::generate(unsigned seed)
+      {
+      ScoreGenerator gen;
+      gen.measures = 16;
+      gen.seed     = seed;
+      Score* score = gen.create();
+      score->doLayout();
+      QString name = QString("scoregenerator-%1.mscx").arg(seed);
+      bool ok = saveScore(score, name);
+      delete score;
+      QFile f(name);
+      if (!ok || !f.open(QIODevice::ReadOnly))
+            return QByteArray();
+      return f.readAll();
+      }
+
+//---------------------------------------------------------
+//   sameSeed
+//    the same seed gives the same score
+//---------------------------------------------------------
+
+void TestScoreGenerator::sameSeed()
+      {
+      QByteArray s1 = generate(7);
+      QVERIFY(!s1.isEmpty());
+      QCOMPARE(generate(7), s1);
+      QVERIFY(generate(8) != s1);
+      }
+
+//---------------------------------------------------------
+//   content
+//---------------------------------------------------------
+
+void TestScoreGenerator::content()
+      {
+      ScoreGenerator gen;
+      gen.measures = 40;
+      gen.parts    = 3;
+      Score* score = gen.create();
+      score->doLayout();
+      QCOMPARE(score->nstaves(), 3);
+
+      int measures = 0;
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+            QCOMPARE(m->ticks(), 4 * MScore::division);
+            ++measures;
+            }
+      QCOMPARE(measures, 40);
+
+      int tuplets = 0, lyrics = 0, harmonies = 0;
+      for (Segment* s = score->firstSegment(Segment::SegChordRest); s; s = s->next1(Segment::SegChordRest)) {
+            harmonies += s->annotations().size();
+            for (int track = 0; track < score->ntracks(); ++track) {
+                  ChordRest* cr = static_cast<ChordRest*>(s->element(track));
+                  if (!cr)
+                        continue;
+                  if (cr->tuplet() && cr->tuplet()->elements().front() == cr)
+                        ++tuplets;
+                  lyrics += cr->lyricsList().size();
+                  }
+            }
+      QVERIFY(tuplets > 0);
+      QVERIFY(lyrics > 0);
+      QVERIFY(harmonies > 0);
+      QVERIFY(!score->spannerMap().map().empty());
+
+      EventMap events;
+      score->renderMidi(&events);
+      QVERIFY(!events.empty());
+      delete score;
+      }
+
+QTEST_MAIN(TestScoreGenerator)
+#include "tst_scoregenerator.moc"
+
@@ -0,0 +1,298 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/slur.h"
+#include "libmscore/hairpin.h"
+#include "libmscore/pedal.h"
+#include "libmscore/mcursor.h"
+#include "libmscore/durationtype.h"
+#include "synthesizer/event.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestSpannerMap
+//---------------------------------------------------------
+
+class TestSpannerMap : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      Score* spannerScore(int staves, int measures);
+
+   private slots:
+      void initTestCase();
+      void kindIndex();
+      void rangeAfterTickChange();
+      void layoutKeepsTree();
+      void constQuery();
+      void benchmarkLayout();
+      void benchmarkPlayEvents();
+      void benchmarkRenderMidi();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestSpannerMap::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   spannerScore
+//    quarter notes on all staves; a slur over every pair
+//    of chords and a hairpin in every measure
+//---------------------------------------------------------
+
+Score* TestSpannerMap::spannerScore(int staves, int measures)
+      {
+      MCursor c;
+      c.setTimeSig(Fraction(4,4));
+      c.createScore("spanners");
+      for (int i = 0; i < staves; ++i)
+            c.addPart("violin");
+      c.move(0, 0);
+      c.addKeySig(0);
+      c.addTimeSig(Fraction(4,4));
+      for (int staffIdx = 0; staffIdx < staves; ++staffIdx) {
+            c.move(staffIdx * VOICES, 0);
+            for (int i = 0; i < measures * 4; ++i)
+                  c.addChord(60 + i % 12, TDuration(TDuration::V_QUARTER));
+            }
+      Score* score = c.score();
+      for (int staffIdx = 0; staffIdx < staves; ++staffIdx) {
+            int track = staffIdx * VOICES;
+            Chord* c1 = 0;
+            for (Segment* s = score->firstSegment(Segment::SegChordRest); s; s = s->next1(Segment::SegChordRest)) {
+                  Chord* c2 = static_cast<Chord*>(s->element(track));
+                  if (c1) {
+                        Slur* slur = new Slur(score);
+                        slur->setTick(c1->tick());
+                        slur->setTick2(c2->tick());
+                        slur->setTrack(track);
+                        slur->setTrack2(track);
+                        slur->setStartElement(c1);
+                        slur->setEndElement(c2);
+                        score->addSpanner(slur);
+                        c1 = 0;
+                        }
+                  else
+                        c1 = c2;
+                  }
+            for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+                  Hairpin* h = new Hairpin(score);
+                  h->setHairpinType(Hairpin::CRESCENDO);
+                  h->setTrack(track);
+                  h->setTick(m->tick());
+                  h->setTick2(m->tick() + m->ticks() - MScore::division);
+                  score->addSpanner(h);
+                  }
+            }
+      score->addLayoutFlags(LAYOUT_FIX_PITCH_VELO | LAYOUT_PLAY_EVENTS);
+      score->doLayout();
+      return score;
+      }
+
+//---------------------------------------------------------
+//   kindIndex
+//    per type sets follow add and remove
+//---------------------------------------------------------
+
+void TestSpannerMap::kindIndex()
+      {
+      Score* score = spannerScore(2, 8);
+      SpannerMap& sm = score->spannerMap();
+      QCOMPARE(sm.slurs().size(), 2 * 8 * 2);
+      QCOMPARE(sm.hairpins().size(), 2 * 8);
+      QVERIFY(sm.pedals().isEmpty());
+      QVERIFY(sm.ottavas().isEmpty());
+
+      Pedal* pedal = new Pedal(score);
+      pedal->setTrack(0);
+      pedal->setTick(0);
+      pedal->setTick2(MScore::division * 4);
+      score->addSpanner(pedal);
+      QCOMPARE(sm.pedals().size(), 1);
+      QVERIFY(sm.pedals().contains(pedal));
+
+      Spanner* slur = *sm.slurs().begin();
+      score->removeSpanner(slur);
+      QCOMPARE(sm.slurs().size(), 2 * 8 * 2 - 1);
+      QVERIFY(!sm.slurs().contains(slur));
+      score->removeSpanner(pedal);
+      QVERIFY(sm.pedals().isEmpty());
+
+      delete pedal;
+      delete slur;
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   rangeAfterTickChange
+//    a range query must see a changed tick range
+//---------------------------------------------------------
+
+void TestSpannerMap::rangeAfterTickChange()
+      {
+      Score* score = spannerScore(1, 8);
+      SpannerMap& sm = score->spannerMap();
+      int farTick = score->lastMeasure()->endTick() + MScore::division * 100;
+      QVERIFY(sm.findOverlapping(farTick, farTick).empty());
+
+      Spanner* h = *sm.hairpins().begin();
+      h->setTick2(farTick);
+      bool found = false;
+      for (const ::Interval<Spanner*>& i : sm.findOverlapping(farTick, farTick))
+            found = found || i.value == h;
+      QVERIFY(found);
+
+      // removal with a stale start tick key
+      h->setTick(MScore::division);
+      QVERIFY(sm.removeSpanner(h));
+      QVERIFY(!sm.hairpins().contains(h));
+      for (const std::pair<int, Spanner*>& i : sm.map())
+            QVERIFY(i.second != h);
+      QVERIFY(sm.findOverlapping(farTick, farTick).empty());
+      delete h;
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   layoutKeepsTree
+//    the interval tree is rebuilt only after a tick of
+//    a spanner in the map really changed
+//---------------------------------------------------------
+
+void TestSpannerMap::layoutKeepsTree()
+      {
+      Score* score = spannerScore(1, 8);
+      SpannerMap& sm = score->spannerMap();
+      sm.findOverlapping(0, 0);
+      QVERIFY(!sm.isDirty());
+
+      score->doLayout();
+      QVERIFY(!sm.isDirty());
+
+      Spanner* h = *sm.hairpins().begin();
+      h->setTick(h->tick());
+      h->setTick2(h->tick2());
+      QVERIFY(!sm.isDirty());
+
+      // not in the map
+      Hairpin* nh = new Hairpin(score);
+      nh->setTrack(0);
+      nh->setTick(0);
+      nh->setTick2(MScore::division);
+      QVERIFY(!sm.isDirty());
+      delete nh;
+
+      h->setTick2(h->tick2() + MScore::division);
+      QVERIFY(sm.isDirty());
+      sm.findOverlapping(0, 0);
+
+      score->removeSpanner(h);
+      sm.findOverlapping(0, 0);
+      h->setTick(MScore::division * 2);
+      QVERIFY(!sm.isDirty());
+      delete h;
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   constQuery
+//    overlapping() finds the same spanners with and
+//    without a built tree and does not build it
+//---------------------------------------------------------
+
+void TestSpannerMap::constQuery()
+      {
+      Score* score = spannerScore(2, 8);
+      SpannerMap& sm = score->spannerMap();
+      const SpannerMap& csm = sm;
+      int start = MScore::division * 3;
+      int stop  = MScore::division * 9;
+
+      sm.setDirty();
+      QSet<Spanner*> scanned;
+      for (const ::Interval<Spanner*>& i : csm.overlapping(start, stop))
+            scanned.insert(i.value);
+      QVERIFY(sm.isDirty());
+      QVERIFY(!scanned.isEmpty());
+
+      csm.build();
+      QVERIFY(!sm.isDirty());
+      QSet<Spanner*> fromTree;
+      for (const ::Interval<Spanner*>& i : csm.overlapping(start, stop))
+            fromTree.insert(i.value);
+      QSet<Spanner*> expected;
+      for (const ::Interval<Spanner*>& i : sm.findOverlapping(start, stop))
+            expected.insert(i.value);
+      QCOMPARE(scanned, expected);
+      QCOMPARE(fromTree, expected);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   benchmarkLayout
+//    4 staves, 20000 slurs, 10000 hairpins
+//---------------------------------------------------------
+
+void TestSpannerMap::benchmarkLayout()
+      {
+      Score* score = spannerScore(4, 2500);
+      QBENCHMARK {
+            score->doLayout();
+            }
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   benchmarkPlayEvents
+//    one slur lookup per chord
+//---------------------------------------------------------
+
+void TestSpannerMap::benchmarkPlayEvents()
+      {
+      Score* score = spannerScore(4, 2500);
+      QBENCHMARK {
+            score->addLayoutFlags(LAYOUT_FIX_PITCH_VELO | LAYOUT_PLAY_EVENTS);
+            score->doLayout();
+            }
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   benchmarkRenderMidi
+//---------------------------------------------------------
+
+void TestSpannerMap::benchmarkRenderMidi()
+      {
+      Score* score = spannerScore(4, 2500);
+      QBENCHMARK {
+            EventMap events;
+            score->renderMidi(&events);
+            }
+      delete score;
+      }
+
+QTEST_MAIN(TestSpannerMap)
+#include "tst_spannermap.moc"
+
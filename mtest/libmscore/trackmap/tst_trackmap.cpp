@@ -0,0 +1,211 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/trackmap.h"
+#include "libmscore/mcursor.h"
+#include "libmscore/durationtype.h"
+#include "libmscore/rest.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestTrackMap
+//---------------------------------------------------------
+
+class TestTrackMap : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      Score* ensemble(int parts, int denseParts, int measures);
+
+   private slots:
+      void initTestCase();
+      void setValue();
+      void nextTrack();
+      void insertRemove();
+      void ensembleMemory();
+      void benchmarkEnsembleLayout();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestTrackMap::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   ensemble
+//    parts staves, only the first denseParts staves have
+//    quarter notes, all others whole notes
+//---------------------------------------------------------
+
+Score* TestTrackMap::ensemble(int parts, int denseParts, int measures)
+      {
+      MCursor c;
+      c.setTimeSig(Fraction(4,4));
+      c.createScore("ensemble");
+      for (int i = 0; i < parts; ++i)
+            c.addPart("violin");
+      c.move(0, 0);
+      c.addKeySig(0);
+      c.addTimeSig(Fraction(4,4));
+      for (int staffIdx = 0; staffIdx < parts; ++staffIdx) {
+            c.move(staffIdx * VOICES, 0);
+            for (int i = 0; i < measures; ++i) {
+                  if (staffIdx < denseParts) {
+                        for (int k = 0; k < 4; ++k)
+                              c.addChord(60 + k, TDuration(TDuration::V_QUARTER));
+                        }
+                  else
+                        c.addChord(67, TDuration(TDuration::V_WHOLE));
+                  }
+            }
+      Score* score = c.score();
+      score->doLayout();
+      return score;
+      }
+
+//---------------------------------------------------------
+//   setValue
+//---------------------------------------------------------
+
+void TestTrackMap::setValue()
+      {
+      TrackMap tm(160);
+      Rest* r1 = new Rest(score);
+      Rest* r2 = new Rest(score);
+      QCOMPARE(tm.size(), 160);
+      QVERIFY(tm.isEmpty());
+      tm.set(100, r2);
+      tm.set(3, r1);
+      QCOMPARE(tm.count(), 2);
+      QCOMPARE(tm.value(3), (Element*)r1);
+      QCOMPARE(tm.value(100), (Element*)r2);
+      QVERIFY(tm.value(4) == 0);
+      QVERIFY(tm.value(-1) == 0);
+      QVERIFY(tm.value(160) == 0);
+      tm.set(3, 0);
+      QCOMPARE(tm.count(), 1);
+      QVERIFY(tm.value(3) == 0);
+      QCOMPARE(tm.value(100), (Element*)r2);
+      tm.swap(100, 64);
+      QVERIFY(tm.value(100) == 0);
+      QCOMPARE(tm.value(64), (Element*)r2);
+      delete r1;
+      delete r2;
+      }
+
+//---------------------------------------------------------
+//   nextTrack
+//---------------------------------------------------------
+
+void TestTrackMap::nextTrack()
+      {
+      TrackMap tm(200);
+      Rest* r = new Rest(score);
+      QCOMPARE(tm.nextTrack(0), -1);
+      tm.set(0, r);
+      tm.set(63, r);
+      tm.set(64, r);
+      tm.set(199, r);
+      QList<int> tracks;
+      for (int t = tm.nextTrack(0); t != -1; t = tm.nextTrack(t + 1))
+            tracks.append(t);
+      QCOMPARE(tracks, QList<int>() << 0 << 63 << 64 << 199);
+      QCOMPARE(tm.nextTrack(65), 199);
+      QCOMPARE(tm.nextTrack(200), -1);
+      int n = 0;
+      for (Element* e : tm) {
+            QCOMPARE(e, (Element*)r);
+            ++n;
+            }
+      QCOMPARE(n, 4);
+      delete r;
+      }
+
+//---------------------------------------------------------
+//   insertRemove
+//    insert and remove a staff
+//---------------------------------------------------------
+
+void TestTrackMap::insertRemove()
+      {
+      TrackMap tm(8);
+      Rest* r1 = new Rest(score);
+      Rest* r2 = new Rest(score);
+      Rest* r3 = new Rest(score);
+      tm.set(0, r1);
+      tm.set(4, r2);
+      tm.set(5, r3);
+      tm.insert(4, 4);
+      QCOMPARE(tm.size(), 12);
+      QCOMPARE(tm.value(0), (Element*)r1);
+      QVERIFY(tm.value(4) == 0);
+      QCOMPARE(tm.value(8), (Element*)r2);
+      QCOMPARE(tm.value(9), (Element*)r3);
+      tm.remove(0, 4);
+      QCOMPARE(tm.size(), 8);
+      QCOMPARE(tm.count(), 2);
+      QCOMPARE(tm.value(4), (Element*)r2);
+      QCOMPARE(tm.value(5), (Element*)r3);
+      delete r1;
+      delete r2;
+      delete r3;
+      }
+
+//---------------------------------------------------------
+//   ensembleMemory
+//    compare element storage of a 40 staff score with a
+//    dense list of staves * VOICES pointers
+//---------------------------------------------------------
+
+void TestTrackMap::ensembleMemory()
+      {
+      Score* score = ensemble(40, 4, 50);
+      size_t sparse = 0;
+      size_t dense  = 0;
+      int segments  = 0;
+      for (Segment* s = score->firstSegment(); s; s = s->next1()) {
+            sparse += s->elist().memoryUsage();
+            dense  += s->elist().size() * sizeof(Element*);
+            ++segments;
+            }
+      qDebug("%d segments: element storage %zu bytes, dense %zu bytes", segments, sparse, dense);
+      QVERIFY(sparse < dense);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   benchmarkEnsembleLayout
+//---------------------------------------------------------
+
+void TestTrackMap::benchmarkEnsembleLayout()
+      {
+      Score* score = ensemble(40, 4, 200);
+      QBENCHMARK {
+            score->doLayout();
+            }
+      delete score;
+      }
+
+QTEST_MAIN(TestTrackMap)
+#include "tst_trackmap.moc"
+
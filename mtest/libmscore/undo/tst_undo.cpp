@@ -0,0 +1,254 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/measure.h"
+#include "libmscore/undo.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/stafftext.h"
+#include "libmscore/note.h"
+
+#define DIR QString("libmscore/concertpitch/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestUndo
+//---------------------------------------------------------
+
+class TestUndo : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      void edit(Score*, int n);
+
+   private slots:
+      void initTestCase();
+      void accounting();
+      void budget();
+      void unlimited();
+      void coalesce();
+      void ownedElements();
+      void removedMeasures();
+      void benchmarkDrag();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestUndo::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   edit
+//    n undoable commands
+//---------------------------------------------------------
+
+void TestUndo::edit(Score* score, int n)
+      {
+      Measure* m = score->firstMeasure();
+      for (int i = 0; i < n; ++i) {
+            score->startCmd();
+            score->undo(new ChangeStretch(m, (i & 1) ? 1.0 : 1.5));
+            score->endCmd();
+            }
+      }
+
+//---------------------------------------------------------
+//   accounting
+//---------------------------------------------------------
+
+void TestUndo::accounting()
+      {
+      Score* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      UndoStack* undo = score->undo();
+      QCOMPARE(undo->memoryUsage(), size_t(0));
+      edit(score, 10);
+      QCOMPARE(undo->count(), 10);
+      size_t n = undo->memoryUsage();
+      QVERIFY(n > 0);
+      score->undo()->undo();
+      edit(score, 1);               // replaces the redo command
+      QCOMPARE(undo->count(), 10);
+      QCOMPARE(undo->memoryUsage(), n);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   budget
+//    the oldest commands are dropped, the remaining ones
+//    can still be undone
+//---------------------------------------------------------
+
+void TestUndo::budget()
+      {
+      size_t budget = MScore::undoMemoryBudget;
+      Score* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      UndoStack* undo = score->undo();
+      edit(score, 1);
+      MScore::undoMemoryBudget = undo->memoryUsage() * 10;
+
+      edit(score, 100);
+      QVERIFY(undo->memoryUsage() <= MScore::undoMemoryBudget);
+      QVERIFY(undo->count() >= 9 && undo->count() < 100);
+      QVERIFY(!undo->isClean());
+
+      int n = undo->count();
+      for (int i = 0; i < n; ++i)
+            undo->undo();
+      QVERIFY(!undo->canUndo());
+      QCOMPARE(undo->count(), n);
+      MScore::undoMemoryBudget = budget;
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   unlimited
+//---------------------------------------------------------
+
+void TestUndo::unlimited()
+      {
+      size_t budget = MScore::undoMemoryBudget;
+      MScore::undoMemoryBudget = 0;
+      Score* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      edit(score, 500);
+      QCOMPARE(score->undo()->count(), 500);
+      MScore::undoMemoryBudget = budget;
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   coalesce
+//    repeated changes of one property in a macro are
+//    undone in one step
+//---------------------------------------------------------
+
+void TestUndo::coalesce()
+      {
+      Score* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      Chord* chord = static_cast<Chord*>(score->firstMeasure()->first(Segment::SegChordRest)->element(0));
+      Note* n1 = chord->upNote();
+      Note* n2 = chord->downNote();
+      int velo = n1->veloOffset();
+
+      score->startCmd();
+      int children = score->undo()->current()->childCount();
+      for (int i = 1; i <= 10; ++i) {
+            score->undoChangeProperty(n1, P_VELO_OFFSET, velo + i);
+            score->undoChangeProperty(n2, P_USER_OFF, QPointF(i, 0.0));
+            }
+      QCOMPARE(score->undo()->current()->childCount(), children + 2);
+      score->endCmd();
+      QCOMPARE(n1->veloOffset(), velo + 10);
+      QCOMPARE(n2->userOff(), QPointF(10.0, 0.0));
+
+      score->undo()->undo();
+      QCOMPARE(n1->veloOffset(), velo);
+      QCOMPARE(n2->userOff(), QPointF());
+      score->undo()->redo();
+      QCOMPARE(n1->veloOffset(), velo + 10);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   ownedElements
+//    a removed element is counted; dropping a command only
+//    deletes the elements it owns
+//---------------------------------------------------------
+
+void TestUndo::ownedElements()
+      {
+      Score* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      UndoStack* undo = score->undo();
+      edit(score, 1);
+      size_t stretch = undo->memoryUsage();
+
+      Segment* s = score->firstMeasure()->first(Segment::SegChordRest);
+      StaffText* text = new StaffText(score);
+      text->setParent(s);
+      text->setTrack(0);
+      text->setText("text");
+      score->startCmd();
+      score->undoAddElement(text);
+      score->endCmd();
+      size_t added = undo->memoryUsage();
+
+      score->startCmd();
+      score->undoRemoveElement(text);
+      score->endCmd();
+      QVERIFY(undo->memoryUsage() - added > added - stretch);
+      QVERIFY(!s->annotations().contains(text));
+
+      // the removal is undone and dropped, the text is in
+      // the score again and must survive
+      undo->undo();
+      QVERIFY(s->annotations().contains(text));
+      edit(score, 1);
+      QCOMPARE(undo->count(), 3);
+      QVERIFY(s->annotations().contains(text));
+      QCOMPARE(text->text(), QString("text"));
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   removedMeasures
+//    measures removed by a command are counted
+//---------------------------------------------------------
+
+void TestUndo::removedMeasures()
+      {
+      Score* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      UndoStack* undo = score->undo();
+      Measure* m1 = score->firstMeasure()->nextMeasure();
+      Measure* m2 = m1->nextMeasure();
+      size_t measures = UndoStack::elementMemory(QList<Element*>() << m1 << m2);
+      QVERIFY(measures > 0);
+      size_t before = undo->memoryUsage();
+      score->startCmd();
+      score->undoRemoveMeasures(m1, m2);
+      score->endCmd();
+      QVERIFY(undo->memoryUsage() - before >= measures);
+      undo->undo();
+      QCOMPARE(score->firstMeasure()->nextMeasure(), m1);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   benchmarkDrag
+//    1000 intermediate positions of a dragged note
+//---------------------------------------------------------
+
+void TestUndo::benchmarkDrag()
+      {
+      Score* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      Chord* chord = static_cast<Chord*>(score->firstMeasure()->first(Segment::SegChordRest)->element(0));
+      Note* note = chord->upNote();
+      QBENCHMARK {
+            score->startCmd();
+            for (int i = 0; i < 1000; ++i)
+                  score->undoChangeProperty(note, P_USER_OFF, QPointF(i * .1, 0.0));
+            score->endCmd();
+            score->undo()->undo();
+            }
+      delete score;
+      }
+
+QTEST_MAIN(TestUndo)
+#include "tst_undo.moc"
+
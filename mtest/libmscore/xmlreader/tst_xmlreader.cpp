@@ -0,0 +1,184 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/xml.h"
+
+#define DIR QString("libmscore/concertpitch/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestXmlReader
+//---------------------------------------------------------
+
+class TestXmlReader : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QByteArray readAll(const QString& path);
+
+   private slots:
+      void initTestCase();
+      void readNumbers();
+      void chunkedData();
+      void addData();
+      void mappedLoad();
+      void benchmarkLoad();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestXmlReader::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   readAll
+//---------------------------------------------------------
+
+QByteArray TestXmlReader::readAll(const QString& path)
+      {
+      QFile f(path);
+      if (!f.open(QIODevice::ReadOnly))
+            return QByteArray();
+      return f.readAll();
+      }
+
+//---------------------------------------------------------
+//   readNumbers
+//---------------------------------------------------------
+
+void TestXmlReader::readNumbers()
+      {
+      XmlReader e(QByteArray("<a><i>42</i><i> 7 </i><i><!-- c -->13</i><i></i>"
+                             "<d>1.5</d><x>abc</x><i>3</i></a>"));
+      QVERIFY(e.readNextStartElement());
+      bool ok;
+      QVERIFY(e.readNextStartElement());
+      QCOMPARE(e.readInt(&ok), 42);
+      QVERIFY(ok);
+      QVERIFY(e.readNextStartElement());
+      QCOMPARE(e.readInt(&ok), 7);
+      QVERIFY(ok);
+      QVERIFY(e.readNextStartElement());
+      QCOMPARE(e.readInt(&ok), 13);
+      QVERIFY(ok);
+      QVERIFY(e.readNextStartElement());
+      QCOMPARE(e.readInt(&ok), 0);
+      QVERIFY(!ok);
+      QVERIFY(e.readNextStartElement());
+      QCOMPARE(e.readDouble(), 1.5);
+      QVERIFY(e.readNextStartElement());
+      QCOMPARE(e.readInt(&ok), 0);
+      QVERIFY(!ok);
+      QVERIFY(e.readNextStartElement());
+      QCOMPARE(e.readInt(), 3);
+      QVERIFY(!e.hasError());
+      }
+
+//---------------------------------------------------------
+//   chunkedData
+//    a document from memory larger than one decoding
+//    chunk, with multibyte characters on chunk boundaries
+//---------------------------------------------------------
+
+void TestXmlReader::chunkedData()
+      {
+      QString text;
+      for (int i = 0; i < 20000; ++i)
+            text += QString::fromUtf8("\xc3\xa4\xe2\x99\xaf");
+      QByteArray data = "<a><t>" + text.toUtf8() + "</t><i>17</i></a>";
+      QVERIFY(data.size() > 3 * 65536);
+
+      XmlReader e(data);
+      QVERIFY(e.readNextStartElement());
+      QVERIFY(e.readNextStartElement());
+      QCOMPARE(e.readElementText(), text);
+      QVERIFY(e.readNextStartElement());
+      QCOMPARE(e.readInt(), 17);
+      e.readNext();
+      e.readNext();
+      QVERIFY(!e.hasError());
+      QVERIFY(e.atEnd());
+      }
+
+//---------------------------------------------------------
+//   addData
+//    incremental data after a partial read
+//---------------------------------------------------------
+
+void TestXmlReader::addData()
+      {
+      XmlReader e(QByteArray("<a><i>5</i>"));
+      QVERIFY(e.readNextStartElement());
+      QVERIFY(e.readNextStartElement());
+      QCOMPARE(e.readInt(), 5);
+      e.readNext();
+      QCOMPARE(e.error(), XmlStreamReader::PrematureEndOfDocumentError);
+      e.addData(QByteArray("<i>6</i></a>"));
+      QVERIFY(e.readNextStartElement());
+      QCOMPARE(e.readInt(), 6);
+      e.readNext();
+      e.readNext();
+      QVERIFY(!e.hasError());
+      }
+
+//---------------------------------------------------------
+//   mappedLoad
+//    Score::loadMsc() reads .mscx files memory mapped;
+//    a saved and reloaded score must save identically
+//---------------------------------------------------------
+
+void TestXmlReader::mappedLoad()
+      {
+      Score* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      QVERIFY(score);
+      QVERIFY(saveScore(score, "xmlreader-1.mscx"));
+      delete score;
+
+      score = readCreatedScore("xmlreader-1.mscx");
+      QVERIFY(score);
+      QVERIFY(saveScore(score, "xmlreader-2.mscx"));
+      delete score;
+
+      QByteArray d1 = readAll("xmlreader-1.mscx");
+      QVERIFY(!d1.isEmpty());
+      QCOMPARE(readAll("xmlreader-2.mscx"), d1);
+      }
+
+//---------------------------------------------------------
+//   benchmarkLoad
+//---------------------------------------------------------
+
+void TestXmlReader::benchmarkLoad()
+      {
+      Score* score = readScore(DIR + "concertpitchbenchmark.mscx");
+      score->appendMeasures(4000);
+      QVERIFY(saveScore(score, "xmlreader-big.mscx"));
+      delete score;
+
+      QBENCHMARK {
+            score = readCreatedScore("xmlreader-big.mscx");
+            delete score;
+            }
+      }
+
+QTEST_MAIN(TestXmlReader)
+#include "tst_xmlreader.moc"
+
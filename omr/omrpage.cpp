@@ -77,9 +77,54 @@ struct Lv {
 OmrPage::OmrPage(Omr* parent)
       {
       _omr = parent;
+      _imagePending = false;
+      _imageKey = 0;
       cropL = cropR = cropT = cropB = 0;
       }
 
+//---------------------------------------------------------
+//   setImage
+//    the image is decoded from the archive on first use
+//---------------------------------------------------------
+
+void OmrPage::setImage(QSharedPointer<MsczArchive> archive, const QString& path)
+      {
+      _image        = QImage();
+      _archive      = archive;
+      _archivePath  = path;
+      _imagePending = true;
+      }
+
+//---------------------------------------------------------
+//   loadImage
+//---------------------------------------------------------
+
+void OmrPage::loadImage() const
+      {
+      if (!_imagePending)
+            return;
+      _imagePending = false;
+      if (_image.loadFromData(_archive->fileData(_archivePath), "PNG"))
+            _imageKey = _image.cacheKey();
+      else {
+            qDebug("load image failed");
+            _archive.clear();
+            }
+      }
+
+//---------------------------------------------------------
+//   archive
+//    return the archive the image was read from if the
+//    image is unchanged
+//---------------------------------------------------------
+
+QSharedPointer<MsczArchive> OmrPage::archive() const
+      {
+      if (_archive && !_imagePending && _image.cacheKey() != _imageKey)
+            _archive.clear();
+      return _archive;
+      }
+
 //---------------------------------------------------------
 //   dot
 //---------------------------------------------------------
@@ -96,6 +141,7 @@ bool OmrPage::dot(int x, int y) const
 
 void OmrPage::read()
       {
+      loadImage();
       crop();
       slice();
       deSkew();
@@ -24,6 +24,7 @@
 #include "libmscore/mscore.h"
 #include "libmscore/durationtype.h"
 #include "libmscore/fraction.h"
+#include "libmscore/msczarchive.h"
 
 namespace Ms {
 
@@ -181,7 +182,11 @@ class OmrSystem {
 
 class OmrPage {
       Omr* _omr;
-      QImage _image;
+      mutable QImage _image;
+      mutable QSharedPointer<MsczArchive> _archive;   ///< set while the image is unchanged since read
+      QString _archivePath;
+      mutable bool _imagePending;                     ///< _image not yet decoded from _archive
+      mutable qint64 _imageKey;                       ///< cacheKey() of the decoded image
       double _spatium;
 
       int cropL, cropR;       // crop values in words (32 bit) units
@@ -206,18 +211,23 @@ class OmrPage {
       OmrClef searchClef(OmrSystem* system, OmrStaff* staff);
       void searchKeySig(OmrSystem* system, OmrStaff* staff);
       OmrPattern searchPattern(const std::vector<Pattern*>& pl, int y, int x1, int x2);
+      void loadImage() const;
 
    public:
       OmrPage(Omr* _parent);
-      void setImage(const QImage& i)     { _image = i; }
-      const QImage& image() const        { return _image; }
-      QImage& image()                    { return _image; }
+      void setImage(const QImage& i)     { _image = i; _archive.clear(); _imagePending = false; }
+      void setImage(QSharedPointer<MsczArchive>, const QString& path);
+      const QImage& image() const        { loadImage(); return _image; }
+      QImage& image()                    { loadImage(); return _image; }
+      QSharedPointer<MsczArchive> archive() const;
+      const QString& archivePath() const { return _archivePath; }
+      void releaseArchive()              { loadImage(); _archive.clear(); }
       void read();
-      int width() const                  { return _image.width(); }
-      int height() const                 { return _image.height(); }
-      const uint* scanLine(int y) const  { return (const uint*)_image.scanLine(y); }
-      const uint* bits() const           { return (const uint*)_image.bits(); }
-      int wordsPerLine() const           { return (_image.bytesPerLine() + 3)/4; }
+      int width() const                  { return image().width(); }
+      int height() const                 { return image().height(); }
+      const uint* scanLine(int y) const  { return (const uint*)image().scanLine(y); }
+      const uint* bits() const           { return (const uint*)image().bits(); }
+      int wordsPerLine() const           { return (image().bytesPerLine() + 3)/4; }
 
       const QList<QLine>& sl()           { return lines;    }
       const QList<HLine>& l()            { return slines;   }
@@ -0,0 +1,141 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <chrono>
+#include "audiostats.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   AudioStats
+//---------------------------------------------------------
+
+AudioStats::AudioStats()
+      {
+      reset();
+      }
+
+//---------------------------------------------------------
+//   now
+//    monotonic time in ns; does not block
+//---------------------------------------------------------
+
+qint64 AudioStats::now()
+      {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+//---------------------------------------------------------
+//   callback
+//    ns is the processing time of a buffer of frames
+//---------------------------------------------------------
+
+void AudioStats::callback(unsigned frames, int sampleRate, qint64 ns)
+      {
+      if (frames == 0 || sampleRate <= 0 || ns < 0)
+            return;
+      quint64 deadline = quint64(frames) * 1000000000ULL / sampleRate;
+      quint64 load     = quint64(ns) * 1000 / deadline;
+      int bucket       = qMin(int(load / 100), BUCKETS - 1);
+
+      _histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+      _callbacks.fetch_add(1, std::memory_order_relaxed);
+      _busyNs.fetch_add(ns, std::memory_order_relaxed);
+      _deadlineNs.fetch_add(deadline, std::memory_order_relaxed);
+      if (quint64(ns) > deadline)
+            _missed.fetch_add(1, std::memory_order_relaxed);
+      // the audio thread is the only writer besides reset()
+      if (load > _maxLoad.load(std::memory_order_relaxed))
+            _maxLoad.store(load, std::memory_order_relaxed);
+      _frames.store(frames, std::memory_order_relaxed);
+      }
+
+//---------------------------------------------------------
+//   addSynth
+//---------------------------------------------------------
+
+void AudioStats::addSynth(int idx, qint64 ns)
+      {
+      if (idx < MAX_SYNTHS)
+            _synthNs[idx].fetch_add(ns, std::memory_order_relaxed);
+      }
+
+//---------------------------------------------------------
+//   addEffect
+//---------------------------------------------------------
+
+void AudioStats::addEffect(int ab, qint64 ns)
+      {
+      if (ab < MAX_EFFECTS)
+            _effectNs[ab].fetch_add(ns, std::memory_order_relaxed);
+      }
+
+//---------------------------------------------------------
+//   reset
+//    counts of a callback running concurrently may be
+//    lost
+//---------------------------------------------------------
+
+void AudioStats::reset()
+      {
+      _callbacks  = 0;
+      _missed     = 0;
+      _xruns      = 0;
+      _busyNs     = 0;
+      _deadlineNs = 0;
+      _maxLoad    = 0;
+      _frames     = 0;
+      for (int i = 0; i < BUCKETS; ++i)
+            _histogram[i] = 0;
+      for (int i = 0; i < MAX_SYNTHS; ++i)
+            _synthNs[i] = 0;
+      for (int i = 0; i < MAX_EFFECTS; ++i)
+            _effectNs[i] = 0;
+      }
+
+//---------------------------------------------------------
+//   load
+//    processing time / buffer time of all callbacks
+//---------------------------------------------------------
+
+double AudioStats::load() const
+      {
+      return ratio(_busyNs.load(std::memory_order_relaxed), _deadlineNs.load(std::memory_order_relaxed));
+      }
+
+//---------------------------------------------------------
+//   synthLoad
+//    share of the buffer time used by synthesizer idx
+//---------------------------------------------------------
+
+double AudioStats::synthLoad(int idx) const
+      {
+      if (idx >= MAX_SYNTHS)
+            return 0.0;
+      return ratio(_synthNs[idx].load(std::memory_order_relaxed), _deadlineNs.load(std::memory_order_relaxed));
+      }
+
+//---------------------------------------------------------
+//   effectLoad
+//    share of the buffer time used by effect slot ab
+//---------------------------------------------------------
+
+double AudioStats::effectLoad(int ab) const
+      {
+      if (ab >= MAX_EFFECTS)
+            return 0.0;
+      return ratio(_effectNs[ab].load(std::memory_order_relaxed), _deadlineNs.load(std::memory_order_relaxed));
+      }
+
+}     // namespace Ms
+
@@ -0,0 +1,96 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2014 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __AUDIOSTATS_H__
+#define __AUDIOSTATS_H__
+
+#include <atomic>
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   AudioStats
+//    timing of the audio callbacks. The counters are
+//    written by the audio thread without locks and read
+//    by the gui.
+//
+//    The deadline of a callback is the duration of its
+//    buffer; the processing time is entered into a
+//    histogram of the load (time / deadline) in 10%
+//    steps. Overruns reported by the audio driver are
+//    counted separately.
+//---------------------------------------------------------
+
+class AudioStats {
+   public:
+      static const int BUCKETS     = 12;      // last bucket: load >= 110%
+      static const int MAX_SYNTHS  = 8;
+      static const int MAX_EFFECTS = 2;
+
+   private:
+      std::atomic<quint64> _callbacks;
+      std::atomic<quint64> _missed;
+      std::atomic<quint64> _xruns;
+      std::atomic<quint64> _busyNs;
+      std::atomic<quint64> _deadlineNs;
+      std::atomic<quint64> _maxLoad;            // per mille
+      std::atomic<unsigned> _frames;
+      std::atomic<quint64> _histogram[BUCKETS];
+      std::atomic<quint64> _synthNs[MAX_SYNTHS];
+      std::atomic<quint64> _effectNs[MAX_EFFECTS];
+
+      static double ratio(quint64 a, quint64 b) { return b ? double(a) / double(b) : 0.0; }
+
+   public:
+      AudioStats();
+      static qint64 now();
+
+      // audio thread
+      void callback(unsigned frames, int sampleRate, qint64 ns);
+      void addSynth(int idx, qint64 ns);
+      void addEffect(int ab, qint64 ns);
+
+      // any thread
+      void xrun()                    { _xruns.fetch_add(1, std::memory_order_relaxed); }
+      void reset();
+
+      quint64 callbacks() const      { return _callbacks.load(std::memory_order_relaxed); }
+      quint64 missed() const         { return _missed.load(std::memory_order_relaxed);    }
+      quint64 xruns() const          { return _xruns.load(std::memory_order_relaxed);     }
+      quint64 histogram(int i) const { return _histogram[i].load(std::memory_order_relaxed); }
+      unsigned frames() const        { return _frames.load(std::memory_order_relaxed);    }
+      double load() const;
+      double maxLoad() const         { return _maxLoad.load(std::memory_order_relaxed) / 1000.0; }
+      double synthLoad(int idx) const;
+      double effectLoad(int ab) const;
+      };
+
+//---------------------------------------------------------
+//   AudioCallbackTimer
+//    enters its lifetime as one callback into stats
+//---------------------------------------------------------
+
+class AudioCallbackTimer {
+      AudioStats* _stats;
+      unsigned _frames;
+      int _sampleRate;
+      qint64 _begin;
+
+   public:
+      AudioCallbackTimer(AudioStats* s, unsigned frames, int sampleRate)
+         : _stats(s), _frames(frames), _sampleRate(sampleRate), _begin(AudioStats::now()) {}
+      ~AudioCallbackTimer() { _stats->callback(_frames, _sampleRate, AudioStats::now() - _begin); }
+      };
+
+}     // namespace Ms
+#endif
+
@@ -17,6 +17,7 @@
 #include "synthesizergui.h"
 #include "libmscore/xml.h"
 #include "midipatch.h"
+#include "libmscore/trace.h"
 
 namespace Ms {
 
@@ -263,6 +264,7 @@ void MasterSynthesizer::setSampleRate(float val)
 
 void MasterSynthesizer::process(unsigned n, float* p)
       {
+      TRACE("MasterSynthesizer::process");
 //      memset(effect1Buffer, 0, n * sizeof(float) * 2);
 //      memset(effect2Buffer, 0, n * sizeof(float) * 2);
 
@@ -276,21 +278,30 @@ void MasterSynthesizer::process(unsigned n, float* p)
       // avoid overflow
       if( n > MAX_BUFFERSIZE / 2)
             return;
+      qint64 t = AudioStats::now();
+      int idx = 0;
       for (Synthesizer* s : _synthesizer) {
-            if (s->active())
+            if (s->active()) {
                   s->process(n, p, effect1Buffer, effect2Buffer);
+                  qint64 tt = AudioStats::now();
+                  _stats.addSynth(idx, tt - t);
+                  t = tt;
+                  }
+            ++idx;
             }
       if (_effect[0] && _effect[1]) {
             memset(effect1Buffer, 0, n * sizeof(float) * 2);
             _effect[0]->process(n, p, effect1Buffer);
+            qint64 tt = AudioStats::now();
+            _stats.addEffect(0, tt - t);
             _effect[1]->process(n, effect1Buffer, p);
+            _stats.addEffect(1, AudioStats::now() - tt);
             }
       else if (_effect[0] || _effect[1]) {
             memcpy(effect1Buffer, p, n * sizeof(float) * 2);
-            if (_effect[0])
-                  _effect[0]->process(n, effect1Buffer, p);
-            else
-                  _effect[1]->process(n, effect1Buffer, p);
+            int ab = _effect[0] ? 0 : 1;
+            _effect[ab]->process(n, effect1Buffer, p);
+            _stats.addEffect(ab, AudioStats::now() - t);
             }
       for (unsigned i = 0; i < n * 2; ++i)
             *p++ *= _gain;
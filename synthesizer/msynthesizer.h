@@ -16,6 +16,7 @@
 #include <atomic>
 #include "effects/effect.h"
 #include "libmscore/synthesizerstate.h"
+#include "audiostats.h"
 
 namespace Ms {
 
@@ -48,6 +49,7 @@ class MasterSynthesizer : public QObject {
       Effect* _effect[2];
 
       float _sampleRate;
+      AudioStats _stats;
 
       float effect1Buffer[MAX_BUFFERSIZE];
       float effect2Buffer[MAX_BUFFERSIZE];
@@ -99,6 +101,7 @@ class MasterSynthesizer : public QObject {
       int indexOfEffect(int ab);
 
       float gain() const    { return _gain; }
+      AudioStats* stats()   { return &_stats; }
       };
 
 }
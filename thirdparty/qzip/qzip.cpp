@@ -46,6 +46,8 @@
 #include "qzipwriter_p.h"
 
 #include <zlib.h>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
 
 #if defined(Q_OS_WIN) or defined(Q_OS_ANDROID)
 #  undef S_IFREG
@@ -226,33 +228,82 @@ static int inflate(Bytef *dest, ulong *destLen, const Bytef *source, ulong sourc
     return err;
 }
 
-static int deflate (Bytef *dest, ulong *destLen, const Bytef *source, ulong sourceLen)
-{
-    z_stream stream;
-    int err;
-
-    stream.next_in = (Bytef*)source;
-    stream.avail_in = (uInt)sourceLen;
-    stream.next_out = dest;
-    stream.avail_out = (uInt)*destLen;
-    if ((uLong)stream.avail_out != *destLen) return Z_BUF_ERROR;
+/*
+    Large files are compressed pigz style: the input is split into chunks
+    which are deflated in parallel. Every chunk is primed with the last
+    32k of the preceding input as dictionary, so the compression ratio
+    hardly suffers, and all but the last chunk end with a sync flush on
+    a byte boundary. The concatenated chunks form one deflate stream.
+*/
+static const int DEFLATE_CHUNK = 256 * 1024;
+static const int DEFLATE_DICT  = 32 * 1024;
 
-    stream.zalloc = (alloc_func)0;
-    stream.zfree = (free_func)0;
-    stream.opaque = (voidpf)0;
+struct DeflateChunk
+{
+    const QByteArray *contents;
+    int offset;
+    int length;
+    int level;
+    bool last;
+    bool ok;
+    uint crc;
+    QByteArray data;
+};
 
-    err = deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
-    if (err != Z_OK) return err;
+static void deflateChunk(DeflateChunk &c)
+{
+    c.ok = false;
+    const Bytef *in = (const Bytef *)c.contents->constData() + c.offset;
+    c.crc = ::crc32(::crc32(0, 0, 0), in, c.length);
 
-    err = deflate(&stream, Z_FINISH);
-    if (err != Z_STREAM_END) {
-        deflateEnd(&stream);
-        return err == Z_OK ? Z_BUF_ERROR : err;
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, c.level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return;
+    if (c.offset > 0) {
+        int dict = qMin(c.offset, DEFLATE_DICT);
+        deflateSetDictionary(&stream, in - dict, dict);
     }
-    *destLen = stream.total_out;
+    c.data.resize(deflateBound(&stream, c.length) + 16);
+    stream.next_in   = (Bytef *)in;
+    stream.avail_in  = c.length;
+    stream.next_out  = (Bytef *)c.data.data();
+    stream.avail_out = c.data.size();
+
+    int flush = c.last ? Z_FINISH : Z_SYNC_FLUSH;
+    for (;;) {
+        int err = deflate(&stream, flush);
+        if (c.last ? err == Z_STREAM_END : (err == Z_OK && stream.avail_in == 0 && stream.avail_out > 0)) {
+            c.ok = true;
+            break;
+        }
+        if (err != Z_OK && err != Z_BUF_ERROR)
+            break;
+        // out of output space
+        int used = stream.total_out;
+        c.data.resize(c.data.size() * 2);
+        stream.next_out  = (Bytef *)c.data.data() + used;
+        stream.avail_out = c.data.size() - used;
+    }
+    c.data.resize(c.ok ? stream.total_out : 0);
+    deflateEnd(&stream);
+}
 
-    err = deflateEnd(&stream);
-    return err;
+/*
+    Deflate \a buffer after its first \a dict bytes, which are used as
+    dictionary. Used for data that arrives piecewise, see MQZipFileDevice.
+*/
+static DeflateChunk deflateBuffer(QByteArray buffer, int dict, int level, bool last)
+{
+    DeflateChunk c;
+    c.contents = &buffer;
+    c.offset   = dict;
+    c.length   = buffer.size() - dict;
+    c.level    = level;
+    c.last     = last;
+    deflateChunk(c);
+    c.contents = 0;
+    return c;
 }
 
 static QFile::Permissions modeToPermissions(quint32 mode)
@@ -452,17 +503,52 @@ public:
         : MQZipPrivate(device, ownDev),
         status(MQZipWriter::NoError),
         permissions(QFile::ReadOwner | QFile::WriteOwner),
-        compressionPolicy(MQZipWriter::AlwaysCompress)
+        compressionPolicy(MQZipWriter::AlwaysCompress),
+        compressionLevel(Z_DEFAULT_COMPRESSION)
     {
     }
 
     MQZipWriter::Status status;
     QFile::Permissions permissions;
     MQZipWriter::CompressionPolicy compressionPolicy;
+    int compressionLevel;
 
     enum EntryType { Directory, File, Symlink };
 
     void addEntry(EntryType type, const QString &fileName, const QByteArray &contents);
+    void addRawEntry(EntryType type, const QString &fileName, const MQZipRawEntry &entry);
+};
+
+/*
+    A file of an archive which is written piecewise. Input is collected
+    in chunks which are deflated on worker threads while more input
+    arrives; finished chunks are written in order. The local file header
+    is written first and completed when the device is closed.
+*/
+class MQZipFileDevice : public QIODevice
+{
+public:
+    MQZipFileDevice(MQZipWriterPrivate *d, const QString &fileName);
+    ~MQZipFileDevice();
+    bool isSequential() const { return true; }
+    void close();
+protected:
+    qint64 readData(char *, qint64) { return -1; }
+    qint64 writeData(const char *data, qint64 len);
+private:
+    void submit(bool last);
+    void drain(int maxPending);
+
+    MQZipWriterPrivate *d;
+    int index;                  // of the file header
+    bool compress;
+    QByteArray input;           // dictionary followed by pending input
+    int dict;
+    QList<QFuture<DeflateChunk> > pending;
+    uint crc;
+    quint64 compressedSize;
+    quint64 uncompressedSize;
+    bool ok;
 };
 
 LocalFileHeader CentralFileHeader::toLocalHeader() const
@@ -580,59 +666,27 @@ void MQZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const
     ZDEBUG() << "adding" << entryTypes[type] <<":" << fileName.toUtf8().data() << (type == 2 ? QByteArray(" -> " + contents).constData() : "");
 #endif
 
+    addRawEntry(type, fileName, MQZipWriter::compress(contents, compressionLevel, compressionPolicy));
+}
+
+void MQZipWriterPrivate::addRawEntry(EntryType type, const QString &fileName, const MQZipRawEntry &entry)
+{
     if (! (device->isOpen() || device->open(QIODevice::WriteOnly))) {
         status = MQZipWriter::FileOpenError;
         return;
     }
     device->seek(start_of_directory);
 
-    // don't compress small files
-    MQZipWriter::CompressionPolicy compression = compressionPolicy;
-    if (compressionPolicy == MQZipWriter::AutoCompress) {
-        if (contents.length() < 64)
-            compression = MQZipWriter::NeverCompress;
-        else
-            compression = MQZipWriter::AlwaysCompress;
-    }
-
     FileHeader header;
     memset(&header.h, 0, sizeof(CentralFileHeader));
     writeUInt(header.h.signature, 0x02014b50);
 
     writeUShort(header.h.version_needed, 0x14);
-    writeUInt(header.h.uncompressed_size, contents.length());
+    writeUInt(header.h.uncompressed_size, entry.uncompressedSize);
     writeMSDosDate(header.h.last_mod_file, QDateTime::currentDateTime());
-    QByteArray data = contents;
-    if (compression == MQZipWriter::AlwaysCompress) {
-        writeUShort(header.h.compression_method, 8);
-
-       ulong len = contents.length();
-        // shamelessly copied form zlib
-        len += (len >> 12) + (len >> 14) + 11;
-        int res;
-        do {
-            data.resize(len);
-            res = deflate((uchar*)data.data(), &len, (const uchar*)contents.constData(), contents.length());
-
-            switch (res) {
-            case Z_OK:
-                data.resize(len);
-                break;
-            case Z_MEM_ERROR:
-                qWarning("QZip: Z_MEM_ERROR: Not enough memory to compress file, skipping");
-                data.resize(0);
-                break;
-            case Z_BUF_ERROR:
-                len *= 2;
-                break;
-            }
-        } while (res == Z_BUF_ERROR);
-    }
-// TODO add a check if data.length() > contents.length().  Then try to store the original and revert the compression method to be uncompressed
-    writeUInt(header.h.compressed_size, data.length());
-    uint crc_32 = ::crc32(0, 0, 0);
-    crc_32 = ::crc32(crc_32, (const uchar *)contents.constData(), contents.length());
-    writeUInt(header.h.crc_32, crc_32);
+    writeUShort(header.h.compression_method, entry.compressionMethod);
+    writeUInt(header.h.compressed_size, entry.data.length());
+    writeUInt(header.h.crc_32, entry.crc32);
 
     header.file_name = fileName.toUtf8();
     if (header.file_name.size() > 0xffff) {
@@ -660,11 +714,105 @@ void MQZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const
     LocalFileHeader h = header.h.toLocalHeader();
     device->write((const char *)&h, sizeof(LocalFileHeader));
     device->write(header.file_name);
-    device->write(data);
+    device->write(entry.data);
     start_of_directory = device->pos();
     dirtyFileTree = true;
 }
 
+MQZipFileDevice::MQZipFileDevice(MQZipWriterPrivate *d, const QString &fileName)
+    : d(d), compress(d->compressionPolicy != MQZipWriter::NeverCompress), dict(0),
+      crc(::crc32(0, 0, 0)), compressedSize(0), uncompressedSize(0)
+{
+    MQZipRawEntry entry;
+    entry.compressionMethod = compress ? 8 : 0;
+    d->addRawEntry(MQZipWriterPrivate::File, fileName, entry);
+    ok = d->status == MQZipWriter::NoError;
+    index = d->fileHeaders.size() - 1;
+    open(QIODevice::WriteOnly);
+}
+
+MQZipFileDevice::~MQZipFileDevice()
+{
+    close();
+}
+
+qint64 MQZipFileDevice::writeData(const char *data, qint64 len)
+{
+    if (!ok)
+        return -1;
+    uncompressedSize += len;
+    if (!compress) {
+        crc = ::crc32(crc, (const uchar *)data, len);
+        compressedSize += len;
+        return d->device->write(data, len) == len ? len : -1;
+    }
+    input.append(data, len);
+    while (input.size() - dict >= DEFLATE_CHUNK)
+        submit(false);
+    return len;
+}
+
+/*
+    Start deflating the next chunk of input, keep the end of it as
+    dictionary for the following chunk.
+*/
+void MQZipFileDevice::submit(bool last)
+{
+    int n = last ? input.size() : dict + DEFLATE_CHUNK;
+    pending.append(QtConcurrent::run(deflateBuffer, input.left(n), dict, d->compressionLevel, last));
+    int nextDict = qMin(n, DEFLATE_DICT);
+    input.remove(0, n - nextDict);
+    dict = nextDict;
+    drain(qMax(1, QThread::idealThreadCount()));
+}
+
+/*
+    Write finished chunks in order until at most \a maxPending remain.
+*/
+void MQZipFileDevice::drain(int maxPending)
+{
+    while (pending.size() > maxPending) {
+        DeflateChunk c = pending.takeFirst().result();
+        if (!c.ok) {
+            qWarning("QZip: deflate failed");
+            ok = false;
+        }
+        if (ok && d->device->write(c.data) != c.data.size())
+            ok = false;
+        crc = ::crc32_combine(crc, c.crc, c.length);
+        compressedSize += c.data.size();
+    }
+}
+
+/*
+    Complete the file: deflate the rest of the input and fill in
+    sizes and checksum in the central and the local file header.
+*/
+void MQZipFileDevice::close()
+{
+    if (!isOpen())
+        return;
+    if (compress) {
+        submit(true);
+        drain(0);
+    }
+    FileHeader &header = d->fileHeaders[index];
+    writeUInt(header.h.crc_32, crc);
+    writeUInt(header.h.compressed_size, compressedSize);
+    writeUInt(header.h.uncompressed_size, uncompressedSize);
+    uint end = d->device->pos();
+    LocalFileHeader h = header.h.toLocalHeader();
+    if (ok) {
+        ok = d->device->seek(readUInt(header.h.offset_local_header))
+           && d->device->write((const char *)&h, sizeof(LocalFileHeader)) == sizeof(LocalFileHeader)
+           && d->device->seek(end);
+    }
+    if (!ok)
+        d->status = MQZipWriter::FileWriteError;
+    d->start_of_directory = end;
+    QIODevice::close();
+}
+
 //////////////////////////////  Reader
 
 /*!
@@ -849,6 +997,17 @@ MQZipReader::FileInfo MQZipReader::entryInfoAt(int index) const
 */
 QByteArray MQZipReader::fileData(const QString &fileName) const
 {
+    return uncompress(rawFileData(fileName));
+}
+
+/*!
+    Fetch the file from the zip archive as it is stored, without
+    uncompressing it. The result can be added to another archive with
+    MQZipWriter::addRawFile().
+*/
+MQZipRawEntry MQZipReader::rawFileData(const QString &fileName) const
+{
+    MQZipRawEntry entry;
     d->scanFiles();
     int i;
     for (i = 0; i < d->fileHeaders.size(); ++i) {
@@ -856,14 +1015,12 @@ QByteArray MQZipReader::fileData(const QString &fileName) const
             break;
     }
     if (i == d->fileHeaders.size())
-        return QByteArray();
+        return entry;
 
     FileHeader header = d->fileHeaders.at(i);
 
     int compressed_size = readUInt(header.h.compressed_size);
-    int uncompressed_size = readUInt(header.h.uncompressed_size);
     int start = readUInt(header.h.offset_local_header);
-    //qDebug("uncompressing file %d: local header at %d", i, start);
 
     d->device->seek(start);
     LocalFileHeader lh;
@@ -871,11 +1028,24 @@ QByteArray MQZipReader::fileData(const QString &fileName) const
     uint skip = readUShort(lh.file_name_length) + readUShort(lh.extra_field_length);
     d->device->seek(d->device->pos() + skip);
 
-    int compression_method = readUShort(lh.compression_method);
-    //qDebug("file=%s: compressed_size=%d, uncompressed_size=%d", fileName.toLocal8Bit().data(), compressed_size, uncompressed_size);
+    entry.compressionMethod = readUShort(lh.compression_method);
+    entry.crc32 = readUInt(header.h.crc_32);
+    entry.uncompressedSize = readUInt(header.h.uncompressed_size);
+    entry.data = d->device->read(compressed_size);
+    return entry;
+}
 
-    //qDebug("file at %lld", d->device->pos());
-    QByteArray compressed = d->device->read(compressed_size);
+/*!
+    Return the uncompressed bytes of a raw archive entry.
+*/
+QByteArray MQZipReader::uncompress(const MQZipRawEntry &entry)
+{
+    if (entry.isNull())
+        return QByteArray();
+    int compression_method = entry.compressionMethod;
+    int compressed_size = entry.data.size();
+    int uncompressed_size = entry.uncompressedSize;
+    QByteArray compressed = entry.data;
     if (compression_method == 0) {
         // no compression
         compressed.truncate(uncompressed_size);
@@ -1137,6 +1307,77 @@ MQZipWriter::CompressionPolicy MQZipWriter::compressionPolicy() const
     return d->compressionPolicy;
 }
 
+/*!
+    Sets the zlib compression \a level for newly added files, from
+    1 (fastest) to 9 (smallest); -1 selects the zlib default.
+*/
+void MQZipWriter::setCompressionLevel(int level)
+{
+    d->compressionLevel = level;
+}
+
+int MQZipWriter::compressionLevel() const
+{
+    return d->compressionLevel;
+}
+
+/*!
+    Compress \a contents into an entry for addRawFile(). Files larger
+    than one chunk are compressed in parallel on the global thread pool.
+    If compression does not make the file smaller it is stored.
+
+    This function is thread safe; callers may compress independent files
+    concurrently and add them in order afterwards.
+*/
+MQZipRawEntry MQZipWriter::compress(const QByteArray &contents, int level, CompressionPolicy policy)
+{
+    MQZipRawEntry entry;
+    entry.uncompressedSize = contents.length();
+    entry.crc32 = ::crc32(0, 0, 0);
+
+    // don't compress small files
+    if (policy == NeverCompress || (policy == AutoCompress && contents.length() < 64)) {
+        entry.crc32 = ::crc32(entry.crc32, (const uchar *)contents.constData(), contents.length());
+        entry.data = contents;
+        return entry;
+    }
+
+    QVector<DeflateChunk> chunks;
+    int offset = 0;
+    do {
+        DeflateChunk c;
+        c.contents = &contents;
+        c.offset   = offset;
+        c.length   = qMin(DEFLATE_CHUNK, contents.length() - offset);
+        c.level    = level;
+        c.last     = offset + c.length == contents.length();
+        chunks.append(c);
+        offset += c.length;
+    } while (offset < contents.length());
+
+    if (chunks.size() > 1)
+        QtConcurrent::blockingMap(chunks, deflateChunk);
+    else
+        deflateChunk(chunks[0]);
+
+    QByteArray data;
+    bool ok = true;
+    foreach (const DeflateChunk &c, chunks) {
+        ok = ok && c.ok;
+        data.append(c.data);
+        entry.crc32 = ::crc32_combine(entry.crc32, c.crc, c.length);
+    }
+    if (!ok)
+        qWarning("QZip: deflate failed, storing file uncompressed");
+    if (ok && (policy == AlwaysCompress || data.length() < contents.length())) {
+        entry.compressionMethod = 8;
+        entry.data = data;
+    }
+    else
+        entry.data = contents;
+    return entry;
+}
+
 /*!
     Sets the permissions that will be used for newly added files.
 
@@ -1178,6 +1419,16 @@ void MQZipWriter::addFile(const QString &fileName, const QByteArray &data)
     d->addEntry(MQZipWriterPrivate::File, fileName, data);
 }
 
+/*!
+    Add a file to the archive exactly as it was stored in another
+    archive, see MQZipReader::rawFileData(). The data is not
+    compressed again.
+*/
+void MQZipWriter::addRawFile(const QString &fileName, const MQZipRawEntry &entry)
+{
+    d->addRawEntry(MQZipWriterPrivate::File, fileName, entry);
+}
+
 /*!
     Add a file to the archive with \a device as the source of the contents.
     The contents returned from QIODevice::readAll() will be used as the
@@ -1202,6 +1453,20 @@ void MQZipWriter::addFile(const QString &fileName, QIODevice *device)
         device->close();
 }
 
+/*!
+    Returns a device to which the contents of a new file \a fileName are
+    written. The data is compressed while it is written, large files in
+    parallel, so the contents never have to be held in memory as a whole.
+    The device has to be closed before another file is added or the
+    archive is closed. The caller owns the device.
+
+    The compression policy AutoCompress compresses streamed files always.
+*/
+QIODevice *MQZipWriter::openFile(const QString &fileName)
+{
+    return new MQZipFileDevice(d, fileName);
+}
+
 /*!
     Create a new directory in the archive with the specified \a dirName and
     the \a permissions;
@@ -63,6 +63,22 @@ QT_BEGIN_NAMESPACE
 
 class MQZipReaderPrivate;
 
+/*
+    A file as it is stored in the archive: the compressed bytes
+    together with everything needed to copy it into another archive
+    without recompressing it.
+*/
+struct MQZipRawEntry
+{
+    MQZipRawEntry() : crc32(0), uncompressedSize(0), compressionMethod(0) {}
+    bool isNull() const { return data.isNull(); }
+
+    QByteArray data;            // compressed bytes
+    uint crc32;
+    uint uncompressedSize;
+    int compressionMethod;      // 0: stored, 8: deflate
+};
+
 class MQZipReader
 {
 public:
@@ -99,6 +115,8 @@ public:
 
     FileInfo entryInfoAt(int index) const;
     QByteArray fileData(const QString &fileName) const;
+    MQZipRawEntry rawFileData(const QString &fileName) const;
+    static QByteArray uncompress(const MQZipRawEntry &entry);
     bool extractAll(const QString &destinationDir) const;
 
     enum Status {
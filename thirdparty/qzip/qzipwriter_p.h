@@ -56,6 +56,7 @@
 
 #include <QtCore/qstring.h>
 #include <QtCore/qfile.h>
+#include "qzipreader_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -94,12 +95,19 @@ public:
     void setCompressionPolicy(CompressionPolicy policy);
     CompressionPolicy compressionPolicy() const;
 
+    void setCompressionLevel(int level);
+    int compressionLevel() const;
+
+    static MQZipRawEntry compress(const QByteArray &data, int level = -1, CompressionPolicy policy = AutoCompress);
+
     void setCreationPermissions(QFile::Permissions permissions);
     QFile::Permissions creationPermissions() const;
 
     void addFile(const QString &fileName, const QByteArray &data);
 
     void addFile(const QString &fileName, QIODevice *device);
+    void addRawFile(const QString &fileName, const MQZipRawEntry &entry);
+    QIODevice *openFile(const QString &fileName);
 
     void addDirectory(const QString &dirName);
 
@@ -495,7 +495,11 @@ void XmlStreamReader::addData(const QByteArray &data)
         qWarning("XmlStreamReader: addData() with device()");
         return;
     }
-    d->dataBuffer += data;
+    // rawReadBuffer may refer to dataBuffer, which is about to be
+    // reallocated
+    d->rawReadBuffer.detach();
+    d->dataBuffer = d->dataBuffer.mid(d->dataBufferPos) + data;
+    d->dataBufferPos = 0;
 }
 
 /*!
@@ -567,7 +571,7 @@ bool XmlStreamReader::atEnd() const
         if (d->device)
             return d->device->atEnd();
         else
-            return !d->dataBuffer.size();
+            return d->dataBufferPos >= d->dataBuffer.size();
     }
     return (d->atEnd || d->type == XmlStreamReader::Invalid);
 }
@@ -825,6 +829,7 @@ void XmlStreamReaderPrivate::init()
     lineNumber = lastLineStart = characterOffset = 0;
     readBufferPos = 0;
     nbytesread = 0;
+    dataBufferPos = 0;
 #ifndef QT_NO_TEXTCODEC
     codec = QTextCodec::codecForMib(106); // utf8
     delete decoder;
@@ -1473,12 +1478,18 @@ ushort XmlStreamReaderPrivate::getChar_helper()
         int nbytesreadOrMinus1 = device->read(rawReadBuffer.data() + nbytesread, BUFFER_SIZE - nbytesread);
         nbytesread += qMax(nbytesreadOrMinus1, 0);
     } else {
+        // decode in-memory data in chunks too, so a large (or
+        // memory mapped) document is never held as a complete
+        // QString; the chunk refers to dataBuffer without a copy
+        const int DATA_CHUNK_SIZE = 65536;
+        int n = qMin(dataBuffer.size() - dataBufferPos, DATA_CHUNK_SIZE);
+        QByteArray chunk = QByteArray::fromRawData(dataBuffer.constData() + dataBufferPos, n);
+        dataBufferPos += n;
         if (nbytesread)
-            rawReadBuffer += dataBuffer;
+            rawReadBuffer += chunk;
         else
-            rawReadBuffer = dataBuffer;
+            rawReadBuffer = chunk;
         nbytesread = rawReadBuffer.size();
-        dataBuffer.clear();
     }
     if (!nbytesread) {
         atEnd = true;